@@ -24,7 +24,10 @@
 // include Ignition Transport
 #include <ignition/transport/Node.hh>
 
+#include "ros1_ign_bridge/bridge_config.hpp"
+#include "ros1_ign_bridge/bridge_state.hpp"
 #include "ros1_ign_bridge/builtin_interfaces_factories.hpp"
+#include "ros1_ign_bridge/ign_dispatcher.hpp"
 
 namespace ros1_ign_bridge
 {
@@ -33,12 +36,16 @@ struct Bridge1toIgnHandles
 {
   ros::Subscriber ros1_subscriber;
   ignition::transport::Node::Publisher ign_publisher;
+  std::shared_ptr<BridgeState> state;
 };
 
 struct BridgeIgnto1Handles
 {
   std::shared_ptr<ignition::transport::Node> ign_subscriber;
+  std::shared_ptr<IgnDispatcher> ign_dispatcher;
+  std::string ign_topic_name;
   ros::Publisher ros1_publisher;
+  std::shared_ptr<BridgeState> state;
 };
 
 struct BridgeHandles
@@ -47,6 +54,13 @@ struct BridgeHandles
   BridgeIgnto1Handles bridgeIgnto1;
 };
 
+struct ServiceBridgeHandles
+{
+  ros::ServiceServer ros1_server;
+  std::shared_ptr<ignition::transport::Node> ign_server;
+  std::string ign_service_name;
+};
+
 Bridge1toIgnHandles
 create_bridge_from_ros_to_ign(
   ros::NodeHandle ros1_node,
@@ -56,20 +70,10 @@ create_bridge_from_ros_to_ign(
   size_t subscriber_queue_size,
   const std::string & ign_type_name,
   const std::string & ign_topic_name,
-  size_t publisher_queue_size)
-{
-  auto factory = get_factory(ros1_type_name, ign_type_name);
-  auto ign_pub = factory->create_ign_publisher(
-    ign_node, ign_topic_name, publisher_queue_size);
-
-  auto ros1_sub = factory->create_ros1_subscriber(
-    ros1_node, ros1_topic_name, subscriber_queue_size, ign_pub);
-
-  Bridge1toIgnHandles handles;
-  handles.ros1_subscriber = ros1_sub;
-  handles.ign_publisher = ign_pub;
-  return handles;
-}
+  size_t publisher_queue_size,
+  double max_rate = 0.0,
+  bool lazy = false,
+  QueuePolicy queue_policy = QueuePolicy::SYNCHRONOUS);
 
 BridgeIgnto1Handles
 create_bridge_from_ign_to_ros(
@@ -80,20 +84,20 @@ create_bridge_from_ign_to_ros(
   size_t subscriber_queue_size,
   const std::string & ros1_type_name,
   const std::string & ros1_topic_name,
-  size_t publisher_queue_size)
-{
-  auto factory = get_factory(ros1_type_name, ign_type_name);
-  auto ros1_pub = factory->create_ros1_publisher(
-    ros1_node, ros1_topic_name, publisher_queue_size);
-
-  factory->create_ign_subscriber(
-    ign_node, ign_topic_name, subscriber_queue_size, ros1_pub);
-
-  BridgeIgnto1Handles handles;
-  handles.ign_subscriber = ign_node;
-  handles.ros1_publisher = ros1_pub;
-  return handles;
-}
+  size_t publisher_queue_size,
+  double max_rate = 0.0,
+  bool lazy = false);
+
+/// \brief Create the directions of a bridge given by config.direction.
+/// \param[in] ign_dispatcher If set, the bridge uses the Ignition node it
+/// assigns to the topic instead of ign_node, and its messages towards ROS 1
+/// are converted by the threads of the dispatcher.
+BridgeHandles
+create_bridge(
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const BridgeConfig & config,
+  std::shared_ptr<IgnDispatcher> ign_dispatcher = nullptr);
 
 BridgeHandles
 create_bidirectional_bridge(
@@ -102,17 +106,29 @@ create_bidirectional_bridge(
   const std::string & ros1_type_name,
   const std::string & ign_type_name,
   const std::string & topic_name,
-  size_t queue_size = 10)
-{
-  BridgeHandles handles;
-  handles.bridge1toIgn = create_bridge_from_ros_to_ign(
-   ros1_node, ign_node,
-   ros1_type_name, topic_name, queue_size, ign_type_name, topic_name, queue_size);
-  handles.bridgeIgnto1 = create_bridge_from_ign_to_ros(
-    ign_node, ros1_node,
-    ign_type_name, topic_name, queue_size, ros1_type_name, topic_name, queue_size);
-  return handles;
-}
+  size_t queue_size = 10);
+
+/// \brief Offer a service on the side given by config.direction and forward
+/// its calls to the other side.
+/// \param[in] ros1_node Its callback queue runs the ROS 1 side of the calls
+/// and should be serviced by enough threads for the expected concurrency.
+ServiceBridgeHandles
+create_service_bridge(
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const ServiceBridgeConfig & config);
+
+void
+shutdown_bridge(Bridge1toIgnHandles & handles);
+
+void
+shutdown_bridge(BridgeIgnto1Handles & handles);
+
+void
+shutdown_bridge(BridgeHandles & handles);
+
+void
+shutdown_bridge(ServiceBridgeHandles & handles);
 
 }  // namespace ros1_ign_bridge
 
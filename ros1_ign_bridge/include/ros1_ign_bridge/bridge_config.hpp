@@ -0,0 +1,300 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__BRIDGE_CONFIG_HPP_
+#define ROS1_IGN_BRIDGE__BRIDGE_CONFIG_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+
+// include ROS 1
+#include <XmlRpcValue.h>
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Direction in which messages flow through a bridge.
+enum class BridgeDirection
+{
+  BIDIRECTIONAL,
+  ROS_TO_IGN,
+  IGN_TO_ROS
+};
+
+/// \brief How converted messages reach the Ignition publisher.
+enum class QueuePolicy
+{
+  /// \brief Published from the ROS 1 callback, publisher_queue_size is not
+  /// used.
+  SYNCHRONOUS,
+
+  /// \brief Queued for a sender thread; the oldest queued message is dropped
+  /// when publisher_queue_size messages are waiting.
+  DROP_OLDEST,
+
+  /// \brief Queued for a sender thread; new messages are dropped when
+  /// publisher_queue_size messages are waiting.
+  DROP_NEWEST
+};
+
+/// \brief Configuration of a single bridged topic.
+struct BridgeConfig
+{
+  /// \brief Topic name on the ROS 1 side. A TopicPattern, the same on both
+  /// sides, stands for all the matching topics, see BridgeDiscovery.
+  std::string ros1_topic_name;
+
+  /// \brief Topic name on the Ignition Transport side.
+  std::string ign_topic_name;
+
+  /// \brief ROS 1 message type, e.g. "std_msgs/String".
+  std::string ros1_type_name;
+
+  /// \brief Ignition message type, e.g. "ignition.msgs.StringMsg".
+  std::string ign_type_name;
+
+  /// \brief Which way messages are forwarded.
+  BridgeDirection direction = BridgeDirection::BIDIRECTIONAL;
+
+  /// \brief Queue size of the subscriber on the source side.
+  size_t subscriber_queue_size = 10;
+
+  /// \brief Queue size of the publisher on the destination side.
+  size_t publisher_queue_size = 10;
+
+  /// \brief Queueing towards Ignition in the ROS 1 to Ignition direction.
+  QueuePolicy queue_policy = QueuePolicy::SYNCHRONOUS;
+
+  /// \brief Maximum forwarding rate in Hz, 0 for no limit.
+  double max_rate = 0.0;
+
+  /// \brief Messages per second let through by Ignition Transport on the
+  /// Ignition subscriber, 0 for no limit. Unlike max_rate, the excess is
+  /// discarded before it reaches the bridge callbacks. Towards Ignition, it
+  /// caps the rate like max_rate does.
+  size_t ign_msgs_per_sec = 0;
+
+  /// \brief Only forward while the destination side has subscribers.
+  bool lazy = false;
+
+  /// \brief Executor whose threads run the ROS 1 callbacks. An empty name
+  /// selects the default executor.
+  std::string executor;
+
+  /// \brief Worker process of the bridge in supervisor mode, see
+  /// process_class(). Empty to choose it from the type and direction.
+  std::string process;
+
+  /// \brief Rate in Hz at which messages should be forwarded, checked by the
+  /// diagnostics. 0 disables the check.
+  double expected_rate = 0.0;
+
+  /// \brief Accepted relative deviation from expected_rate.
+  double rate_tolerance = 0.1;
+
+  /// \brief Longest acceptable time in seconds between receiving a message
+  /// and publishing its conversion, checked by the diagnostics. 0 disables
+  /// the check.
+  double max_age = 0.0;
+
+  /// \brief Convert through a GenericFactory built from the message
+  /// definitions instead of the compiled in conversion functions.
+  bool generic = false;
+
+  /// \brief Dotted ROS 1 field path to dotted Ignition field path, for
+  /// generic bridges whose field names differ.
+  std::map<std::string, std::string> field_mappings;
+};
+
+/// \brief Configuration of a group of threads servicing ROS 1 callbacks.
+struct ExecutorConfig
+{
+  /// \brief Name referenced by BridgeConfig::executor.
+  std::string name;
+
+  /// \brief Number of spinner threads.
+  unsigned int threads = 1;
+
+  /// \brief SCHED_FIFO priority of the threads, 0 to keep the default
+  /// scheduling.
+  int priority = 0;
+
+  /// \brief CPUs the threads may run on, empty for any.
+  std::vector<int> cpus;
+};
+
+/// \brief Configuration of a single bridged service.
+struct ServiceBridgeConfig
+{
+  /// \brief Service name on the ROS 1 side.
+  std::string ros1_service_name;
+
+  /// \brief Service name on the Ignition Transport side.
+  std::string ign_service_name;
+
+  /// \brief ROS 1 service type, e.g. "std_srvs/SetBool".
+  std::string ros1_type_name;
+
+  /// \brief Ignition request type, e.g. "ignition.msgs.Boolean".
+  std::string ign_request_type_name;
+
+  /// \brief Ignition reply type, e.g. "ignition.msgs.Boolean".
+  std::string ign_reply_type_name;
+
+  /// \brief ROS_TO_IGN lets ROS 1 clients call an Ignition service and
+  /// IGN_TO_ROS lets Ignition clients call a ROS 1 service.
+  BridgeDirection direction = BridgeDirection::ROS_TO_IGN;
+
+  /// \brief Maximum time to wait for the other side to reply, in seconds.
+  double timeout = 1.0;
+
+  /// \brief IGN_TO_ROS only: maximum time in seconds the Ignition reception
+  /// thread waits for the ROS 1 reply, if shorter than timeout, 0 to wait up
+  /// to timeout. Ignition Transport answers requests synchronously on the
+  /// thread that also delivers every subscription of the process, which all
+  /// stall meanwhile.
+  double ign_reply_timeout = 0.0;
+};
+
+/// \brief Configuration of the dedicated simulation clock bridge, see
+/// ClockBridge.
+struct ClockBridgeConfig
+{
+  bool enabled = false;
+
+  /// \brief Ignition topic carrying ignition.msgs.Clock.
+  std::string ign_topic_name = "/clock";
+
+  /// \brief ROS 1 topic for rosgraph_msgs/Clock.
+  std::string ros1_topic_name = "/clock";
+
+  /// \brief Maximum publishing rate in Hz, 0 to publish every new time.
+  double max_rate = 0.0;
+
+  /// \brief SCHED_FIFO priority of the publishing thread, 0 to keep the
+  /// default scheduling.
+  int priority = 0;
+
+  /// \brief CPUs the publishing thread may run on, empty for any.
+  std::vector<int> cpus;
+};
+
+/// \brief Complete configuration of a bridge process.
+struct BridgeSetConfig
+{
+  std::vector<ExecutorConfig> executors;
+  std::vector<BridgeConfig> bridges;
+  std::vector<ServiceBridgeConfig> services;
+  ClockBridgeConfig clock;
+
+  /// \brief Number of worker threads running the service calls.
+  unsigned int service_threads = 4;
+
+  /// \brief Number of bridges created at the same time by
+  /// BridgeManager::configure().
+  unsigned int startup_threads = 8;
+
+  /// \brief Ignition nodes the topics are spread over, see IgnDispatcher.
+  unsigned int ign_nodes = 1;
+
+  /// \brief Threads converting the messages from Ignition, 0 to convert
+  /// them on the thread of Ignition Transport without an IgnDispatcher.
+  unsigned int ign_threads = 0;
+
+  /// \brief Seconds between two looks for new topics matching the patterns,
+  /// see BridgeDiscovery.
+  double discovery_period = 1.0;
+};
+
+/// \brief Parse a "topic@ROS1_type@Ign_type" specification. Replacing the
+/// second "@" by "[" or "]" makes the bridge go only from Ignition to ROS 1 or
+/// only from ROS 1 to Ignition respectively.
+/// \param[in] spec The specification string.
+/// \param[out] config Bridge using the default settings.
+/// \return True if the specification is well formed.
+bool
+parse_bridge_spec(const std::string & spec, BridgeConfig & config);
+
+/// \brief Short description of a bridge in the same form as its
+/// specification, with the Ignition topic in parentheses when it differs.
+std::string
+to_bridge_spec(const BridgeConfig & config);
+
+/// \brief Parse a bridge configuration stored in the parameter server.
+///
+/// The value is expected to be a struct with optional "executors", "bridges"
+/// and "services" lists and "clock" struct, e.g. loaded with <rosparam> from a
+/// YAML file:
+///
+///   executors:
+///     - {name: control, threads: 1, priority: 80, cpus: [3]}
+///   bridges:
+///     - topic: /cmd_vel
+///       ros_type: geometry_msgs/Twist
+///       ign_type: ignition.msgs.Twist
+///       direction: ros_to_ign
+///       queue_size: 1
+///       executor: control
+///     - topic: /status
+///       ros_type: my_msgs/Status
+///       ign_type: ignition.msgs.Boolean
+///       generic: true
+///       fields: {ok: data}
+///   service_threads: 4
+///   startup_threads: 8
+///   ign_nodes: 4
+///   ign_threads: 4
+///   discovery_period: 1.0
+///   services:
+///     - service: /world/default/control
+///       ros_type: ros1_ign_bridge/ControlWorld
+///       ign_request_type: ignition.msgs.WorldControl
+///       ign_reply_type: ignition.msgs.Boolean
+///   clock: {ign_topic: /world/default/clock, max_rate: 100, priority: 50}
+///
+/// Every entry is parsed even after a failure so that all the problems are
+/// reported at once.
+/// \param[in] value Parameter server value.
+/// \param[out] config Parsed entries are appended here.
+/// \param[out] errors One message per invalid entry.
+/// \return True if no errors were found.
+bool
+parse_bridge_config(
+  XmlRpc::XmlRpcValue & value,
+  BridgeSetConfig & config,
+  std::vector<std::string> & errors);
+
+/// \brief Check a configuration before anything is created: type pairs must
+/// have a factory, executors must exist, topic patterns must be valid and
+/// topics and services must not be bridged twice in the same direction.
+/// \param[in] config Configuration to validate.
+/// \param[out] errors One message per problem found.
+/// \return True if the configuration can be used as is.
+bool
+validate_bridge_config(
+  const BridgeSetConfig & config,
+  std::vector<std::string> & errors);
+
+/// \brief Human readable name of a direction, as used in the configuration.
+std::string
+to_string(BridgeDirection direction);
+
+/// \brief Name of a queue policy, as used in the configuration.
+std::string
+to_string(QueuePolicy policy);
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__BRIDGE_CONFIG_HPP_
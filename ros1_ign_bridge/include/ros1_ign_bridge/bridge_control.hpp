@@ -0,0 +1,87 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__BRIDGE_CONTROL_HPP_
+#define ROS1_IGN_BRIDGE__BRIDGE_CONTROL_HPP_
+
+#include <memory>
+#include <string>
+
+// include ROS 1
+#include <ros/node_handle.h>
+#include <ros/service_server.h>
+
+// include Ignition Transport
+#include <ignition/msgs.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/AddBridge.h"
+#include "ros1_ign_bridge/ListBridges.h"
+#include "ros1_ign_bridge/RemoveBridge.h"
+#include "ros1_ign_bridge/bridge_registry.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Services to add, remove and list the bridges of a registry at
+/// runtime, offered on both transports.
+///
+/// ROS 1 services, in the namespace of the given node handle:
+///   add_bridge (ros1_ign_bridge/AddBridge)
+///   remove_bridge (ros1_ign_bridge/RemoveBridge)
+///   list_bridges (ros1_ign_bridge/ListBridges)
+///
+/// Ignition services, under the given prefix:
+///   <prefix>/add_bridge (ignition.msgs.StringMsg -> ignition.msgs.Boolean)
+///   <prefix>/remove_bridge (ignition.msgs.StringMsg -> ignition.msgs.Boolean)
+///   <prefix>/list_bridges (ignition.msgs.Empty -> ignition.msgs.StringMsg_V)
+class BridgeControl
+{
+public:
+  /// \param[in] registry Bridges to control. It must outlive this object.
+  /// \param[in] ros1_node Namespace of the ROS 1 services.
+  /// \param[in] ign_node Node advertising the Ignition services.
+  /// \param[in] ign_prefix Prefix of the Ignition service names.
+  BridgeControl(
+    BridgeRegistry & registry,
+    ros::NodeHandle ros1_node,
+    std::shared_ptr<ignition::transport::Node> ign_node,
+    const std::string & ign_prefix);
+
+private:
+  bool
+  add(const std::string & spec, size_t queue_size, double max_rate,
+      bool lazy, std::string & message);
+
+  bool
+  remove(const std::string & topic_name, std::string & message);
+
+  bool
+  on_ros1_add(AddBridge::Request & req, AddBridge::Response & res);
+
+  bool
+  on_ros1_remove(RemoveBridge::Request & req, RemoveBridge::Response & res);
+
+  bool
+  on_ros1_list(ListBridges::Request & req, ListBridges::Response & res);
+
+  BridgeRegistry & registry_;
+  ros::ServiceServer add_server_;
+  ros::ServiceServer remove_server_;
+  ros::ServiceServer list_server_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__BRIDGE_CONTROL_HPP_
@@ -0,0 +1,54 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__BRIDGE_DIAGNOSTICS_HPP_
+#define ROS1_IGN_BRIDGE__BRIDGE_DIAGNOSTICS_HPP_
+
+// include ROS 1
+#include <diagnostic_updater/DiagnosticStatusWrapper.h>
+
+#include "ros1_ign_bridge/TopicStatistics.h"
+#include "ros1_ign_bridge/bridge_config.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Health of one bridge direction over the last reporting period,
+/// in the spirit of diagnostic_updater's frequency and timestamp checks.
+///
+/// - The forwarding rate must stay within BridgeConfig::rate_tolerance of
+///   BridgeConfig::expected_rate: WARN outside of it, ERROR when nothing was
+///   forwarded at all. Idle lazy bridges are OK. A bidirectional bridge
+///   usually carries traffic one way, so its rate is the sum of both
+///   directions rather than the rate of the direction reported.
+/// - The receive to publish latency must stay under BridgeConfig::max_age:
+///   WARN when the slowest message exceeds it, ERROR when the 99th
+///   percentile does.
+///
+/// \param[in] config Thresholds of the bridge.
+/// \param[in] stats Statistics of the bridge direction over the last
+/// period.
+/// \param[in] rate Forwarding rate checked against expected_rate:
+/// stats.rate_out, or the sum over both directions of a bidirectional bridge.
+/// \param[out] status Summary and values of the checks.
+void
+check_bridge_health(
+  const BridgeConfig & config,
+  const TopicStatistics & stats,
+  double rate,
+  diagnostic_updater::DiagnosticStatusWrapper & status);
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__BRIDGE_DIAGNOSTICS_HPP_
@@ -0,0 +1,129 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__BRIDGE_DISCOVERY_HPP_
+#define ROS1_IGN_BRIDGE__BRIDGE_DISCOVERY_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// include Ignition Transport
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge_config.hpp"
+#include "ros1_ign_bridge/bridge_registry.hpp"
+#include "ros1_ign_bridge/topic_pattern.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Turns the bridges whose topic is a TopicPattern into bridges of
+/// the matching topics, as they show up on ROS 1 and on Ignition.
+///
+/// A thread lists the topics of both sides periodically and only matches
+/// the names that appeared since the previous look, so that a large, stable
+/// graph costs two list requests per period. A topic is bridged by the first
+/// pattern it matches on a side the pattern reads from, provided its type
+/// there is the one of the pattern. The bridges stay when the topic goes
+/// away, like the ones configured explicitly. A topic is only tried once
+/// while it is listed: one whose bridge was removed, or failed, is bridged
+/// again when it comes back after disappearing from both sides.
+class BridgeDiscovery
+{
+public:
+  /// \param[in] registry Receives the bridges of the matching topics. It must
+  /// outlive the discovery.
+  /// \param[in] ign_node Node used to list the Ignition topics.
+  /// \param[in] period Seconds between two looks for new topics.
+  BridgeDiscovery(
+    BridgeRegistry & registry,
+    std::shared_ptr<ignition::transport::Node> ign_node,
+    double period);
+
+  /// \brief Stops the thread. The bridges created stay in the registry.
+  ~BridgeDiscovery();
+
+  BridgeDiscovery(const BridgeDiscovery &) = delete;
+  BridgeDiscovery & operator=(const BridgeDiscovery &) = delete;
+
+  /// \brief Bridge the topics matching a pattern, the ones already known
+  /// included, from now on.
+  /// \param[in] config Bridge whose topic, the same on both sides, is a
+  /// pattern. The other settings apply to every matching topic.
+  /// \param[out] error Reason of the failure, if any.
+  /// \return False if the topic is not a valid pattern.
+  bool
+  add_pattern(const BridgeConfig & config, std::string & error);
+
+private:
+  struct Pattern
+  {
+    BridgeConfig config;
+    TopicPattern matcher;
+  };
+
+  void
+  run();
+
+  /// \brief Bridge the topics that appeared since the previous scan.
+  void
+  scan(const std::vector<std::shared_ptr<const Pattern>> & patterns);
+
+  /// \brief Forget the handled topics that no side lists anymore and no
+  /// bridge uses, so that they are bridged again when they come back.
+  void
+  forget_gone_topics();
+
+  /// \brief Bridge a new topic with the first pattern of its side matching
+  /// its name and type.
+  /// \param[in] ros1_side Whether the topic was found on ROS 1 or Ignition.
+  void
+  bridge_topic(
+    const std::vector<std::shared_ptr<const Pattern>> & patterns,
+    const std::string & topic_name,
+    const std::string & type_name,
+    bool ros1_side);
+
+  BridgeRegistry & registry_;
+  std::shared_ptr<ignition::transport::Node> ign_node_;
+  std::chrono::duration<double> period_;
+
+  /// \brief Protects the members below.
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stop_ = false;
+  /// \brief Set when a pattern is added, to match it against all the topics.
+  bool rescan_ = false;
+  std::vector<std::shared_ptr<const Pattern>> patterns_;
+
+  /// \brief Only used by the thread: the sorted topic names of each side at
+  /// the last scan, the Ignition topics whose type is not known yet and the
+  /// topics already handled.
+  std::vector<std::string> ros1_topics_;
+  std::vector<std::string> ign_topics_;
+  std::vector<std::string> ign_pending_;
+  std::unordered_set<std::string> bridged_;
+
+  std::thread thread_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__BRIDGE_DISCOVERY_HPP_
@@ -0,0 +1,187 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__BRIDGE_MANAGER_HPP_
+#define ROS1_IGN_BRIDGE__BRIDGE_MANAGER_HPP_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// include ROS 1
+#include <ros/node_handle.h>
+
+// include Ignition Transport
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge.hpp"
+#include "ros1_ign_bridge/bridge_config.hpp"
+#include "ros1_ign_bridge/bridge_control.hpp"
+#include "ros1_ign_bridge/bridge_discovery.hpp"
+#include "ros1_ign_bridge/bridge_registry.hpp"
+#include "ros1_ign_bridge/bridge_stats_publisher.hpp"
+#include "ros1_ign_bridge/clock_bridge.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Hosts a set of bridges inside any ROS 1 node, together with the
+/// executors running their callbacks, the service bridges and, optionally,
+/// the runtime control services and the statistics.
+///
+/// Typical use from a node that consumes the bridged topics in-process:
+///
+///   ros1_ign_bridge::BridgeManager manager(nh);
+///   std::vector<std::string> errors;
+///   if (!manager.configure(config, errors)) ...
+///   manager.start();
+///   ros::spin();
+class BridgeManager
+{
+public:
+  /// \param[in] ros1_node Bridges without an executor run their ROS 1
+  /// callbacks on the callback queue of this handle, which the caller spins.
+  /// \param[in] ign_node Ignition node shared by the bridges. A new one is
+  /// created if null.
+  explicit BridgeManager(
+    ros::NodeHandle ros1_node,
+    std::shared_ptr<ignition::transport::Node> ign_node = nullptr);
+
+  /// \brief Calls stop().
+  ~BridgeManager();
+
+  BridgeManager(const BridgeManager &) = delete;
+  BridgeManager & operator=(const BridgeManager &) = delete;
+
+  /// \brief Validate a whole configuration and create its executors,
+  /// bridges and service bridges. Nothing is created if it is invalid.
+  ///
+  /// Up to BridgeSetConfig::startup_threads bridges are created at the same
+  /// time. Each one forwards as soon as it is created if the manager was
+  /// started before.
+  /// \param[in] config The configuration. Its bridges may also use the
+  /// executors added before.
+  /// \param[out] errors Validation errors, or bridges that failed to start.
+  /// \return False if the configuration is invalid or a bridge failed to
+  /// start.
+  bool
+  configure(const BridgeSetConfig & config, std::vector<std::string> & errors);
+
+  /// \brief Add a group of threads that bridges can be assigned to. Its
+  /// threads start with start(), or right away if already started, and
+  /// report the scheduling they actually got on standard output.
+  /// \return False if an executor with the same name exists.
+  bool
+  add_executor(const ExecutorConfig & config);
+
+  /// \brief Create a bridge, see BridgeRegistry::add(). If its topic is a
+  /// TopicPattern, bridge the matching topics as they are discovered
+  /// instead, see BridgeDiscovery.
+  bool
+  add_bridge(const BridgeConfig & config, std::string & error);
+
+  /// \brief Remove the bridges of a topic, see BridgeRegistry::remove().
+  size_t
+  remove_bridge(const std::string & topic_name);
+
+  /// \brief Configuration of the bridges currently running.
+  std::vector<BridgeConfig>
+  list_bridges() const;
+
+  /// \brief Create a service bridge. Its calls run on a dedicated pool of
+  /// set_service_threads() threads.
+  bool
+  add_service_bridge(const ServiceBridgeConfig & config, std::string & error);
+
+  /// \brief Size of the service pool. Only effective before the first
+  /// service bridge is added.
+  void
+  set_service_threads(unsigned int threads);
+
+  /// \brief Seconds between two looks for topics matching the patterns.
+  /// Only effective before the first pattern is added.
+  void
+  set_discovery_period(double period);
+
+  /// \brief Spread the Ignition topics of the bridges added afterwards over
+  /// several nodes and convert their messages on a pool of threads, see
+  /// IgnDispatcher. Only effective once.
+  /// \param[in] nodes Number of Ignition nodes.
+  /// \param[in] threads Number of converting threads.
+  void
+  set_ign_dispatch(unsigned int nodes, unsigned int threads);
+
+  /// \brief Forward the simulation clock on a dedicated thread, see
+  /// ClockBridge. Replaces the clock bridge created before, if any.
+  bool
+  set_clock_bridge(const ClockBridgeConfig & config, std::string & error);
+
+  /// \brief Offer the services to add, remove and list bridges, see
+  /// BridgeControl.
+  void
+  enable_control(ros::NodeHandle node, const std::string & ign_prefix);
+
+  /// \brief Publish statistics, and optionally diagnostics, periodically,
+  /// see BridgeStatsPublisher.
+  void
+  enable_statistics(
+    ros::NodeHandle node,
+    const std::string & ign_topic,
+    double period,
+    bool diagnostics);
+
+  /// \brief Start the threads of the executors and of the service pool.
+  void
+  start();
+
+  /// \brief Stop all threads and shut down all bridges. The manager can't be
+  /// used afterwards.
+  void
+  stop();
+
+  /// \brief Ignition node shared by the bridges.
+  std::shared_ptr<ignition::transport::Node>
+  ign_node() const;
+
+private:
+  class Executor;
+
+  ros::NodeHandle ros1_node_;
+  std::shared_ptr<ignition::transport::Node> ign_node_;
+
+  /// \brief Protects the members below, except the registry, which has its
+  /// own lock.
+  mutable std::mutex mutex_;
+  bool started_ = false;
+  bool stopped_ = false;
+  std::map<std::string, std::unique_ptr<Executor>> executors_;
+  unsigned int service_threads_ = 4;
+  std::unique_ptr<Executor> service_executor_;
+  ros::NodeHandle service_node_;
+  std::vector<ServiceBridgeHandles> service_bridges_;
+  std::unique_ptr<ClockBridge> clock_bridge_;
+  std::shared_ptr<IgnDispatcher> ign_dispatcher_;
+  double discovery_period_ = 1.0;
+
+  std::unique_ptr<BridgeRegistry> registry_;
+  std::unique_ptr<BridgeDiscovery> discovery_;
+  std::unique_ptr<BridgeControl> control_;
+  std::unique_ptr<BridgeStatsPublisher> stats_publisher_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__BRIDGE_MANAGER_HPP_
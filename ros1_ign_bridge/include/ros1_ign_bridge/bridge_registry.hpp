@@ -0,0 +1,167 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__BRIDGE_REGISTRY_HPP_
+#define ROS1_IGN_BRIDGE__BRIDGE_REGISTRY_HPP_
+
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// include ROS 1
+#include <ros/callback_queue_interface.h>
+#include <ros/node_handle.h>
+
+// include Ignition Transport
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge.hpp"
+#include "ros1_ign_bridge/bridge_config.hpp"
+#include "ros1_ign_bridge/bridge_stats.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Statistics of one direction of a registered bridge.
+struct BridgeDirectionStats
+{
+  BridgeConfig config;
+
+  /// \brief ROS_TO_IGN or IGN_TO_ROS.
+  BridgeDirection direction;
+
+  BridgeStatsSnapshot stats;
+};
+
+/// \brief Thread safe collection of bridges that can be added and removed
+/// while the bridge is running.
+class BridgeRegistry
+{
+public:
+  BridgeRegistry(
+    ros::NodeHandle ros1_node,
+    std::shared_ptr<ignition::transport::Node> ign_node);
+
+  /// \brief Shuts down all the bridges.
+  ~BridgeRegistry();
+
+  /// \brief Make an executor available to the bridges added afterwards.
+  /// \param[in] name Name referenced by BridgeConfig::executor.
+  /// \param[in] queue Callback queue serviced by the executor. It must
+  /// outlive the registry.
+  void
+  add_executor(const std::string & name, ros::CallbackQueueInterface * queue);
+
+  /// \brief Receive the Ignition topics of the bridges added afterwards
+  /// through a dispatcher, see create_bridge().
+  void
+  set_ign_dispatcher(std::shared_ptr<IgnDispatcher> dispatcher);
+
+  /// \brief Validate a bridge against the existing ones and create it. The
+  /// types are checked before taking the lock, since a generic conversion
+  /// reads message definitions, and the topics are looked up in indexes, so
+  /// adding n bridges takes O(n log n).
+  /// \param[in] config The bridge to create.
+  /// \param[out] error Reason of the failure, if any.
+  /// \return True if the bridge was created.
+  bool
+  add(const BridgeConfig & config, std::string & error);
+
+  /// \brief Shut down the bridges using a topic on either side.
+  /// \param[in] topic_name ROS 1 or Ignition topic name.
+  /// \return Number of bridges removed.
+  size_t
+  remove(const std::string & topic_name);
+
+  /// \brief Shut down all the bridges, once the ones being added are
+  /// created, and refuse new ones. The executor queues may be destroyed
+  /// afterwards.
+  void
+  clear();
+
+  /// \brief Configuration of the bridges currently running.
+  std::vector<BridgeConfig>
+  list() const;
+
+  /// \brief Whether a bridge, running or being created, uses a topic on
+  /// either side.
+  /// \param[in] topic_name ROS 1 or Ignition topic name.
+  bool
+  contains(const std::string & topic_name) const;
+
+  /// \brief Snapshot the statistics of every bridge direction. This resets
+  /// their latency histograms, so there should be a single caller.
+  std::vector<BridgeDirectionStats>
+  collect_stats();
+
+private:
+  struct Entry
+  {
+    BridgeConfig config;
+    BridgeHandles handles;
+    bool ready = false;
+  };
+
+  using Entries = std::list<Entry>;
+
+  /// \brief Bridge owning one side of each topic.
+  using TopicIndex = std::map<std::string, Entries::iterator>;
+
+  /// \brief Check that no bridge publishes into the same topic on either
+  /// side or subscribes to the same Ignition topic. Called with the lock.
+  bool
+  check_topics(const BridgeConfig & config, std::string & error) const;
+
+  /// \brief Add an entry to the topic indexes. Called with the lock.
+  void
+  index(Entries::iterator entry);
+
+  /// \brief Remove an entry from the topic indexes. Called with the lock.
+  void
+  unindex(const Entry & entry);
+
+  ros::NodeHandle ros1_node_;
+  std::shared_ptr<ignition::transport::Node> ign_node_;
+
+  /// \brief Protects the members below. It is never held while calling into
+  /// the transports, whose own callbacks may end up calling the registry.
+  mutable std::mutex mutex_;
+  std::map<std::string, ros::CallbackQueueInterface *> executors_;
+  std::shared_ptr<IgnDispatcher> ign_dispatcher_;
+  Entries entries_;
+
+  /// \brief Bridges publishing into a ROS 1 topic.
+  TopicIndex ros1_publishers_;
+
+  /// \brief Bridges publishing into an Ignition topic.
+  TopicIndex ign_publishers_;
+
+  /// \brief Bridges subscribing to an Ignition topic. Ignition
+  /// subscriptions are removed by topic from the shared node, so there may
+  /// only be one.
+  TopicIndex ign_subscribers_;
+
+  /// \brief Bridges being created without the lock, waited for by clear().
+  size_t pending_ = 0;
+  std::condition_variable pending_done_;
+  bool closed_ = false;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__BRIDGE_REGISTRY_HPP_
@@ -0,0 +1,97 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__BRIDGE_STATE_HPP_
+#define ROS1_IGN_BRIDGE__BRIDGE_STATE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "ros1_ign_bridge/bridge_stats.hpp"
+
+namespace ros1_ign_bridge
+{
+
+class IgnPublishQueue;
+
+/// \brief Lock-free limiter that lets at most one message per period through.
+class RateLimiter
+{
+public:
+  /// \param[in] max_rate Maximum rate in Hz. Zero or negative disables it.
+  explicit RateLimiter(double max_rate = 0.0)
+  : period_ns_(max_rate > 0.0 ? static_cast<int64_t>(1e9 / max_rate) : 0),
+    next_ns_(0)
+  {}
+
+  /// \brief Whether a message arriving now may be forwarded.
+  bool
+  allow()
+  {
+    if (period_ns_ == 0) {
+      return true;
+    }
+
+    const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t next = next_ns_.load(std::memory_order_relaxed);
+    if (now < next) {
+      return false;
+    }
+    return next_ns_.compare_exchange_strong(
+      next, now + period_ns_, std::memory_order_relaxed);
+  }
+
+private:
+  const int64_t period_ns_;
+  std::atomic<int64_t> next_ns_;
+};
+
+/// \brief Runtime state shared by the callbacks of one bridge direction.
+struct BridgeState
+{
+  explicit BridgeState(double max_rate = 0.0, bool lazy = false)
+  : rate_limiter(max_rate),
+    lazy(lazy)
+  {}
+
+  /// \brief Drops messages arriving faster than the configured rate.
+  RateLimiter rate_limiter;
+
+  /// \brief Only do work while the other side has subscribers.
+  const bool lazy;
+
+  /// \brief Protects the lazy subscription bookkeeping below.
+  std::mutex mutex;
+
+  /// \brief Subscribers to our ROS 1 publisher, excluding this node.
+  size_t num_remote_subscribers = 0;
+
+  /// \brief Traffic through this bridge direction.
+  BridgeStats stats;
+
+  /// \brief Name of the bridge in traces, see Tracer::intern().
+  uint32_t trace_label = 0;
+
+  /// \brief Sender of the ROS 1 to Ignition direction, null to publish from
+  /// the callbacks. Set before the subscriber is created and never replaced.
+  std::shared_ptr<IgnPublishQueue> publish_queue;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__BRIDGE_STATE_HPP_
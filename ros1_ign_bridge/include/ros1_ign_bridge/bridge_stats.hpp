@@ -0,0 +1,285 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__BRIDGE_STATS_HPP_
+#define ROS1_IGN_BRIDGE__BRIDGE_STATS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Current value of the monotonic clock used for latencies.
+inline int64_t
+steady_now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// \brief Lock-free log-linear histogram of latencies in nanoseconds.
+///
+/// Like an HDR histogram, every power of two is split in kSubBuckets linear
+/// buckets, so any value is known within 1 / kSubBuckets (12.5%) of its
+/// magnitude, from 1 ns to 2^kMaxBits ns (about 69 seconds), beyond which
+/// samples share the last bucket. The 1.1 KiB of buckets are only allocated
+/// by the first sample, so that the many bridges that never carry a message
+/// cost a pointer each.
+class LatencyHistogram
+{
+public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kMaxBits = 36;
+  static constexpr int kNumBuckets = (kMaxBits - kSubBucketBits + 1) *
+    kSubBuckets;
+
+  using Counts = std::array<uint32_t, kNumBuckets>;
+
+  LatencyHistogram() = default;
+
+  ~LatencyHistogram()
+  {
+    delete buckets_.load(std::memory_order_relaxed);
+  }
+
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram & operator=(const LatencyHistogram &) = delete;
+
+  /// \brief Add one sample. Safe to call from any number of threads.
+  void
+  record(int64_t value_ns)
+  {
+    const uint64_t value = value_ns > 0 ? static_cast<uint64_t>(value_ns) : 0;
+    buckets()[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = max_ns_.load(std::memory_order_relaxed);
+    while (value > max && !max_ns_.compare_exchange_weak(
+             max, value, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  /// \brief Move the samples recorded so far into counts and start over.
+  /// \param[out] counts Samples per bucket.
+  /// \return Largest sample, in nanoseconds.
+  uint64_t
+  take(Counts & counts)
+  {
+    Buckets * buckets = buckets_.load(std::memory_order_acquire);
+    if (buckets == nullptr)
+    {
+      counts.fill(0);
+      return 0;
+    }
+    for (int i = 0; i < kNumBuckets; ++i)
+      counts[i] = (*buckets)[i].exchange(0, std::memory_order_relaxed);
+    return max_ns_.exchange(0, std::memory_order_relaxed);
+  }
+
+  /// \brief Whether record() was ever called, i.e. the buckets are allocated.
+  bool
+  allocated() const
+  {
+    return buckets_.load(std::memory_order_relaxed) != nullptr;
+  }
+
+  /// \brief Smallest value that falls in a bucket.
+  static uint64_t
+  bucket_lower_bound(int index)
+  {
+    if (index < kSubBuckets)
+      return static_cast<uint64_t>(index);
+    const int shift = index / kSubBuckets - 1;
+    return static_cast<uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+  }
+
+  /// \brief Value below which a fraction of the samples fall.
+  /// \param[in] counts Samples per bucket, as returned by take().
+  /// \param[in] fraction Between 0 and 1, e.g. 0.99 for the 99th percentile.
+  /// \return Upper bound of the bucket holding the percentile, 0 if empty.
+  static uint64_t
+  percentile(const Counts & counts, double fraction)
+  {
+    uint64_t total = 0;
+    for (const auto count : counts)
+      total += count;
+    if (total == 0)
+      return 0;
+
+    const uint64_t rank = static_cast<uint64_t>(fraction * (total - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i)
+    {
+      seen += counts[i];
+      if (seen >= rank)
+      {
+        return i + 1 < kNumBuckets ?
+          bucket_lower_bound(i + 1) - 1 : bucket_lower_bound(i);
+      }
+    }
+    return bucket_lower_bound(kNumBuckets - 1);
+  }
+
+private:
+  using Buckets = std::array<std::atomic<uint32_t>, kNumBuckets>;
+
+  /// \brief The buckets, allocated by the first caller. Concurrent first
+  /// callers race with a compare-exchange and the losers free their copy.
+  Buckets &
+  buckets()
+  {
+    Buckets * buckets = buckets_.load(std::memory_order_acquire);
+    if (buckets != nullptr)
+      return *buckets;
+
+    Buckets * created = new Buckets();
+    for (auto & bucket : *created)
+      bucket.store(0, std::memory_order_relaxed);
+    if (buckets_.compare_exchange_strong(buckets, created,
+          std::memory_order_acq_rel, std::memory_order_acquire))
+    {
+      return *created;
+    }
+    delete created;
+    return *buckets;
+  }
+
+  static int
+  bucket_index(uint64_t value)
+  {
+    if (value < static_cast<uint64_t>(kSubBuckets))
+      return static_cast<int>(value);
+
+    const int msb = 63 - __builtin_clzll(value);
+    if (msb >= kMaxBits)
+      return kNumBuckets - 1;
+    const int shift = msb - kSubBucketBits;
+    return (shift + 1) * kSubBuckets +
+      static_cast<int>((value >> shift) & (kSubBuckets - 1));
+  }
+
+  std::atomic<Buckets *> buckets_{nullptr};
+  std::atomic<uint64_t> max_ns_{0};
+};
+
+/// \brief Point-in-time copy of the statistics of one bridge direction.
+struct BridgeStatsSnapshot
+{
+  uint64_t messages_in = 0;
+  uint64_t messages_out = 0;
+  uint64_t bytes_in = 0;
+  uint64_t bytes_out = 0;
+  uint64_t dropped = 0;
+  uint64_t queue_dropped = 0;
+  uint64_t echo_filtered = 0;
+
+  /// \brief Receive to publish latencies since the previous snapshot.
+  LatencyHistogram::Counts latency_counts;
+  uint64_t latency_max_ns = 0;
+};
+
+/// \brief Counters of one bridge direction, updated lock-free from the
+/// transport callbacks. Counters only grow; the latency histogram is reset by
+/// every snapshot so that it describes the last reporting period.
+struct BridgeStats
+{
+  /// \brief Messages received from the source side.
+  std::atomic<uint64_t> messages_in{0};
+
+  /// \brief Messages published on the destination side.
+  std::atomic<uint64_t> messages_out{0};
+
+  /// \brief Serialized size of the forwarded messages on the source side,
+  /// estimated from one message in kSizeSampleInterval, see sample_sizes().
+  /// Dropped messages are not measured to keep them cheap.
+  std::atomic<uint64_t> bytes_in{0};
+
+  /// \brief Serialized size of the forwarded messages on the destination
+  /// side, estimated like bytes_in.
+  std::atomic<uint64_t> bytes_out{0};
+
+  /// \brief Messages discarded by max_rate or ign_msgs_per_sec, and the
+  /// ones that could not be parsed or converted, e.g. of another type than
+  /// the bridge when the publisher advertises "*".
+  std::atomic<uint64_t> dropped{0};
+
+  /// \brief Messages discarded because a queue of the bridge was full: the
+  /// IgnPublishQueue towards Ignition or the topic queue of the
+  /// IgnDispatcher from Ignition.
+  std::atomic<uint64_t> queue_dropped{0};
+
+  /// \brief Messages ignored because the bridge itself published them.
+  std::atomic<uint64_t> echo_filtered{0};
+
+  /// \brief Time from entering the callback to returning from publish.
+  LatencyHistogram latency;
+
+  /// \brief Measuring a serialized size walks the whole message, so only
+  /// one forwarded message in this many is measured.
+  static constexpr uint64_t kSizeSampleInterval = 16;
+
+  /// \brief Whether the message being forwarded is the one to measure. The
+  /// first message of a bridge always is.
+  bool
+  sample_sizes()
+  {
+    return size_samples_.fetch_add(1, std::memory_order_relaxed) %
+      kSizeSampleInterval == 0;
+  }
+
+  /// \brief Record the sizes of a message picked by sample_sizes(), which
+  /// stands for the kSizeSampleInterval messages around it.
+  void
+  record_sizes(uint64_t in_bytes, uint64_t out_bytes)
+  {
+    bytes_in.fetch_add(in_bytes * kSizeSampleInterval,
+      std::memory_order_relaxed);
+    bytes_out.fetch_add(out_bytes * kSizeSampleInterval,
+      std::memory_order_relaxed);
+  }
+
+  /// \brief Record a message that made it through the bridge.
+  void
+  record_forwarded(int64_t start_ns)
+  {
+    messages_out.fetch_add(1, std::memory_order_relaxed);
+    latency.record(steady_now_ns() - start_ns);
+  }
+
+  BridgeStatsSnapshot
+  snapshot()
+  {
+    BridgeStatsSnapshot result;
+    result.messages_in = messages_in.load(std::memory_order_relaxed);
+    result.messages_out = messages_out.load(std::memory_order_relaxed);
+    result.bytes_in = bytes_in.load(std::memory_order_relaxed);
+    result.bytes_out = bytes_out.load(std::memory_order_relaxed);
+    result.dropped = dropped.load(std::memory_order_relaxed);
+    result.queue_dropped = queue_dropped.load(std::memory_order_relaxed);
+    result.echo_filtered = echo_filtered.load(std::memory_order_relaxed);
+    result.latency_max_ns = latency.take(result.latency_counts);
+    return result;
+  }
+
+private:
+  std::atomic<uint64_t> size_samples_{0};
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__BRIDGE_STATS_HPP_
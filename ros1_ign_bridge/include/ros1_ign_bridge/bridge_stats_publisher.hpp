@@ -0,0 +1,82 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__BRIDGE_STATS_PUBLISHER_HPP_
+#define ROS1_IGN_BRIDGE__BRIDGE_STATS_PUBLISHER_HPP_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+// include ROS 1
+#include <ros/node_handle.h>
+#include <ros/publisher.h>
+#include <ros/wall_timer.h>
+
+// include Ignition Transport
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge_registry.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Periodically publishes the statistics of the bridges of a registry
+/// on both transports, and optionally their health:
+///   ~statistics (ros1_ign_bridge/BridgeStatistics)
+///   <ign_topic> (ignition.msgs.Param_V, one Param per bridge direction)
+///   /diagnostics (diagnostic_msgs/DiagnosticArray, see check_bridge_health)
+class BridgeStatsPublisher
+{
+public:
+  /// \param[in] registry Bridges to report. It must outlive this object.
+  /// \param[in] ros1_node Namespace of the ROS 1 topic.
+  /// \param[in] ign_node Node advertising the Ignition topic.
+  /// \param[in] ign_topic Name of the Ignition topic.
+  /// \param[in] period Seconds between reports.
+  /// \param[in] diagnostics Whether to publish /diagnostics too.
+  BridgeStatsPublisher(
+    BridgeRegistry & registry,
+    ros::NodeHandle ros1_node,
+    std::shared_ptr<ignition::transport::Node> ign_node,
+    const std::string & ign_topic,
+    double period,
+    bool diagnostics = false);
+
+private:
+  /// \brief Counters of a bridge direction at the previous report.
+  struct Totals
+  {
+    uint64_t messages_in = 0;
+    uint64_t messages_out = 0;
+    uint64_t bytes_in = 0;
+    uint64_t bytes_out = 0;
+  };
+
+  void
+  publish(const ros::WallTimerEvent & event);
+
+  BridgeRegistry & registry_;
+  ros::Publisher ros1_pub_;
+  ros::Publisher diagnostics_pub_;
+  ignition::transport::Node::Publisher ign_pub_;
+  ros::WallTimer timer_;
+  ros::WallTime last_report_;
+  std::map<std::string, Totals> previous_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__BRIDGE_STATS_PUBLISHER_HPP_
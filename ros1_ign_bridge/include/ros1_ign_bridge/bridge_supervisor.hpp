@@ -0,0 +1,99 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__BRIDGE_SUPERVISOR_HPP_
+#define ROS1_IGN_BRIDGE__BRIDGE_SUPERVISOR_HPP_
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ros1_ign_bridge/bridge_config.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Worker process of a bridge in supervisor mode: its
+/// BridgeConfig::process if set, otherwise "sensors" for images, point
+/// clouds and laser scans, "control" for the other topics going only to
+/// Ignition and "state" for the rest.
+std::string
+process_class(const BridgeConfig & config);
+
+/// \brief Runs bridge worker processes, restarts the ones that exit and
+/// stops them all at the end.
+class BridgeSupervisor
+{
+public:
+  /// \param[in] executable Path of the program run by the workers.
+  explicit BridgeSupervisor(const std::string & executable);
+
+  /// \brief Stops the workers still running.
+  ~BridgeSupervisor();
+
+  BridgeSupervisor(const BridgeSupervisor &) = delete;
+  BridgeSupervisor & operator=(const BridgeSupervisor &) = delete;
+
+  /// \brief Add a worker, started by run().
+  /// \param[in] name Name of the worker in the messages.
+  /// \param[in] args Arguments of the program.
+  void
+  add_worker(const std::string & name, const std::vector<std::string> & args);
+
+  /// \brief Start the workers and restart them when they exit, until
+  /// keep_running returns false, then stop them. A worker that keeps failing
+  /// is restarted after a delay doubling from 1 up to 30 seconds.
+  void
+  run(const std::function<bool()> & keep_running);
+
+  /// \brief Process id of a worker, -1 if it is not running or unknown.
+  pid_t
+  pid(const std::string & name) const;
+
+  /// \brief Times a worker exited and was scheduled to restart, 0 if it is
+  /// unknown.
+  unsigned int
+  restarts(const std::string & name) const;
+
+private:
+  struct Worker
+  {
+    std::string name;
+    std::vector<std::string> args;
+    pid_t pid = -1;
+    unsigned int restarts = 0;
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point next_start;
+    std::chrono::seconds backoff{1};
+  };
+
+  /// \return False if the process could not be created.
+  bool
+  start(Worker & worker);
+
+  /// \brief Send SIGINT to the workers and SIGKILL to those still running a
+  /// few seconds later.
+  void
+  stop_all();
+
+  std::string executable_;
+  std::vector<Worker> workers_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__BRIDGE_SUPERVISOR_HPP_
@@ -37,14 +37,23 @@
 #include <std_msgs/Float32.h>
 #include <std_msgs/Header.h>
 #include <std_msgs/String.h>
+#include <std_srvs/Empty.h>
+#include <std_srvs/SetBool.h>
+#include <std_srvs/Trigger.h>
+#include <tf2_msgs/TFMessage.h>
+
+#include "ros1_ign_bridge/ControlWorld.h"
 
 // include Ignition Transport messages
 #include <ignition/msgs.hh>
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "ros1_ign_bridge/factory.hpp"
+#include "ros1_ign_bridge/service_factory.hpp"
 
 namespace ros1_ign_bridge
 {
@@ -54,10 +63,29 @@ get_factory_builtin_interfaces(
   const std::string & ros1_type_name,
   const std::string & ign_type_name);
 
+/// \brief Factory of a pair of types, created on first use and shared
+/// afterwards.
+/// \throws std::runtime_error if no converter handles the pair.
 std::shared_ptr<FactoryInterface>
 get_factory(const std::string & ros1_type_name,
             const std::string & ign_type_name);
 
+std::shared_ptr<ServiceFactoryInterface>
+get_service_factory_builtin_interfaces(
+  const std::string & ros1_type_name,
+  const std::string & ign_request_type_name,
+  const std::string & ign_reply_type_name);
+
+std::shared_ptr<ServiceFactoryInterface>
+get_service_factory(const std::string & ros1_type_name,
+                    const std::string & ign_request_type_name,
+                    const std::string & ign_reply_type_name);
+
+/// \brief All the (ROS 1 type, Ignition type) pairs with a builtin factory.
+/// When a type has several counterparts the preferred one comes first.
+const std::vector<std::pair<std::string, std::string>> &
+get_builtin_interfaces_type_pairs();
+
 // conversion functions for available interfaces
 
 // std_msgs
@@ -443,6 +471,25 @@ Factory<
   const ignition::msgs::PointCloud & ign_msg,
   sensor_msgs::PointCloud2 & ros1_msg);
 
+// tf2_msgs
+template<>
+void
+Factory<
+  tf2_msgs::TFMessage,
+  ignition::msgs::Pose_V
+>::convert_1_to_ign(
+  const tf2_msgs::TFMessage & ros1_msg,
+  ignition::msgs::Pose_V & ign_msg);
+
+template<>
+void
+Factory<
+  tf2_msgs::TFMessage,
+  ignition::msgs::Pose_V
+>::convert_ign_to_1(
+  const ignition::msgs::Pose_V & ign_msg,
+  tf2_msgs::TFMessage & ros1_msg);
+
 }  // namespace ros1_ign_bridge
 
 #endif  // ROS1_IGN_BRIDGE__BUILTIN_INTERFACES_FACTORIES_HPP_
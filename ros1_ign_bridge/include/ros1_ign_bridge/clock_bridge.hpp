@@ -0,0 +1,113 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__CLOCK_BRIDGE_HPP_
+#define ROS1_IGN_BRIDGE__CLOCK_BRIDGE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// include ROS 1
+#include <ros/node_handle.h>
+#include <ros/publisher.h>
+
+// include Ignition Transport
+#include <ignition/msgs/clock.pb.h>
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge_config.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Forwards the simulation time from Ignition to the ROS 1 /clock
+/// topic on a thread of its own.
+///
+/// The Ignition callback only records the latest time. The publishing thread
+/// sends it at most config.max_rate times per second, and the latest time
+/// received is always sent once the period has elapsed, so the last value
+/// before the simulation pauses is never lost. A repeated time is dropped,
+/// and a time before the latest one is taken as a world reset: it replaces
+/// the latest time and is published without waiting for the period.
+class ClockBridge
+{
+public:
+  /// \brief Advertise the ROS 1 topic, subscribe to the Ignition one and
+  /// start the publishing thread.
+  ClockBridge(
+    ros::NodeHandle ros1_node,
+    std::shared_ptr<ignition::transport::Node> ign_node,
+    const ClockBridgeConfig & config);
+
+  /// \brief Unsubscribe and join the publishing thread.
+  ~ClockBridge();
+
+  ClockBridge(const ClockBridge &) = delete;
+  ClockBridge & operator=(const ClockBridge &) = delete;
+
+  /// \brief Times received from Ignition.
+  uint64_t
+  received() const;
+
+  /// \brief Times published on ROS 1.
+  uint64_t
+  published() const;
+
+  /// \brief Times before the latest one, each handled as a world reset.
+  uint64_t
+  backwards() const;
+
+private:
+  void
+  on_clock(const ignition::msgs::Clock & ign_msg);
+
+  void
+  run();
+
+  ClockBridgeConfig config_;
+  std::shared_ptr<ignition::transport::Node> ign_node_;
+  ros::Publisher ros1_pub_;
+
+  /// \brief Minimum time between two publications, 0 for none.
+  const int64_t period_ns_;
+
+  /// \brief Protects the members below.
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool running_ = true;
+
+  /// \brief Latest simulation time received, in nanoseconds.
+  int64_t latest_ns_ = -1;
+
+  /// \brief Whether latest_ns_ has not been published yet.
+  bool pending_ = false;
+
+  /// \brief Whether latest_ns_ went backwards and skips the decimation.
+  bool reset_ = false;
+
+  std::atomic<uint64_t> received_{0};
+  std::atomic<uint64_t> published_{0};
+  std::atomic<uint64_t> backwards_{0};
+
+  std::thread thread_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__CLOCK_BRIDGE_HPP_
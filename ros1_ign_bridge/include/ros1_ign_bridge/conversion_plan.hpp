@@ -0,0 +1,223 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__CONVERSION_PLAN_HPP_
+#define ROS1_IGN_BRIDGE__CONVERSION_PLAN_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+
+namespace ros1_ign_bridge
+{
+
+/// \brief One field of a ROS 1 message definition.
+struct RosFieldSpec
+{
+  std::string name;
+
+  /// \brief A builtin type such as "float64", or a message type such as
+  /// "geometry_msgs/Point".
+  std::string type;
+
+  bool is_array = false;
+
+  /// \brief Length of fixed size arrays, -1 for variable size ones.
+  int array_length = -1;
+};
+
+/// \brief Fields of a ROS 1 message type, in wire order.
+struct RosMessageSpec
+{
+  std::string type;
+  std::vector<RosFieldSpec> fields;
+
+  /// \brief Constants as "type name=value", which are not serialized but
+  /// take part in the MD5 sum.
+  std::vector<std::string> constants;
+};
+
+/// \brief ROS 1 message types by name.
+using RosMessageSpecs = std::map<std::string, RosMessageSpec>;
+
+/// \brief Read the definition of a ROS 1 message type and of the types it
+/// uses from the .msg files of their packages.
+/// \param[in] type Message type, e.g. "geometry_msgs/PoseStamped".
+/// \param[out] specs The parsed types are added here.
+/// \param[out] definition Full definition, as sent in connection headers.
+/// \throws std::runtime_error if a type can't be found or parsed.
+void
+load_ros_message_specs(
+  const std::string & type,
+  RosMessageSpecs & specs,
+  std::string & definition);
+
+/// \brief MD5 sum of a ROS 1 message type, computed from its definition
+/// like genmsg does, as checked by the connections of its topics.
+/// \param[in] type Message type, e.g. "geometry_msgs/PoseStamped".
+/// \param[in] specs Definitions of type and the types it uses.
+/// \throws std::runtime_error if a definition is missing.
+std::string
+ros_message_md5(const std::string & type, const RosMessageSpecs & specs);
+
+/// \brief Conversion between the serialized form of a ROS 1 message and a
+/// protobuf message, compiled once from their definitions.
+///
+/// Every ROS 1 field becomes an operation bound to the protobuf field
+/// descriptors it maps to, so converting a message involves no lookup by
+/// name. Arrays whose element types match on both sides are copied in bulk.
+///
+/// ROS 1 fields are matched with protobuf fields of the same name, nested
+/// messages recursively. time and duration match messages with "sec" and
+/// "nsec" fields such as ignition.msgs.Time. A mapping from dotted ROS 1
+/// field paths to dotted protobuf field paths, e.g. "pose.position" ->
+/// "position", overrides the matching outside of arrays; mapping a path to an
+/// empty string ignores the field. Other unmatched strings and numbers are
+/// stored under their name in the key/value "data" map of the protobuf
+/// message if it has one, like the seq and frame_id of a std_msgs/Header in
+/// an ignition.msgs.Header. The remaining unmatched ROS 1 fields are skipped
+/// when converting to protobuf and zero when converting from it.
+class ConversionPlan
+{
+public:
+  /// \param[in] ros1_type ROS 1 message type.
+  /// \param[in] specs Definitions of ros1_type and the types it uses.
+  /// \param[in] descriptor Protobuf message type.
+  /// \param[in] field_mappings ROS 1 field path to protobuf field path.
+  /// \throws std::runtime_error if a mapped field doesn't exist or the types
+  /// of two matched fields can't be converted.
+  ConversionPlan(
+    const std::string & ros1_type,
+    const RosMessageSpecs & specs,
+    const google::protobuf::Descriptor * descriptor,
+    const std::map<std::string, std::string> & field_mappings);
+
+  /// \brief Fill a protobuf message from a serialized ROS 1 message.
+  /// \throws std::runtime_error if the data is truncated.
+  void
+  ros1_to_ign(
+    const uint8_t * data,
+    size_t size,
+    google::protobuf::Message & ign_msg) const;
+
+  /// \brief Serialize a protobuf message as a ROS 1 message.
+  /// \param[out] data Replaced by the serialized message.
+  void
+  ign_to_ros1(
+    const google::protobuf::Message & ign_msg,
+    std::vector<uint8_t> & data) const;
+
+  /// \brief Protobuf message type the plan was compiled for.
+  const google::protobuf::Descriptor *
+  descriptor() const;
+
+  /// \brief MD5 sum of the ROS 1 message type, see ros_message_md5().
+  const std::string &
+  md5sum() const;
+
+  /// \brief ROS 1 primitive types.
+  enum class Primitive : uint8_t
+  {
+    BOOL, INT8, UINT8, INT16, UINT16, INT32, UINT32, INT64, UINT64,
+    FLOAT32, FLOAT64, STRING, MESSAGE
+  };
+
+  /// \brief Conversion of one ROS 1 field.
+  struct Op
+  {
+    enum class Kind : uint8_t
+    {
+      SCALAR,        ///< Number or bool <-> number, bool or enum.
+      STRING,        ///< string <-> string or bytes.
+      BYTES_ARRAY,   ///< uint8[] or int8[] <-> bytes or string.
+      BULK_ARRAY,    ///< Number array <-> repeated field of the same type.
+      SCALAR_ARRAY,  ///< Other number or bool arrays.
+      STRING_ARRAY,  ///< string[] <-> repeated string.
+      MESSAGE_ARRAY, ///< Message array <-> repeated message.
+      MAP_ENTRY      ///< String or number <-> entry of a key/value map.
+    };
+
+    Kind kind;
+    Primitive primitive;
+
+    /// \brief Length of fixed size arrays, -1 otherwise.
+    int array_length = -1;
+
+    /// \brief Protobuf fields leading to the target field from the message
+    /// of the level, empty if the field has no counterpart.
+    std::vector<const google::protobuf::FieldDescriptor *> path;
+
+    /// \brief Level converting the elements of a MESSAGE_ARRAY.
+    int level = -1;
+
+    /// \brief Key of a MAP_ENTRY, whose path leads to the repeated map
+    /// field, and the fields of the key and values in the entries.
+    std::string key;
+    const google::protobuf::FieldDescriptor * key_field = nullptr;
+    const google::protobuf::FieldDescriptor * value_field = nullptr;
+  };
+
+private:
+  /// \brief The operations converting one message type.
+  struct Level
+  {
+    std::vector<Op> ops;
+  };
+
+  class Reader;
+  class Writer;
+
+  int
+  compile_level(
+    const std::string & ros1_type,
+    const RosMessageSpecs & specs,
+    const google::protobuf::Descriptor * descriptor,
+    const std::map<std::string, std::string> * field_mappings);
+
+  void
+  compile_fields(
+    int level,
+    const std::string & ros1_type,
+    const RosMessageSpecs & specs,
+    const google::protobuf::Descriptor * root,
+    const google::protobuf::Descriptor * context,
+    const std::vector<const google::protobuf::FieldDescriptor *> & prefix,
+    const std::string & ros1_prefix,
+    const std::map<std::string, std::string> * field_mappings);
+
+  void
+  run_ros1_to_ign(
+    int level, Reader & reader, google::protobuf::Message * ign_msg) const;
+
+  void
+  run_ign_to_ros1(
+    int level,
+    const google::protobuf::Message * ign_msg,
+    Writer & writer) const;
+
+  const google::protobuf::Descriptor * descriptor_;
+
+  std::string md5sum_;
+
+  /// \brief Level 0 converts the top level message.
+  std::vector<Level> levels_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__CONVERSION_PLAN_HPP_
@@ -37,6 +37,12 @@
 #include <std_msgs/Float32.h>
 #include <std_msgs/Header.h>
 #include <std_msgs/String.h>
+#include <std_srvs/Empty.h>
+#include <std_srvs/SetBool.h>
+#include <std_srvs/Trigger.h>
+#include <tf2_msgs/TFMessage.h>
+
+#include "ros1_ign_bridge/ControlWorld.h"
 
 // include Ignition builtin messages
 #include <ignition/msgs.hh>
@@ -303,6 +309,117 @@ convert_ign_to_1(
   const ignition::msgs::PointCloud & ign_msg,
   sensor_msgs::PointCloud2 & ros1_msg);
 
+// tf2_msgs
+template<>
+void
+convert_1_to_ign(
+  const tf2_msgs::TFMessage & ros1_msg,
+  ignition::msgs::Pose_V & ign_msg);
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Pose_V & ign_msg,
+  tf2_msgs::TFMessage & ros1_msg);
+
+// std_srvs
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::Empty::Request & ros1_msg,
+  ignition::msgs::Empty & ign_msg);
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Empty & ign_msg,
+  std_srvs::Empty::Request & ros1_msg);
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::Empty::Response & ros1_msg,
+  ignition::msgs::Empty & ign_msg);
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Empty & ign_msg,
+  std_srvs::Empty::Response & ros1_msg);
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::SetBool::Request & ros1_msg,
+  ignition::msgs::Boolean & ign_msg);
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Boolean & ign_msg,
+  std_srvs::SetBool::Request & ros1_msg);
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::SetBool::Response & ros1_msg,
+  ignition::msgs::Boolean & ign_msg);
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Boolean & ign_msg,
+  std_srvs::SetBool::Response & ros1_msg);
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::Trigger::Request & ros1_msg,
+  ignition::msgs::Empty & ign_msg);
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Empty & ign_msg,
+  std_srvs::Trigger::Request & ros1_msg);
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::Trigger::Response & ros1_msg,
+  ignition::msgs::Boolean & ign_msg);
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Boolean & ign_msg,
+  std_srvs::Trigger::Response & ros1_msg);
+
+// ros1_ign_bridge
+template<>
+void
+convert_1_to_ign(
+  const ros1_ign_bridge::ControlWorld::Request & ros1_msg,
+  ignition::msgs::WorldControl & ign_msg);
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::WorldControl & ign_msg,
+  ros1_ign_bridge::ControlWorld::Request & ros1_msg);
+
+template<>
+void
+convert_1_to_ign(
+  const ros1_ign_bridge::ControlWorld::Response & ros1_msg,
+  ignition::msgs::Boolean & ign_msg);
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Boolean & ign_msg,
+  ros1_ign_bridge::ControlWorld::Response & ros1_msg);
+
 }  // namespace ros1_ign_bridge
 
 #endif  // ROS1_IGN_BRIDGE__CONVERT_BUILTIN_INTERFACES_HPP_
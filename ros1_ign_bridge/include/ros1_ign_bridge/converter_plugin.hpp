@@ -0,0 +1,78 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__CONVERTER_PLUGIN_HPP_
+#define ROS1_IGN_BRIDGE__CONVERTER_PLUGIN_HPP_
+
+#include <memory>
+#include <string>
+
+#include "ros1_ign_bridge/factory.hpp"
+#include "ros1_ign_bridge/factory_interface.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Base class of the converters loaded at runtime with pluginlib.
+///
+/// A plugin provides the factory of a single type pair. It is declared in
+/// the plugin description file of its package with the lookup name
+/// "<ROS1_type>@<Ign_type>", e.g.
+///
+///   <class name="my_msgs/Foo@ignition.msgs.Foo"
+///          type="my_package::FooConverter"
+///          base_class_type="ros1_ign_bridge::ConverterPlugin"/>
+///
+/// so that only the libraries of the pairs in use are ever loaded.
+class ConverterPlugin
+{
+public:
+  virtual ~ConverterPlugin() = default;
+
+  /// \brief Create the factory of the pair the plugin was declared for.
+  virtual
+  std::shared_ptr<FactoryInterface>
+  create_factory(
+    const std::string & ros1_type_name,
+    const std::string & ign_type_name) = 0;
+};
+
+/// \brief Plugin exposing a Factory whose conversion functions are defined by
+/// the plugin library, e.g.
+///
+///   template<>
+///   void
+///   Factory<my_msgs::Foo, ignition::msgs::Foo>::convert_1_to_ign(...) {...}
+///   (and convert_ign_to_1)
+///
+///   using FooConverter =
+///     ros1_ign_bridge::FactoryPlugin<my_msgs::Foo, ignition::msgs::Foo>;
+///   PLUGINLIB_EXPORT_CLASS(FooConverter, ros1_ign_bridge::ConverterPlugin)
+template<typename ROS1_T, typename IGN_T>
+class FactoryPlugin : public ConverterPlugin
+{
+public:
+  std::shared_ptr<FactoryInterface>
+  create_factory(
+    const std::string & ros1_type_name,
+    const std::string & ign_type_name)
+  {
+    return std::make_shared<Factory<ROS1_T, IGN_T>>(
+      ros1_type_name, ign_type_name);
+  }
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__CONVERTER_PLUGIN_HPP_
@@ -0,0 +1,43 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__CONVERTER_PLUGINS_HPP_
+#define ROS1_IGN_BRIDGE__CONVERTER_PLUGINS_HPP_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ros1_ign_bridge/factory_interface.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Factory of a pair provided by a converter plugin. The plugin
+/// library is loaded on first use and stays loaded until the process exits.
+/// \return Null if no installed plugin declares the pair.
+std::shared_ptr<FactoryInterface>
+get_factory_from_plugins(
+  const std::string & ros1_type_name,
+  const std::string & ign_type_name);
+
+/// \brief The (ROS 1 type, Ignition type) pairs declared by the installed
+/// converter plugins. Only their description files are read.
+std::vector<std::pair<std::string, std::string>>
+get_plugin_type_pairs();
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__CONVERTER_PLUGINS_HPP_
@@ -15,9 +15,11 @@
 #ifndef ROS1_IGN_BRIDGE__FACTORY_HPP_
 #define ROS1_IGN_BRIDGE__FACTORY_HPP_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include <ignition/transport/Node.hh>
 
@@ -26,6 +28,9 @@
 #include <ros/ros.h>
 
 #include "ros1_ign_bridge/factory_interface.hpp"
+#include "ros1_ign_bridge/ign_publish_queue.hpp"
+#include "ros1_ign_bridge/message_recycling.hpp"
+#include "ros1_ign_bridge/trace.hpp"
 
 namespace ros1_ign_bridge
 {
@@ -44,18 +49,25 @@ public:
   create_ros1_publisher(
     ros::NodeHandle node,
     const std::string & topic_name,
-    size_t queue_size)
+    size_t queue_size,
+    const ros::SubscriberStatusCallback & connect_cb =
+      ros::SubscriberStatusCallback(),
+    const ros::SubscriberStatusCallback & disconnect_cb =
+      ros::SubscriberStatusCallback())
   {
-    return node.advertise<ROS1_T>(topic_name, queue_size);
+    return node.advertise<ROS1_T>(
+      topic_name, queue_size, connect_cb, disconnect_cb);
   }
 
   ignition::transport::Node::Publisher
   create_ign_publisher(
     std::shared_ptr<ignition::transport::Node> ign_node,
     const std::string & topic_name,
-    size_t /*queue_size*/)
+    size_t /*queue_size*/,
+    size_t msgs_per_sec = 0)
   {
-    return ign_node->Advertise<IGN_T>(topic_name);
+    return ign_node->Advertise<IGN_T>(
+      topic_name, ign_advertise_options(msgs_per_sec));
   }
 
   ros::Subscriber
@@ -63,7 +75,8 @@ public:
     ros::NodeHandle node,
     const std::string & topic_name,
     size_t queue_size,
-    ignition::transport::Node::Publisher & ign_pub)
+    ignition::transport::Node::Publisher & ign_pub,
+    std::shared_ptr<BridgeState> state)
   {
     // workaround for https://github.com/ros/roscpp_core/issues/22 to get the
     // connection header
@@ -77,7 +90,7 @@ public:
         <const ros::MessageEvent<ROS1_T const> &>(
           boost::bind(
             &Factory<ROS1_T, IGN_T>::ros1_callback,
-            _1, ign_pub, ros1_type_name_, ign_type_name_)));
+            _1, ign_pub, ros1_type_name_, ign_type_name_, state)));
     return node.subscribe(ops);
   }
 
@@ -86,16 +99,37 @@ public:
     std::shared_ptr<ignition::transport::Node> node,
     const std::string & topic_name,
     size_t /*queue_size*/,
-    ros::Publisher ros1_pub)
+    ros::Publisher ros1_pub,
+    std::shared_ptr<BridgeState> state,
+    size_t msgs_per_sec = 0)
   {
-
+    // Capture only what the callback needs so that the subscription does not
+    // depend on the lifetime of this factory.
     std::function<void(const IGN_T&)> subCb =
-    [this, ros1_pub](const IGN_T &_msg)
+    [ros1_pub, state](const IGN_T &_msg)
     {
-      this->ign_callback(_msg, ros1_pub);
+      Factory<ROS1_T, IGN_T>::ign_callback(_msg, ros1_pub, state);
     };
 
-    node->Subscribe(topic_name, subCb);
+    node->Subscribe(topic_name, subCb, ign_subscribe_options(msgs_per_sec));
+  }
+
+  bool
+  forward_ign_serialized(
+    const char * data,
+    size_t size,
+    ros::Publisher ros1_pub,
+    std::shared_ptr<BridgeState> state)
+  {
+    IgnConversionTarget<IGN_T> target;
+    IGN_T & ign_msg = target.get();
+    {
+      ROS1_IGN_BRIDGE_TRACE_SCOPE("ign_parse", state->trace_label);
+      if (!ign_msg.ParseFromArray(data, static_cast<int>(size)))
+        return false;
+    }
+    Factory<ROS1_T, IGN_T>::ign_callback(ign_msg, ros1_pub, state);
+    return true;
   }
 
 protected:
@@ -105,8 +139,11 @@ protected:
     const ros::MessageEvent<ROS1_T const> & ros1_msg_event,
     ignition::transport::Node::Publisher & ign_pub,
     const std::string & /*ros1_type_name*/,
-    const std::string & /*ign_type_name*/)
+    const std::string & /*ign_type_name*/,
+    std::shared_ptr<BridgeState> state)
   {
+    ROS1_IGN_BRIDGE_TRACE_SCOPE("ros1_callback", state->trace_label);
+
     const boost::shared_ptr<ros::M_string> & connection_header =
       ros1_msg_event.getConnectionHeaderPtr();
     if (!connection_header) {
@@ -117,26 +154,91 @@ protected:
     std::string key = "callerid";
     if (connection_header->find(key) != connection_header->end()) {
       if (connection_header->at(key) == ros::this_node::getName()) {
+        state->stats.echo_filtered.fetch_add(1, std::memory_order_relaxed);
         return;
       }
     }
 
+    const int64_t start_ns = steady_now_ns();
+    state->stats.messages_in.fetch_add(1, std::memory_order_relaxed);
+
+    if (state->lazy && !ign_pub.HasConnections()) {
+      return;
+    }
+
+    if (!state->rate_limiter.allow()) {
+      state->stats.dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
     const boost::shared_ptr<ROS1_T const> & ros1_msg =
       ros1_msg_event.getConstMessage();
 
-    IGN_T ign_msg;
-    convert_1_to_ign(*ros1_msg, ign_msg);
-    ign_pub.Publish(ign_msg);
+    if (state->publish_queue) {
+      std::unique_ptr<IGN_T> queued_msg(new IGN_T());
+      {
+        ROS1_IGN_BRIDGE_TRACE_SCOPE("convert_1_to_ign", state->trace_label);
+        convert_1_to_ign(*ros1_msg, *queued_msg);
+      }
+      const bool sampled = state->stats.sample_sizes();
+      state->publish_queue->push(std::move(queued_msg), start_ns, sampled,
+        sampled ? ros::serialization::serializationLength(*ros1_msg) : 0);
+      return;
+    }
+
+    // Publish() serializes, or copies for in-process subscribers, before
+    // returning, so the message can be reused by the next callback.
+    IgnConversionTarget<IGN_T> target;
+    IGN_T & ign_msg = target.get();
+    {
+      ROS1_IGN_BRIDGE_TRACE_SCOPE("convert_1_to_ign", state->trace_label);
+      convert_1_to_ign(*ros1_msg, ign_msg);
+    }
+    {
+      ROS1_IGN_BRIDGE_TRACE_SCOPE("ign_publish", state->trace_label);
+      ign_pub.Publish(ign_msg);
+    }
+
+    state->stats.record_forwarded(start_ns);
+    if (state->stats.sample_sizes()) {
+      state->stats.record_sizes(
+        ros::serialization::serializationLength(*ros1_msg),
+        ign_msg.ByteSizeLong());
+    }
   }
 
   static
   void ign_callback(
     const IGN_T & ign_msg,
-    ros::Publisher ros1_pub)
+    ros::Publisher ros1_pub,
+    std::shared_ptr<BridgeState> state)
   {
-    ROS1_T ros1_msg;
-    convert_ign_to_1(ign_msg, ros1_msg);
-    ros1_pub.publish(ros1_msg);
+    ROS1_IGN_BRIDGE_TRACE_SCOPE("ign_callback", state->trace_label);
+
+    const int64_t start_ns = steady_now_ns();
+    state->stats.messages_in.fetch_add(1, std::memory_order_relaxed);
+
+    if (!state->rate_limiter.allow()) {
+      state->stats.dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    ConversionTarget<ROS1_T> target;
+    ROS1_T & ros1_msg = target.get();
+    {
+      ROS1_IGN_BRIDGE_TRACE_SCOPE("convert_ign_to_1", state->trace_label);
+      convert_ign_to_1(ign_msg, ros1_msg);
+    }
+    {
+      ROS1_IGN_BRIDGE_TRACE_SCOPE("ros1_publish", state->trace_label);
+      ros1_pub.publish(ros1_msg);
+    }
+
+    state->stats.record_forwarded(start_ns);
+    if (state->stats.sample_sizes()) {
+      state->stats.record_sizes(ign_msg.ByteSizeLong(),
+        ros::serialization::serializationLength(ros1_msg));
+    }
   }
 
 public:
@@ -15,6 +15,7 @@
 #ifndef  ROS1_IGN_BRIDGE__FACTORY_INTERFACE_HPP_
 #define  ROS1_IGN_BRIDGE__FACTORY_INTERFACE_HPP_
 
+#include <memory>
 #include <string>
 
 // include ROS 1
@@ -24,6 +25,8 @@
 // include Ignition Transport
 #include <ignition/transport/Node.hh>
 
+#include "ros1_ign_bridge/bridge_state.hpp"
+
 namespace ros1_ign_bridge
 {
 
@@ -35,14 +38,21 @@ public:
   create_ros1_publisher(
     ros::NodeHandle node,
     const std::string & topic_name,
-    size_t queue_size) = 0;
+    size_t queue_size,
+    const ros::SubscriberStatusCallback & connect_cb =
+      ros::SubscriberStatusCallback(),
+    const ros::SubscriberStatusCallback & disconnect_cb =
+      ros::SubscriberStatusCallback()) = 0;
 
+  /// \param[in] msgs_per_sec Messages per second let through by Ignition
+  /// Transport, 0 for no limit.
   virtual
   ignition::transport::Node::Publisher
   create_ign_publisher(
     std::shared_ptr<ignition::transport::Node> ign_node,
     const std::string & topic_name,
-    size_t queue_size) = 0;
+    size_t queue_size,
+    size_t msgs_per_sec = 0) = 0;
 
   virtual
   ros::Subscriber
@@ -50,17 +60,57 @@ public:
     ros::NodeHandle node,
     const std::string & topic_name,
     size_t queue_size,
-    ignition::transport::Node::Publisher & ign_pub) = 0;
+    ignition::transport::Node::Publisher & ign_pub,
+    std::shared_ptr<BridgeState> state) = 0;
 
+  /// \param[in] msgs_per_sec Messages per second delivered by Ignition
+  /// Transport, 0 for no limit.
   virtual
   void
   create_ign_subscriber(
     std::shared_ptr<ignition::transport::Node> node,
     const std::string & topic_name,
     size_t queue_size,
-    ros::Publisher ros1_pub) = 0;
+    ros::Publisher ros1_pub,
+    std::shared_ptr<BridgeState> state,
+    size_t msgs_per_sec = 0) = 0;
+
+  /// \brief Parse a serialized Ignition message and forward it to ROS 1 like
+  /// the subscriber of create_ign_subscriber() does, for IgnDispatcher.
+  /// \return False if the data doesn't parse.
+  virtual
+  bool
+  forward_ign_serialized(
+    const char * data,
+    size_t size,
+    ros::Publisher ros1_pub,
+    std::shared_ptr<BridgeState> state) = 0;
 };
 
+/// \brief Options throttling an Ignition publisher to msgs_per_sec, 0 for no
+/// limit.
+inline
+ignition::transport::AdvertiseMessageOptions
+ign_advertise_options(size_t msgs_per_sec)
+{
+  ignition::transport::AdvertiseMessageOptions options;
+  if (msgs_per_sec > 0)
+    options.SetMsgsPerSec(msgs_per_sec);
+  return options;
+}
+
+/// \brief Options throttling an Ignition subscription to msgs_per_sec, 0 for
+/// no limit.
+inline
+ignition::transport::SubscribeOptions
+ign_subscribe_options(size_t msgs_per_sec)
+{
+  ignition::transport::SubscribeOptions options;
+  if (msgs_per_sec > 0)
+    options.SetMsgsPerSec(msgs_per_sec);
+  return options;
+}
+
 }  // namespace ros1_ign_bridge
 
 #endif  // ROS1_IGN_BRIDGE__FACTORY_INTERFACE_HPP_
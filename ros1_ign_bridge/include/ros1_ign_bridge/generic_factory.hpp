@@ -0,0 +1,102 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__GENERIC_FACTORY_HPP_
+#define ROS1_IGN_BRIDGE__GENERIC_FACTORY_HPP_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "ros1_ign_bridge/conversion_plan.hpp"
+#include "ros1_ign_bridge/factory_interface.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Bridges any pair of types without compiled in conversion functions.
+///
+/// ROS 1 messages are received and published in serialized form, and
+/// converted from and to protobuf messages by a ConversionPlan built from the
+/// .msg files of the ROS 1 type and the descriptor of the Ignition type.
+class GenericFactory : public FactoryInterface
+{
+public:
+  /// \param[in] ros1_type_name ROS 1 message type, e.g. "my_msgs/Status".
+  /// \param[in] ign_type_name Ignition message type, which must be known to
+  /// ignition::msgs::Factory.
+  /// \param[in] field_mappings See ConversionPlan.
+  /// \throws std::runtime_error if either type can't be found or the plan
+  /// can't be compiled.
+  GenericFactory(
+    const std::string & ros1_type_name,
+    const std::string & ign_type_name,
+    const std::map<std::string, std::string> & field_mappings =
+      std::map<std::string, std::string>());
+
+  ros::Publisher
+  create_ros1_publisher(
+    ros::NodeHandle node,
+    const std::string & topic_name,
+    size_t queue_size,
+    const ros::SubscriberStatusCallback & connect_cb =
+      ros::SubscriberStatusCallback(),
+    const ros::SubscriberStatusCallback & disconnect_cb =
+      ros::SubscriberStatusCallback());
+
+  ignition::transport::Node::Publisher
+  create_ign_publisher(
+    std::shared_ptr<ignition::transport::Node> ign_node,
+    const std::string & topic_name,
+    size_t queue_size,
+    size_t msgs_per_sec = 0);
+
+  ros::Subscriber
+  create_ros1_subscriber(
+    ros::NodeHandle node,
+    const std::string & topic_name,
+    size_t queue_size,
+    ignition::transport::Node::Publisher & ign_pub,
+    std::shared_ptr<BridgeState> state);
+
+  void
+  create_ign_subscriber(
+    std::shared_ptr<ignition::transport::Node> node,
+    const std::string & topic_name,
+    size_t queue_size,
+    ros::Publisher ros1_pub,
+    std::shared_ptr<BridgeState> state,
+    size_t msgs_per_sec = 0);
+
+  bool
+  forward_ign_serialized(
+    const char * data,
+    size_t size,
+    ros::Publisher ros1_pub,
+    std::shared_ptr<BridgeState> state);
+
+private:
+  std::string ros1_type_name_;
+  std::string ign_type_name_;
+
+  /// \brief Full ROS 1 message definition, sent in connection headers.
+  std::string definition_;
+
+  /// \brief Shared with the callbacks, which may outlive the factory.
+  std::shared_ptr<const ConversionPlan> plan_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__GENERIC_FACTORY_HPP_
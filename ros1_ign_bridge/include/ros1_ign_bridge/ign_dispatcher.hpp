@@ -0,0 +1,191 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__IGN_DISPATCHER_HPP_
+#define ROS1_IGN_BRIDGE__IGN_DISPATCHER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// include ROS 1
+#include <ros/publisher.h>
+
+// include Ignition Transport
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge_state.hpp"
+#include "ros1_ign_bridge/factory_interface.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Receives the Ignition topics bridged to ROS 1 on several nodes and
+/// converts their messages on a pool of threads.
+///
+/// Ignition Transport runs the callbacks of all the subscriptions of a
+/// process on one thread, so converting and publishing there doesn't scale
+/// with the number of topics. The dispatcher subscribes to the serialized
+/// messages instead: the Ignition thread only copies them to the queue of
+/// their topic, which a worker parses, converts and publishes. The topics are
+/// spread over the nodes and the workers by a hash of their name, so the
+/// messages of a topic keep their order.
+///
+/// Every topic has a bounded queue of its own, which drops its oldest
+/// message when full, and a worker takes one message of each topic with
+/// messages waiting in turn, so that a busy topic can't starve the others
+/// that share its worker.
+///
+/// Each subscription calls back with the index of its route in a flat
+/// table, which holds the factory, the publisher and the state of the
+/// bridge, rather than with a closure of its own.
+class IgnDispatcher
+{
+public:
+  /// \param[in] num_nodes Ignition nodes the topics are spread over, at
+  /// least 1.
+  /// \param[in] num_threads Threads converting the messages, at least 1.
+  IgnDispatcher(size_t num_nodes, size_t num_threads);
+
+  /// \brief Calls stop().
+  ~IgnDispatcher();
+
+  IgnDispatcher(const IgnDispatcher &) = delete;
+  IgnDispatcher & operator=(const IgnDispatcher &) = delete;
+
+  /// \brief Node in charge of a topic, also used to publish to it.
+  std::shared_ptr<ignition::transport::Node>
+  node(const std::string & topic_name) const;
+
+  /// \brief Forward the messages of an Ignition topic to ROS 1 through
+  /// FactoryInterface::forward_ign_serialized(). Subscribing to a topic
+  /// again replaces its previous subscription, whose queued messages are
+  /// discarded.
+  /// \param[in] queue_size Messages of the topic waiting for a worker
+  /// beyond which the oldest one is dropped, at least 1.
+  /// \param[in] msgs_per_sec Messages per second delivered by Ignition
+  /// Transport, 0 for no limit.
+  /// \return False if Ignition Transport refused the subscription or the
+  /// dispatcher is stopped.
+  bool
+  subscribe(
+    const std::string & topic_name,
+    const std::string & ign_type_name,
+    std::shared_ptr<FactoryInterface> factory,
+    ros::Publisher ros1_pub,
+    std::shared_ptr<BridgeState> state,
+    size_t queue_size,
+    size_t msgs_per_sec = 0);
+
+  /// \brief Stop forwarding a topic. Its queued messages are discarded.
+  void
+  unsubscribe(const std::string & topic_name);
+
+  /// \brief Discard the queued messages and join the threads. Later
+  /// subscriptions fail.
+  void
+  stop();
+
+private:
+  /// \brief Destination of the messages of one subscription.
+  struct Route
+  {
+    std::shared_ptr<FactoryInterface> factory;
+    ros::Publisher ros1_pub;
+    std::shared_ptr<BridgeState> state;
+
+    /// \brief Index of the worker converting the messages.
+    size_t worker;
+
+    /// \brief Serialized messages beyond which the oldest one is dropped.
+    size_t queue_size;
+
+    /// \brief Cleared when unsubscribed or replaced, so that queued
+    /// messages are skipped.
+    std::atomic<bool> active{true};
+
+    /// \brief Serialized messages waiting, protected by the mutex of the
+    /// worker.
+    std::deque<std::string> items;
+
+    /// \brief Whether the route is in the ready list of the worker,
+    /// protected by the mutex of the worker.
+    bool ready = false;
+  };
+
+  struct Worker
+  {
+    /// \brief Protects the queues of its routes and the ready list.
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    /// \brief Routes with messages waiting, served in turn.
+    std::deque<std::shared_ptr<Route>> ready;
+    std::thread thread;
+  };
+
+  /// \brief Called by Ignition Transport with the serialized messages.
+  void
+  on_message(uint32_t route_id, const char * data, size_t size);
+
+  void
+  run(Worker & worker);
+
+  /// \brief Mark a route inactive and discard its queued messages.
+  void
+  deactivate(Route & route);
+
+  using RouteTable = std::vector<std::shared_ptr<Route>>;
+
+  /// \brief Publish a copy of the route table with one route replaced or
+  /// appended. Called with mutex_.
+  /// \return The route replaced, if any.
+  std::shared_ptr<Route>
+  set_route(uint32_t route_id, std::shared_ptr<Route> route);
+
+  std::vector<std::shared_ptr<ignition::transport::Node>> nodes_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<bool> running_{true};
+
+  /// \brief Routes indexed by the id given to the subscriptions. A topic
+  /// keeps its id when it is subscribed again, so that a message still in
+  /// flight from an old subscription can't reach another topic. The table
+  /// is never modified: set_route() swaps in a new one, so that on_message()
+  /// reads it without a lock.
+  std::atomic<const RouteTable *> routes_;
+
+  /// \brief Calls of on_message() that may be reading a route table.
+  std::atomic<size_t> readers_{0};
+
+  /// \brief Serializes the changes of the routes and protects the members
+  /// below.
+  mutable std::mutex mutex_;
+
+  /// \brief Tables replaced while a reader may still hold them, freed once
+  /// set_route() sees no reader or by the destructor.
+  std::vector<std::unique_ptr<const RouteTable>> retired_;
+
+  std::unordered_map<std::string, uint32_t> route_ids_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__IGN_DISPATCHER_HPP_
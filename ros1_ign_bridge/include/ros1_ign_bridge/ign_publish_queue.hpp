@@ -0,0 +1,116 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__IGN_PUBLISH_QUEUE_HPP_
+#define ROS1_IGN_BRIDGE__IGN_PUBLISH_QUEUE_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <google/protobuf/message.h>
+
+// include Ignition Transport
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge_config.hpp"
+#include "ros1_ign_bridge/bridge_stats.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Bounded queue of converted messages published to Ignition by a
+/// thread of its own, so that slow Ignition subscribers never hold up the
+/// ROS 1 callback threads.
+///
+/// When the queue is full, QueuePolicy::DROP_OLDEST discards the oldest
+/// queued message to make room and QueuePolicy::DROP_NEWEST discards the
+/// message being pushed. Both count in BridgeStats::queue_dropped, and the
+/// statistics also measure latencies up to the actual publication.
+class IgnPublishQueue
+{
+public:
+  /// \param[in] publisher Destination of the messages.
+  /// \param[in] capacity Maximum number of queued messages, at least 1.
+  /// \param[in] policy DROP_OLDEST or DROP_NEWEST.
+  /// \param[in] stats Statistics of the bridge direction, must outlive the
+  /// queue.
+  /// \param[in] trace_label Name of the bridge in traces.
+  IgnPublishQueue(
+    const ignition::transport::Node::Publisher & publisher,
+    size_t capacity,
+    QueuePolicy policy,
+    BridgeStats & stats,
+    uint32_t trace_label);
+
+  /// \brief Calls stop().
+  ~IgnPublishQueue();
+
+  IgnPublishQueue(const IgnPublishQueue &) = delete;
+  IgnPublishQueue & operator=(const IgnPublishQueue &) = delete;
+
+  /// \brief Queue a message for publication.
+  /// \param[in] msg Converted message.
+  /// \param[in] start_ns When the original message was received, see
+  /// steady_now_ns().
+  /// \param[in] sampled Whether BridgeStats::sample_sizes() picked the
+  /// message, in which case its sizes are recorded once it is published.
+  /// \param[in] in_bytes Serialized size of the original message, only used
+  /// if sampled.
+  /// \return False if a message was dropped to respect the capacity.
+  bool
+  push(
+    std::unique_ptr<google::protobuf::Message> msg,
+    int64_t start_ns,
+    bool sampled,
+    uint64_t in_bytes);
+
+  /// \brief Discard the queued messages and join the sender thread. Later
+  /// pushes are ignored.
+  void
+  stop();
+
+private:
+  struct Item
+  {
+    std::unique_ptr<google::protobuf::Message> msg;
+    int64_t start_ns;
+    bool sampled;
+    uint64_t in_bytes;
+  };
+
+  void
+  run();
+
+  ignition::transport::Node::Publisher publisher_;
+  const size_t capacity_;
+  const QueuePolicy policy_;
+  BridgeStats & stats_;
+  const uint32_t trace_label_;
+
+  /// \brief Protects the members below.
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<Item> items_;
+  bool running_ = true;
+
+  std::thread thread_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__IGN_PUBLISH_QUEUE_HPP_
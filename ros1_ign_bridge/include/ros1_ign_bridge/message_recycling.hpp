@@ -0,0 +1,163 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__MESSAGE_RECYCLING_HPP_
+#define ROS1_IGN_BRIDGE__MESSAGE_RECYCLING_HPP_
+
+#include <utility>
+
+#include <google/protobuf/arena.h>
+
+// include ROS 1
+#include <sensor_msgs/Image.h>
+#include <sensor_msgs/LaserScan.h>
+#include <sensor_msgs/PointCloud2.h>
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Whether the Ignition to ROS 1 direction converts into a message
+/// kept by the thread between calls, so that its payload buffers are
+/// allocated and page faulted once instead of for every message.
+///
+/// ros::Publisher::publish() serializes a message passed by reference before
+/// returning, so the buffers are free again as soon as it returns.
+template<typename ROS1_T>
+struct MessageRecycling
+{
+  static constexpr bool enabled = false;
+
+  /// \brief Give a recycled message its default value, keeping the capacity
+  /// of the payload buffers.
+  static void
+  reset(ROS1_T & /*msg*/)
+  {}
+};
+
+template<>
+struct MessageRecycling<sensor_msgs::Image>
+{
+  static constexpr bool enabled = true;
+
+  static void
+  reset(sensor_msgs::Image & msg)
+  {
+    auto data = std::move(msg.data);
+    msg = sensor_msgs::Image();
+    data.clear();
+    msg.data = std::move(data);
+  }
+};
+
+template<>
+struct MessageRecycling<sensor_msgs::LaserScan>
+{
+  static constexpr bool enabled = true;
+
+  static void
+  reset(sensor_msgs::LaserScan & msg)
+  {
+    auto ranges = std::move(msg.ranges);
+    auto intensities = std::move(msg.intensities);
+    msg = sensor_msgs::LaserScan();
+    ranges.clear();
+    intensities.clear();
+    msg.ranges = std::move(ranges);
+    msg.intensities = std::move(intensities);
+  }
+};
+
+template<>
+struct MessageRecycling<sensor_msgs::PointCloud2>
+{
+  static constexpr bool enabled = true;
+
+  static void
+  reset(sensor_msgs::PointCloud2 & msg)
+  {
+    auto data = std::move(msg.data);
+    msg = sensor_msgs::PointCloud2();
+    data.clear();
+    msg.data = std::move(data);
+  }
+};
+
+/// \brief Destination of an Ignition to ROS 1 conversion: a new message, or
+/// the one of the thread for the types with MessageRecycling enabled.
+template<typename ROS1_T, bool Recycled = MessageRecycling<ROS1_T>::enabled>
+class ConversionTarget
+{
+public:
+  ROS1_T &
+  get()
+  {
+    return msg_;
+  }
+
+private:
+  ROS1_T msg_;
+};
+
+template<typename ROS1_T>
+class ConversionTarget<ROS1_T, true>
+{
+public:
+  ROS1_T &
+  get()
+  {
+    thread_local ROS1_T msg;
+    MessageRecycling<ROS1_T>::reset(msg);
+    return msg;
+  }
+};
+
+/// \brief Ignition message that a conversion from ROS 1 writes to, valid
+/// until the next call to get() on the same thread.
+///
+/// Types generated with arena support are created on an arena of the thread
+/// that is reset for every message, so that the whole message tree takes a
+/// few block allocations instead of one per submessage and string. The other
+/// types reuse one cleared message per thread. This keeps the elements of its
+/// repeated fields and the capacity of its strings, but Clear() frees the
+/// singular submessages, so a nested message is mostly allocated again.
+template<typename IGN_T,
+  bool OnArena = google::protobuf::Arena::is_arena_constructable<IGN_T>::value>
+class IgnConversionTarget
+{
+public:
+  IGN_T &
+  get()
+  {
+    thread_local IGN_T msg;
+    msg.Clear();
+    return msg;
+  }
+};
+
+template<typename IGN_T>
+class IgnConversionTarget<IGN_T, true>
+{
+public:
+  IGN_T &
+  get()
+  {
+    thread_local google::protobuf::Arena arena;
+    arena.Reset();
+    return *google::protobuf::Arena::CreateMessage<IGN_T>(&arena);
+  }
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__MESSAGE_RECYCLING_HPP_
@@ -0,0 +1,178 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__SERVICE_FACTORY_HPP_
+#define ROS1_IGN_BRIDGE__SERVICE_FACTORY_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <ignition/transport/Node.hh>
+
+// include ROS 1
+#include <ros/callback_queue_interface.h>
+#include <ros/ros.h>
+
+#include "ros1_ign_bridge/convert_decl.hpp"
+#include "ros1_ign_bridge/service_factory_interface.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Callback queue entry running an arbitrary function.
+class FunctionCallback : public ros::CallbackInterface
+{
+public:
+  explicit FunctionCallback(const std::function<void()> & function)
+  : function_(function)
+  {}
+
+  CallResult
+  call()
+  {
+    function_();
+    return Success;
+  }
+
+private:
+  std::function<void()> function_;
+};
+
+template<typename ROS1_T, typename IGN_REQ_T, typename IGN_REP_T>
+class ServiceFactory : public ServiceFactoryInterface
+{
+public:
+  ServiceFactory(
+    const std::string & ros1_type_name,
+    const std::string & ign_request_type_name,
+    const std::string & ign_reply_type_name)
+  : ros1_type_name_(ros1_type_name),
+    ign_request_type_name_(ign_request_type_name),
+    ign_reply_type_name_(ign_reply_type_name)
+  {}
+
+  ros::ServiceServer
+  create_ros1_server(
+    ros::NodeHandle node,
+    std::shared_ptr<ignition::transport::Node> ign_node,
+    const std::string & ros1_service_name,
+    const std::string & ign_service_name,
+    unsigned int timeout_ms)
+  {
+    boost::function<bool(typename ROS1_T::Request &,
+                         typename ROS1_T::Response &)> callback =
+      [ign_node, ign_service_name, timeout_ms](
+        typename ROS1_T::Request & ros1_req,
+        typename ROS1_T::Response & ros1_res)
+      {
+        IGN_REQ_T ign_req;
+        convert_1_to_ign(ros1_req, ign_req);
+
+        IGN_REP_T ign_rep;
+        bool result = false;
+        if (!ign_node->Request(
+              ign_service_name, ign_req, timeout_ms, ign_rep, result))
+        {
+          std::cerr << "Timeout calling Ignition service ["
+                    << ign_service_name << "]" << std::endl;
+          return false;
+        }
+        if (!result)
+          return false;
+
+        convert_ign_to_1(ign_rep, ros1_res);
+        return true;
+      };
+    return node.advertiseService(ros1_service_name, callback);
+  }
+
+  bool
+  create_ign_server(
+    std::shared_ptr<ignition::transport::Node> ign_node,
+    ros::NodeHandle node,
+    const std::string & ign_service_name,
+    const std::string & ros1_service_name,
+    unsigned int timeout_ms)
+  {
+    ros::ServiceClient client =
+      node.serviceClient<ROS1_T>(ros1_service_name);
+    ros::CallbackQueueInterface * queue = node.getCallbackQueue();
+
+    // Ignition runs service callbacks on its reception thread, which also
+    // delivers all the subscriptions of the process, and expects the reply
+    // when the callback returns. The ROS 1 call is handed to the worker
+    // queue and only waited for up to the timeout, and while a call that
+    // timed out is still running the next requests fail right away instead
+    // of stalling the thread again. They are reported once per such call.
+    auto busy = std::make_shared<std::atomic<bool>>(false);
+    auto reported = std::make_shared<std::atomic<bool>>(false);
+    std::function<bool(const IGN_REQ_T &, IGN_REP_T &)> callback =
+      [client, queue, ros1_service_name, timeout_ms, busy, reported](
+        const IGN_REQ_T & ign_req, IGN_REP_T & ign_rep)
+      {
+        if (busy->exchange(true))
+        {
+          if (!reported->exchange(true))
+          {
+            std::cerr << "ROS 1 service [" << ros1_service_name
+                      << "] is still busy with a call that timed out, "
+                      << "failing the requests until it returns"
+                      << std::endl;
+          }
+          return false;
+        }
+
+        auto srv = std::make_shared<ROS1_T>();
+        convert_ign_to_1(ign_req, srv->request);
+
+        auto promise = std::make_shared<std::promise<bool>>();
+        std::future<bool> future = promise->get_future();
+        queue->addCallback(ros::CallbackInterfacePtr(new FunctionCallback(
+          [client, srv, promise, busy, reported]() mutable
+          {
+            const bool success = client.call(*srv);
+            reported->store(false);
+            busy->store(false);
+            promise->set_value(success);
+          })));
+
+        if (future.wait_for(std::chrono::milliseconds(timeout_ms)) !=
+            std::future_status::ready)
+        {
+          std::cerr << "Timeout calling ROS 1 service ["
+                    << ros1_service_name << "]" << std::endl;
+          return false;
+        }
+        if (!future.get())
+          return false;
+
+        convert_1_to_ign(srv->response, ign_rep);
+        return true;
+      };
+    return ign_node->Advertise(ign_service_name, callback);
+  }
+
+  std::string ros1_type_name_;
+  std::string ign_request_type_name_;
+  std::string ign_reply_type_name_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__SERVICE_FACTORY_HPP_
@@ -0,0 +1,61 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef  ROS1_IGN_BRIDGE__SERVICE_FACTORY_INTERFACE_HPP_
+#define  ROS1_IGN_BRIDGE__SERVICE_FACTORY_INTERFACE_HPP_
+
+#include <memory>
+#include <string>
+
+// include ROS 1
+#include <ros/node_handle.h>
+#include <ros/service_server.h>
+
+// include Ignition Transport
+#include <ignition/transport/Node.hh>
+
+namespace ros1_ign_bridge
+{
+
+class ServiceFactoryInterface
+{
+public:
+  /// \brief Offer an Ignition service to ROS 1 clients. Requests are handled
+  /// by the callback queue of the node handle.
+  virtual
+  ros::ServiceServer
+  create_ros1_server(
+    ros::NodeHandle node,
+    std::shared_ptr<ignition::transport::Node> ign_node,
+    const std::string & ros1_service_name,
+    const std::string & ign_service_name,
+    unsigned int timeout_ms) = 0;
+
+  /// \brief Offer a ROS 1 service to Ignition clients. The ROS 1 calls run on
+  /// the callback queue of the node handle, while the Ignition reception
+  /// thread, and with it every Ignition subscription, waits up to timeout_ms
+  /// for their reply.
+  virtual
+  bool
+  create_ign_server(
+    std::shared_ptr<ignition::transport::Node> ign_node,
+    ros::NodeHandle node,
+    const std::string & ign_service_name,
+    const std::string & ros1_service_name,
+    unsigned int timeout_ms) = 0;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__SERVICE_FACTORY_INTERFACE_HPP_
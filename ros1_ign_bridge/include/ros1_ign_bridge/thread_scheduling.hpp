@@ -0,0 +1,50 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__THREAD_SCHEDULING_HPP_
+#define ROS1_IGN_BRIDGE__THREAD_SCHEDULING_HPP_
+
+#include <pthread.h>
+
+#include <string>
+#include <vector>
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Run a thread with the SCHED_FIFO policy and restrict it to some
+/// CPUs.
+/// \param[in] thread The thread, e.g. pthread_self().
+/// \param[in] priority SCHED_FIFO priority between 1 and 99, 0 to keep the
+/// current policy.
+/// \param[in] cpus CPUs the thread may run on, empty to keep the current
+/// affinity.
+/// \param[out] error What failed, e.g. a missing rtprio limit.
+/// \return False if a setting could not be applied. The other one is still
+/// applied.
+bool
+set_thread_scheduling(
+  pthread_t thread,
+  int priority,
+  const std::vector<int> & cpus,
+  std::string & error);
+
+/// \brief Describe the scheduling actually in effect for a thread, e.g.
+/// "SCHED_FIFO priority 50, CPUs 2-3".
+std::string
+describe_thread_scheduling(pthread_t thread);
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__THREAD_SCHEDULING_HPP_
@@ -0,0 +1,89 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__TOPIC_PATTERN_HPP_
+#define ROS1_IGN_BRIDGE__TOPIC_PATTERN_HPP_
+
+#include <bitset>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace ros1_ign_bridge
+{
+
+/// \brief Topic name pattern, compiled once and matched against many names.
+///
+/// A pattern is either a glob or, with a "re:" prefix, an ECMAScript regular
+/// expression that must match the whole name. In globs:
+///
+///   *      any characters but "/", i.e. within one level of the name
+///   **     any characters, across levels
+///   ?      one character but "/"
+///   [a-z]  one character of a set, [!a-z] one character outside of it
+///   \x     x itself
+///
+/// e.g. "/model/*/pose" or "re:/model/robot_[0-9]+/(pose|odometry)".
+class TopicPattern
+{
+public:
+  /// \brief Whether a topic name is a pattern rather than a plain name.
+  static
+  bool
+  is_pattern(const std::string & topic_name);
+
+  /// \throws std::runtime_error if the pattern is malformed.
+  explicit TopicPattern(const std::string & pattern);
+
+  /// \brief Whether a topic name matches the whole pattern.
+  bool
+  matches(const std::string & topic_name) const;
+
+  /// \brief The pattern as given.
+  const std::string &
+  pattern() const;
+
+private:
+  struct Token
+  {
+    enum Kind { LITERAL, ONE, SET, STAR, STAR_STAR };
+
+    Kind kind;
+
+    /// \brief Text of a LITERAL.
+    std::string text;
+
+    /// \brief Characters of a SET.
+    std::bitset<256> chars;
+  };
+
+  bool
+  match_from(const std::string & name, size_t token, size_t pos) const;
+
+  std::string pattern_;
+
+  /// \brief Compiled glob, empty for regular expressions.
+  std::vector<Token> tokens_;
+
+  /// \brief Literal start of the names that can match, to reject most
+  /// names with a single comparison.
+  std::string prefix_;
+
+  std::unique_ptr<std::regex> regex_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__TOPIC_PATTERN_HPP_
@@ -0,0 +1,175 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS1_IGN_BRIDGE__TRACE_HPP_
+#define ROS1_IGN_BRIDGE__TRACE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ros1_ign_bridge/bridge_stats.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief One completed span of a message going through a bridge.
+struct TraceEvent
+{
+  /// \brief Stage name, must be a string literal.
+  const char * stage;
+
+  /// \brief Label of the bridge, as returned by Tracer::intern().
+  uint32_t label;
+
+  int64_t start_ns;
+  int64_t duration_ns;
+};
+
+/// \brief Records the stages of the bridge callbacks and writes them to a
+/// Chrome trace file, which can be opened in chrome://tracing or Perfetto.
+///
+/// Each thread writes its events into its own single producer ring buffer,
+/// so recording takes no locks. A background thread drains the buffers into
+/// the file. Events are dropped, and counted, if a buffer fills up faster
+/// than it is drained.
+///
+/// The instrumentation is compiled in when ROS1_IGN_BRIDGE_ENABLE_TRACE is
+/// defined. While tracing is stopped it costs one relaxed atomic load per
+/// span.
+class Tracer
+{
+public:
+  /// \brief Process wide tracer.
+  static Tracer &
+  instance();
+
+  /// \brief Whether the instrumentation was compiled in.
+  static constexpr bool
+  compiled_in()
+  {
+#ifdef ROS1_IGN_BRIDGE_ENABLE_TRACE
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /// \brief Whether spans should be recorded right now.
+  static bool
+  enabled()
+  {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /// \brief Start writing events to a file, replacing its contents.
+  /// \return False if the file can't be opened or tracing already runs.
+  bool
+  start(const std::string & path);
+
+  /// \brief Stop recording and write the remaining events.
+  void
+  stop();
+
+  /// \brief Number for a bridge name, to be stored by the bridge and passed
+  /// to record(). Names are kept until the process exits so that events of
+  /// removed bridges can still be written.
+  uint32_t
+  intern(const std::string & name);
+
+  /// \brief Queue an event from the calling thread.
+  void
+  record(const TraceEvent & event);
+
+  ~Tracer();
+
+private:
+  struct ThreadBuffer;
+
+  Tracer() = default;
+
+  ThreadBuffer &
+  thread_buffer();
+
+  void
+  run();
+
+  void
+  flush();
+
+  static std::atomic<bool> enabled_;
+
+  /// \brief Protects everything below.
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+  std::vector<std::string> labels_;
+  std::unordered_map<std::string, uint32_t> label_ids_;
+  std::ofstream file_;
+  bool first_event_ = true;
+  uint64_t dropped_ = 0;
+
+  std::atomic<bool> running_{false};
+  std::thread writer_;
+};
+
+/// \brief Records the time between its construction and destruction as a
+/// span, if tracing was enabled when it was constructed.
+class TraceScope
+{
+public:
+  TraceScope(const char * stage, uint32_t label)
+  : stage_(stage),
+    label_(label),
+    start_ns_(Tracer::enabled() ? steady_now_ns() : 0)
+  {}
+
+  ~TraceScope()
+  {
+    if (start_ns_ == 0)
+      return;
+    Tracer::instance().record(
+      TraceEvent{stage_, label_, start_ns_, steady_now_ns() - start_ns_});
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope & operator=(const TraceScope &) = delete;
+
+private:
+  const char * stage_;
+  uint32_t label_;
+  int64_t start_ns_;
+};
+
+}  // namespace ros1_ign_bridge
+
+#define ROS1_IGN_BRIDGE_TRACE_CONCAT_(a, b) a ## b
+#define ROS1_IGN_BRIDGE_TRACE_CONCAT(a, b) ROS1_IGN_BRIDGE_TRACE_CONCAT_(a, b)
+
+/// \brief Trace the rest of the enclosing block as a stage of a bridge.
+#ifdef ROS1_IGN_BRIDGE_ENABLE_TRACE
+# define ROS1_IGN_BRIDGE_TRACE_SCOPE(stage, label) \
+  ::ros1_ign_bridge::TraceScope ROS1_IGN_BRIDGE_TRACE_CONCAT( \
+    ros1_ign_bridge_trace_scope_, __LINE__)(stage, label)
+#else
+# define ROS1_IGN_BRIDGE_TRACE_SCOPE(stage, label) \
+  do { (void)sizeof(label); } while (0)
+#endif
+
+#endif  // ROS1_IGN_BRIDGE__TRACE_HPP_
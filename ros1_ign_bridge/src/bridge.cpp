@@ -0,0 +1,385 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "ros1_ign_bridge/bridge.hpp"
+#include "ros1_ign_bridge/generic_factory.hpp"
+#include "ros1_ign_bridge/ign_publish_queue.hpp"
+#include "ros1_ign_bridge/trace.hpp"
+
+namespace ros1_ign_bridge
+{
+
+namespace
+{
+
+/// \brief Forward an Ignition topic to ROS 1, through the dispatcher if
+/// there is one.
+/// \return False if the subscription failed.
+bool
+subscribe_ign(
+  std::shared_ptr<FactoryInterface> factory,
+  std::shared_ptr<IgnDispatcher> dispatcher,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const std::string & ign_topic_name,
+  const std::string & ign_type_name,
+  size_t subscriber_queue_size,
+  ros::Publisher ros1_pub,
+  std::shared_ptr<BridgeState> state,
+  size_t ign_msgs_per_sec)
+{
+  if (dispatcher)
+  {
+    return dispatcher->subscribe(ign_topic_name, ign_type_name, factory,
+      ros1_pub, state, subscriber_queue_size, ign_msgs_per_sec);
+  }
+  factory->create_ign_subscriber(ign_node, ign_topic_name,
+    subscriber_queue_size, ros1_pub, state, ign_msgs_per_sec);
+  return true;
+}
+
+/// \brief Rate limit of the ROS 1 to Ignition direction. A publisher
+/// throttled by Ignition Transport discards the excess silently, after it was
+/// converted and counted as forwarded, so the bridge applies the tighter of
+/// max_rate and ign_msgs_per_sec itself and counts the excess as dropped.
+double
+ros_to_ign_rate(double max_rate, size_t ign_msgs_per_sec)
+{
+  if (ign_msgs_per_sec == 0)
+    return max_rate;
+  const double ign_rate = static_cast<double>(ign_msgs_per_sec);
+  return max_rate > 0.0 ? std::min(max_rate, ign_rate) : ign_rate;
+}
+
+Bridge1toIgnHandles
+create_bridge_from_ros_to_ign(
+  std::shared_ptr<FactoryInterface> factory,
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const std::string & ros1_topic_name,
+  size_t subscriber_queue_size,
+  const std::string & ign_topic_name,
+  size_t publisher_queue_size,
+  double max_rate,
+  bool lazy,
+  QueuePolicy queue_policy,
+  size_t ign_msgs_per_sec)
+{
+  auto ign_pub = factory->create_ign_publisher(
+    ign_node, ign_topic_name, publisher_queue_size);
+
+  auto state = std::make_shared<BridgeState>(
+    ros_to_ign_rate(max_rate, ign_msgs_per_sec), lazy);
+  state->trace_label = Tracer::instance().intern(
+    ros1_topic_name + " -> " + ign_topic_name);
+  if (queue_policy != QueuePolicy::SYNCHRONOUS)
+  {
+    state->publish_queue = std::make_shared<IgnPublishQueue>(
+      ign_pub, publisher_queue_size, queue_policy, state->stats,
+      state->trace_label);
+  }
+  auto ros1_sub = factory->create_ros1_subscriber(
+    ros1_node, ros1_topic_name, subscriber_queue_size, ign_pub, state);
+
+  Bridge1toIgnHandles handles;
+  handles.ros1_subscriber = ros1_sub;
+  handles.ign_publisher = ign_pub;
+  handles.state = state;
+  return handles;
+}
+
+BridgeIgnto1Handles
+create_bridge_from_ign_to_ros(
+  std::shared_ptr<FactoryInterface> factory,
+  std::shared_ptr<IgnDispatcher> dispatcher,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  ros::NodeHandle ros1_node,
+  const std::string & ign_type_name,
+  const std::string & ign_topic_name,
+  size_t subscriber_queue_size,
+  const std::string & ros1_topic_name,
+  size_t publisher_queue_size,
+  double max_rate,
+  bool lazy,
+  size_t ign_msgs_per_sec)
+{
+  auto state = std::make_shared<BridgeState>(max_rate, lazy);
+  state->trace_label = Tracer::instance().intern(
+    ign_topic_name + " -> " + ros1_topic_name);
+
+  BridgeIgnto1Handles handles;
+  if (dispatcher)
+    handles.ign_dispatcher = dispatcher;
+  else
+    handles.ign_subscriber = ign_node;
+  handles.ign_topic_name = ign_topic_name;
+  handles.state = state;
+
+  if (!lazy)
+  {
+    handles.ros1_publisher = factory->create_ros1_publisher(
+      ros1_node, ros1_topic_name, publisher_queue_size);
+    if (!subscribe_ign(factory, dispatcher, ign_node, ign_topic_name,
+          ign_type_name, subscriber_queue_size, handles.ros1_publisher, state,
+          ign_msgs_per_sec))
+    {
+      handles.ros1_publisher.shutdown();
+      throw std::runtime_error(
+        "Failed to subscribe to Ignition topic [" + ign_topic_name + "]");
+    }
+    return handles;
+  }
+
+  // Lazy bridges only hold the Ignition subscription while somebody other
+  // than this node listens to the ROS 1 topic. The publisher handle is not
+  // known until advertise() returns, so the callbacks share it through a
+  // pointer that is filled in below.
+  auto ros1_pub = std::make_shared<ros::Publisher>();
+  auto connect_cb =
+    [factory, dispatcher, ign_node, ign_type_name, ign_topic_name,
+     subscriber_queue_size, ros1_pub, state, ign_msgs_per_sec](
+      const ros::SingleSubscriberPublisher & pub)
+    {
+      if (pub.getSubscriberName() == ros::this_node::getName())
+        return;
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->num_remote_subscribers++ == 0 &&
+          !subscribe_ign(factory, dispatcher, ign_node, ign_topic_name,
+            ign_type_name, subscriber_queue_size, *ros1_pub, state,
+            ign_msgs_per_sec))
+      {
+        std::cerr << "Failed to subscribe to Ignition topic ["
+                  << ign_topic_name << "]" << std::endl;
+      }
+    };
+  auto disconnect_cb = [dispatcher, ign_node, ign_topic_name, state](
+      const ros::SingleSubscriberPublisher & pub)
+    {
+      if (pub.getSubscriberName() == ros::this_node::getName())
+        return;
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->num_remote_subscribers > 0 &&
+          --state->num_remote_subscribers == 0)
+      {
+        if (dispatcher)
+          dispatcher->unsubscribe(ign_topic_name);
+        else
+          ign_node->Unsubscribe(ign_topic_name);
+      }
+    };
+
+  {
+    // Hold the lock so that an early connection waits for the handle.
+    std::lock_guard<std::mutex> lock(state->mutex);
+    *ros1_pub = factory->create_ros1_publisher(
+      ros1_node, ros1_topic_name, publisher_queue_size,
+      connect_cb, disconnect_cb);
+  }
+
+  handles.ros1_publisher = *ros1_pub;
+  return handles;
+}
+
+}  // namespace
+
+Bridge1toIgnHandles
+create_bridge_from_ros_to_ign(
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const std::string & ros1_type_name,
+  const std::string & ros1_topic_name,
+  size_t subscriber_queue_size,
+  const std::string & ign_type_name,
+  const std::string & ign_topic_name,
+  size_t publisher_queue_size,
+  double max_rate,
+  bool lazy,
+  QueuePolicy queue_policy)
+{
+  return create_bridge_from_ros_to_ign(
+    get_factory(ros1_type_name, ign_type_name), ros1_node, ign_node,
+    ros1_topic_name, subscriber_queue_size,
+    ign_topic_name, publisher_queue_size, max_rate, lazy, queue_policy, 0);
+}
+
+BridgeIgnto1Handles
+create_bridge_from_ign_to_ros(
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  ros::NodeHandle ros1_node,
+  const std::string & ign_type_name,
+  const std::string & ign_topic_name,
+  size_t subscriber_queue_size,
+  const std::string & ros1_type_name,
+  const std::string & ros1_topic_name,
+  size_t publisher_queue_size,
+  double max_rate,
+  bool lazy)
+{
+  return create_bridge_from_ign_to_ros(
+    get_factory(ros1_type_name, ign_type_name), nullptr, ign_node, ros1_node,
+    ign_type_name, ign_topic_name, subscriber_queue_size,
+    ros1_topic_name, publisher_queue_size, max_rate, lazy, 0);
+}
+
+BridgeHandles
+create_bridge(
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const BridgeConfig & config,
+  std::shared_ptr<IgnDispatcher> ign_dispatcher)
+{
+  if (ign_dispatcher)
+    ign_node = ign_dispatcher->node(config.ign_topic_name);
+
+  // Generic plans are compiled once and shared by both directions.
+  std::shared_ptr<FactoryInterface> factory;
+  if (config.generic)
+  {
+    factory = std::make_shared<GenericFactory>(
+      config.ros1_type_name, config.ign_type_name, config.field_mappings);
+  }
+  else
+  {
+    factory = get_factory(config.ros1_type_name, config.ign_type_name);
+  }
+
+  BridgeHandles handles;
+  if (config.direction != BridgeDirection::IGN_TO_ROS)
+  {
+    handles.bridge1toIgn = create_bridge_from_ros_to_ign(
+      factory, ros1_node, ign_node,
+      config.ros1_topic_name, config.subscriber_queue_size,
+      config.ign_topic_name, config.publisher_queue_size,
+      config.max_rate, config.lazy, config.queue_policy,
+      config.ign_msgs_per_sec);
+  }
+  if (config.direction != BridgeDirection::ROS_TO_IGN)
+  {
+    handles.bridgeIgnto1 = create_bridge_from_ign_to_ros(
+      factory, ign_dispatcher, ign_node, ros1_node,
+      config.ign_type_name, config.ign_topic_name,
+      config.subscriber_queue_size,
+      config.ros1_topic_name, config.publisher_queue_size,
+      config.max_rate, config.lazy, config.ign_msgs_per_sec);
+  }
+  return handles;
+}
+
+BridgeHandles
+create_bidirectional_bridge(
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const std::string & ros1_type_name,
+  const std::string & ign_type_name,
+  const std::string & topic_name,
+  size_t queue_size)
+{
+  BridgeHandles handles;
+  handles.bridge1toIgn = create_bridge_from_ros_to_ign(
+   ros1_node, ign_node,
+   ros1_type_name, topic_name, queue_size, ign_type_name, topic_name, queue_size);
+  handles.bridgeIgnto1 = create_bridge_from_ign_to_ros(
+    ign_node, ros1_node,
+    ign_type_name, topic_name, queue_size, ros1_type_name, topic_name, queue_size);
+  return handles;
+}
+
+ServiceBridgeHandles
+create_service_bridge(
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const ServiceBridgeConfig & config)
+{
+  auto factory = get_service_factory(config.ros1_type_name,
+    config.ign_request_type_name, config.ign_reply_type_name);
+  const unsigned int timeout_ms =
+    static_cast<unsigned int>(config.timeout * 1000.0);
+
+  ServiceBridgeHandles handles;
+  if (config.direction == BridgeDirection::IGN_TO_ROS)
+  {
+    const unsigned int reply_timeout_ms = config.ign_reply_timeout > 0.0 ?
+      std::min(timeout_ms,
+        static_cast<unsigned int>(config.ign_reply_timeout * 1000.0)) :
+      timeout_ms;
+    if (!factory->create_ign_server(ign_node, ros1_node,
+          config.ign_service_name, config.ros1_service_name,
+          reply_timeout_ms))
+    {
+      throw std::runtime_error(
+        "Failed to advertise Ignition service [" + config.ign_service_name +
+        "]");
+    }
+    handles.ign_server = ign_node;
+    handles.ign_service_name = config.ign_service_name;
+  }
+  else
+  {
+    handles.ros1_server = factory->create_ros1_server(ros1_node, ign_node,
+      config.ros1_service_name, config.ign_service_name, timeout_ms);
+  }
+  return handles;
+}
+
+void
+shutdown_bridge(Bridge1toIgnHandles & handles)
+{
+  handles.ros1_subscriber.shutdown();
+  if (handles.state && handles.state->publish_queue)
+    handles.state->publish_queue->stop();
+  handles.ign_publisher = ignition::transport::Node::Publisher();
+}
+
+void
+shutdown_bridge(BridgeIgnto1Handles & handles)
+{
+  // The publisher goes first so that lazy bridges don't resubscribe.
+  handles.ros1_publisher.shutdown();
+  if (handles.ign_dispatcher)
+  {
+    handles.ign_dispatcher->unsubscribe(handles.ign_topic_name);
+    handles.ign_dispatcher.reset();
+  }
+  if (handles.ign_subscriber)
+  {
+    handles.ign_subscriber->Unsubscribe(handles.ign_topic_name);
+    handles.ign_subscriber.reset();
+  }
+}
+
+void
+shutdown_bridge(BridgeHandles & handles)
+{
+  shutdown_bridge(handles.bridge1toIgn);
+  shutdown_bridge(handles.bridgeIgnto1);
+}
+
+void
+shutdown_bridge(ServiceBridgeHandles & handles)
+{
+  handles.ros1_server.shutdown();
+  if (handles.ign_server)
+  {
+    handles.ign_server->UnadvertiseSrv(handles.ign_service_name);
+    handles.ign_server.reset();
+  }
+}
+
+}  // namespace ros1_ign_bridge
@@ -0,0 +1,778 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sched.h>
+
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ros1_ign_bridge/bridge_config.hpp"
+#include "ros1_ign_bridge/builtin_interfaces_factories.hpp"
+#include "ros1_ign_bridge/generic_factory.hpp"
+#include "ros1_ign_bridge/topic_pattern.hpp"
+
+namespace ros1_ign_bridge
+{
+
+namespace
+{
+
+// Reads an optional string member. Returns false on a type mismatch.
+bool get_string(
+  XmlRpc::XmlRpcValue & value, const std::string & key, std::string & out)
+{
+  if (!value.hasMember(key))
+    return true;
+  if (value[key].getType() != XmlRpc::XmlRpcValue::TypeString)
+    return false;
+  out = static_cast<std::string>(value[key]);
+  return true;
+}
+
+// Reads an optional non-negative integer member.
+bool get_size(
+  XmlRpc::XmlRpcValue & value, const std::string & key, size_t & out)
+{
+  if (!value.hasMember(key))
+    return true;
+  if (value[key].getType() != XmlRpc::XmlRpcValue::TypeInt)
+    return false;
+  const int number = static_cast<int>(value[key]);
+  if (number < 0)
+    return false;
+  out = static_cast<size_t>(number);
+  return true;
+}
+
+// Reads an optional number member, accepting both integers and doubles.
+bool get_double(
+  XmlRpc::XmlRpcValue & value, const std::string & key, double & out)
+{
+  if (!value.hasMember(key))
+    return true;
+  if (value[key].getType() == XmlRpc::XmlRpcValue::TypeInt)
+  {
+    out = static_cast<int>(value[key]);
+    return true;
+  }
+  if (value[key].getType() != XmlRpc::XmlRpcValue::TypeDouble)
+    return false;
+  out = static_cast<double>(value[key]);
+  return true;
+}
+
+// Reads an optional boolean member.
+bool get_bool(
+  XmlRpc::XmlRpcValue & value, const std::string & key, bool & out)
+{
+  if (!value.hasMember(key))
+    return true;
+  if (value[key].getType() != XmlRpc::XmlRpcValue::TypeBoolean)
+    return false;
+  out = static_cast<bool>(value[key]);
+  return true;
+}
+
+// Reads the optional "priority" and "cpus" members of a group of threads.
+bool parse_scheduling(
+  XmlRpc::XmlRpcValue & value,
+  int & priority,
+  std::vector<int> & cpus,
+  std::string & error)
+{
+  size_t number = static_cast<size_t>(priority);
+  if (!get_size(value, "priority", number) || number > 99)
+  {
+    error = "[priority] must be an integer between 0 and 99";
+    return false;
+  }
+  priority = static_cast<int>(number);
+
+  if (!value.hasMember("cpus"))
+    return true;
+  XmlRpc::XmlRpcValue & list = value["cpus"];
+  if (list.getType() != XmlRpc::XmlRpcValue::TypeArray || list.size() == 0)
+  {
+    error = "[cpus] must be a non-empty list of CPU numbers";
+    return false;
+  }
+  cpus.clear();
+  for (int i = 0; i < list.size(); ++i)
+  {
+    if (list[i].getType() != XmlRpc::XmlRpcValue::TypeInt ||
+        static_cast<int>(list[i]) < 0 ||
+        static_cast<int>(list[i]) >= CPU_SETSIZE)
+    {
+      error = "[cpus] must be a non-empty list of CPU numbers";
+      return false;
+    }
+    cpus.push_back(static_cast<int>(list[i]));
+  }
+  return true;
+}
+
+bool parse_direction(const std::string & name, BridgeDirection & direction)
+{
+  if (name == "bidirectional")
+    direction = BridgeDirection::BIDIRECTIONAL;
+  else if (name == "ros_to_ign")
+    direction = BridgeDirection::ROS_TO_IGN;
+  else if (name == "ign_to_ros")
+    direction = BridgeDirection::IGN_TO_ROS;
+  else
+    return false;
+  return true;
+}
+
+bool parse_queue_policy(const std::string & name, QueuePolicy & policy)
+{
+  if (name == "synchronous")
+    policy = QueuePolicy::SYNCHRONOUS;
+  else if (name == "drop_oldest")
+    policy = QueuePolicy::DROP_OLDEST;
+  else if (name == "drop_newest")
+    policy = QueuePolicy::DROP_NEWEST;
+  else
+    return false;
+  return true;
+}
+
+bool parse_executor(
+  XmlRpc::XmlRpcValue & value,
+  ExecutorConfig & executor,
+  std::string & error)
+{
+  if (value.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+  {
+    error = "expected a struct";
+    return false;
+  }
+  if (!get_string(value, "name", executor.name) || executor.name.empty())
+  {
+    error = "missing or invalid [name]";
+    return false;
+  }
+  size_t threads = executor.threads;
+  if (!get_size(value, "threads", threads) || threads == 0)
+  {
+    error = "[threads] must be a positive integer";
+    return false;
+  }
+  executor.threads = static_cast<unsigned int>(threads);
+  return parse_scheduling(value, executor.priority, executor.cpus, error);
+}
+
+bool parse_bridge(
+  XmlRpc::XmlRpcValue & value,
+  BridgeConfig & bridge,
+  std::string & error)
+{
+  if (value.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+  {
+    error = "expected a struct";
+    return false;
+  }
+
+  std::string topic_name;
+  if (!get_string(value, "topic", topic_name))
+  {
+    error = "[topic] must be a string";
+    return false;
+  }
+  bridge.ros1_topic_name = topic_name;
+  bridge.ign_topic_name = topic_name;
+  if (!get_string(value, "ros_topic", bridge.ros1_topic_name) ||
+      !get_string(value, "ign_topic", bridge.ign_topic_name))
+  {
+    error = "[ros_topic] and [ign_topic] must be strings";
+    return false;
+  }
+  if (bridge.ros1_topic_name.empty() || bridge.ign_topic_name.empty())
+  {
+    error = "missing [topic], or [ros_topic] and [ign_topic]";
+    return false;
+  }
+
+  if (!get_string(value, "ros_type", bridge.ros1_type_name) ||
+      !get_string(value, "ign_type", bridge.ign_type_name) ||
+      bridge.ros1_type_name.empty() || bridge.ign_type_name.empty())
+  {
+    error = "missing or invalid [ros_type] or [ign_type]";
+    return false;
+  }
+
+  std::string direction = "bidirectional";
+  if (!get_string(value, "direction", direction) ||
+      !parse_direction(direction, bridge.direction))
+  {
+    error = "[direction] must be one of bidirectional, ros_to_ign or "
+            "ign_to_ros";
+    return false;
+  }
+
+  size_t queue_size = bridge.subscriber_queue_size;
+  if (!get_size(value, "queue_size", queue_size))
+  {
+    error = "[queue_size] must be a non-negative integer";
+    return false;
+  }
+  bridge.subscriber_queue_size = queue_size;
+  bridge.publisher_queue_size = queue_size;
+  if (!get_size(value, "subscriber_queue_size", bridge.subscriber_queue_size) ||
+      !get_size(value, "publisher_queue_size", bridge.publisher_queue_size))
+  {
+    error = "[subscriber_queue_size] and [publisher_queue_size] must be "
+            "non-negative integers";
+    return false;
+  }
+
+  if (!get_double(value, "max_rate", bridge.max_rate) || bridge.max_rate < 0.0)
+  {
+    error = "[max_rate] must be a non-negative number";
+    return false;
+  }
+
+  if (!get_size(value, "ign_msgs_per_sec", bridge.ign_msgs_per_sec))
+  {
+    error = "[ign_msgs_per_sec] must be a non-negative integer";
+    return false;
+  }
+
+  std::string queue_policy = to_string(bridge.queue_policy);
+  if (!get_string(value, "queue_policy", queue_policy) ||
+      !parse_queue_policy(queue_policy, bridge.queue_policy))
+  {
+    error = "[queue_policy] must be one of synchronous, drop_oldest or "
+      "drop_newest";
+    return false;
+  }
+
+  if (!get_bool(value, "lazy", bridge.lazy))
+  {
+    error = "[lazy] must be a boolean";
+    return false;
+  }
+
+  if (!get_string(value, "executor", bridge.executor))
+  {
+    error = "[executor] must be a string";
+    return false;
+  }
+
+  // The process name ends up in the name of a node.
+  if (!get_string(value, "process", bridge.process) ||
+      bridge.process.find_first_not_of(
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_") !=
+        std::string::npos)
+  {
+    error = "[process] must be a string of letters, digits and underscores";
+    return false;
+  }
+
+  if (!get_double(value, "expected_rate", bridge.expected_rate) ||
+      bridge.expected_rate < 0.0)
+  {
+    error = "[expected_rate] must be a non-negative number";
+    return false;
+  }
+
+  if (!get_double(value, "rate_tolerance", bridge.rate_tolerance) ||
+      bridge.rate_tolerance < 0.0 || bridge.rate_tolerance >= 1.0)
+  {
+    error = "[rate_tolerance] must be between 0 and 1";
+    return false;
+  }
+
+  if (!get_double(value, "max_age", bridge.max_age) || bridge.max_age < 0.0)
+  {
+    error = "[max_age] must be a non-negative number";
+    return false;
+  }
+
+  if (!get_bool(value, "generic", bridge.generic))
+  {
+    error = "[generic] must be a boolean";
+    return false;
+  }
+
+  if (value.hasMember("fields"))
+  {
+    XmlRpc::XmlRpcValue & fields = value["fields"];
+    if (fields.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+    {
+      error = "[fields] must be a struct";
+      return false;
+    }
+    for (auto & field : fields)
+    {
+      if (field.second.getType() != XmlRpc::XmlRpcValue::TypeString)
+      {
+        error = "[fields/" + field.first + "] must be a string";
+        return false;
+      }
+      bridge.field_mappings[field.first] =
+        static_cast<std::string>(field.second);
+    }
+    if (!bridge.generic)
+    {
+      error = "[fields] requires [generic]";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool parse_clock(
+  XmlRpc::XmlRpcValue & value,
+  ClockBridgeConfig & clock,
+  std::string & error)
+{
+  if (value.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+  {
+    error = "expected a struct";
+    return false;
+  }
+  clock.enabled = true;
+
+  if (!get_string(value, "ign_topic", clock.ign_topic_name) ||
+      clock.ign_topic_name.empty())
+  {
+    error = "[ign_topic] must be a non-empty string";
+    return false;
+  }
+  if (!get_string(value, "ros_topic", clock.ros1_topic_name) ||
+      clock.ros1_topic_name.empty())
+  {
+    error = "[ros_topic] must be a non-empty string";
+    return false;
+  }
+  if (!get_double(value, "max_rate", clock.max_rate) || clock.max_rate < 0.0)
+  {
+    error = "[max_rate] must be a non-negative number";
+    return false;
+  }
+  return parse_scheduling(value, clock.priority, clock.cpus, error);
+}
+
+bool parse_service(
+  XmlRpc::XmlRpcValue & value,
+  ServiceBridgeConfig & service,
+  std::string & error)
+{
+  if (value.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+  {
+    error = "expected a struct";
+    return false;
+  }
+
+  std::string service_name;
+  if (!get_string(value, "service", service_name))
+  {
+    error = "[service] must be a string";
+    return false;
+  }
+  service.ros1_service_name = service_name;
+  service.ign_service_name = service_name;
+  if (!get_string(value, "ros_service", service.ros1_service_name) ||
+      !get_string(value, "ign_service", service.ign_service_name))
+  {
+    error = "[ros_service] and [ign_service] must be strings";
+    return false;
+  }
+  if (service.ros1_service_name.empty() || service.ign_service_name.empty())
+  {
+    error = "missing [service], or [ros_service] and [ign_service]";
+    return false;
+  }
+
+  if (!get_string(value, "ros_type", service.ros1_type_name) ||
+      !get_string(value, "ign_request_type", service.ign_request_type_name) ||
+      !get_string(value, "ign_reply_type", service.ign_reply_type_name) ||
+      service.ros1_type_name.empty() ||
+      service.ign_request_type_name.empty() ||
+      service.ign_reply_type_name.empty())
+  {
+    error = "missing or invalid [ros_type], [ign_request_type] or "
+            "[ign_reply_type]";
+    return false;
+  }
+
+  std::string direction = "ros_to_ign";
+  if (!get_string(value, "direction", direction) ||
+      !parse_direction(direction, service.direction) ||
+      service.direction == BridgeDirection::BIDIRECTIONAL)
+  {
+    error = "[direction] must be ros_to_ign or ign_to_ros";
+    return false;
+  }
+
+  if (!get_double(value, "timeout", service.timeout) || service.timeout <= 0.0)
+  {
+    error = "[timeout] must be a positive number";
+    return false;
+  }
+
+  if (!get_double(value, "ign_reply_timeout", service.ign_reply_timeout) ||
+      service.ign_reply_timeout < 0.0)
+  {
+    error = "[ign_reply_timeout] must be a non-negative number";
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+bool
+parse_bridge_spec(const std::string & spec, BridgeConfig & config)
+{
+  const std::string delim = "@";
+  std::string arg = spec;
+
+  auto delimPos = arg.find(delim);
+  if (delimPos == std::string::npos || delimPos == 0)
+    return false;
+  std::string topic_name = arg.substr(0, delimPos);
+  arg.erase(0, delimPos + delim.size());
+
+  // The second delimiter selects the direction.
+  delimPos = arg.find_first_of("@[]");
+  if (delimPos == std::string::npos || delimPos == 0)
+    return false;
+  BridgeDirection direction = BridgeDirection::BIDIRECTIONAL;
+  if (arg[delimPos] == '[')
+    direction = BridgeDirection::IGN_TO_ROS;
+  else if (arg[delimPos] == ']')
+    direction = BridgeDirection::ROS_TO_IGN;
+  std::string ros1_type_name = arg.substr(0, delimPos);
+  arg.erase(0, delimPos + 1);
+
+  delimPos = arg.find_first_of("@[]");
+  if (delimPos != std::string::npos || arg.empty())
+    return false;
+
+  config = BridgeConfig();
+  config.ros1_topic_name = topic_name;
+  config.ign_topic_name = topic_name;
+  config.ros1_type_name = ros1_type_name;
+  config.ign_type_name = arg;
+  config.direction = direction;
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::string
+to_bridge_spec(const BridgeConfig & config)
+{
+  std::string delim = "@";
+  if (config.direction == BridgeDirection::IGN_TO_ROS)
+    delim = "[";
+  else if (config.direction == BridgeDirection::ROS_TO_IGN)
+    delim = "]";
+
+  std::string spec = config.ros1_topic_name;
+  if (config.ign_topic_name != config.ros1_topic_name)
+    spec += " (" + config.ign_topic_name + ")";
+  return spec + "@" + config.ros1_type_name + delim + config.ign_type_name;
+}
+
+//////////////////////////////////////////////////
+bool
+parse_bridge_config(
+  XmlRpc::XmlRpcValue & value,
+  BridgeSetConfig & config,
+  std::vector<std::string> & errors)
+{
+  const size_t num_errors = errors.size();
+
+  if (value.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+  {
+    errors.push_back("The bridge configuration must be a struct");
+    return false;
+  }
+
+  if (value.hasMember("executors"))
+  {
+    XmlRpc::XmlRpcValue & executors = value["executors"];
+    if (executors.getType() != XmlRpc::XmlRpcValue::TypeArray)
+    {
+      errors.push_back("[executors] must be a list");
+    }
+    else
+    {
+      for (int i = 0; i < executors.size(); ++i)
+      {
+        ExecutorConfig executor;
+        std::string error;
+        if (parse_executor(executors[i], executor, error))
+          config.executors.push_back(executor);
+        else
+          errors.push_back("executors[" + std::to_string(i) + "]: " + error);
+      }
+    }
+  }
+
+  if (value.hasMember("bridges"))
+  {
+    XmlRpc::XmlRpcValue & bridges = value["bridges"];
+    if (bridges.getType() != XmlRpc::XmlRpcValue::TypeArray)
+    {
+      errors.push_back("[bridges] must be a list");
+    }
+    else
+    {
+      for (int i = 0; i < bridges.size(); ++i)
+      {
+        BridgeConfig bridge;
+        std::string error;
+        if (parse_bridge(bridges[i], bridge, error))
+          config.bridges.push_back(bridge);
+        else
+          errors.push_back("bridges[" + std::to_string(i) + "]: " + error);
+      }
+    }
+  }
+
+  if (value.hasMember("services"))
+  {
+    XmlRpc::XmlRpcValue & services = value["services"];
+    if (services.getType() != XmlRpc::XmlRpcValue::TypeArray)
+    {
+      errors.push_back("[services] must be a list");
+    }
+    else
+    {
+      for (int i = 0; i < services.size(); ++i)
+      {
+        ServiceBridgeConfig service;
+        std::string error;
+        if (parse_service(services[i], service, error))
+          config.services.push_back(service);
+        else
+          errors.push_back("services[" + std::to_string(i) + "]: " + error);
+      }
+    }
+  }
+
+  if (value.hasMember("clock"))
+  {
+    std::string error;
+    if (!parse_clock(value["clock"], config.clock, error))
+      errors.push_back("clock: " + error);
+  }
+
+  size_t service_threads = config.service_threads;
+  if (!get_size(value, "service_threads", service_threads) ||
+      service_threads == 0)
+  {
+    errors.push_back("[service_threads] must be a positive integer");
+  }
+  config.service_threads = static_cast<unsigned int>(service_threads);
+
+  size_t startup_threads = config.startup_threads;
+  if (!get_size(value, "startup_threads", startup_threads) ||
+      startup_threads == 0)
+  {
+    errors.push_back("[startup_threads] must be a positive integer");
+  }
+  config.startup_threads = static_cast<unsigned int>(startup_threads);
+
+  size_t ign_nodes = config.ign_nodes;
+  if (!get_size(value, "ign_nodes", ign_nodes) || ign_nodes == 0)
+    errors.push_back("[ign_nodes] must be a positive integer");
+  config.ign_nodes = static_cast<unsigned int>(ign_nodes);
+
+  size_t ign_threads = config.ign_threads;
+  if (!get_size(value, "ign_threads", ign_threads))
+    errors.push_back("[ign_threads] must be a non-negative integer");
+  config.ign_threads = static_cast<unsigned int>(ign_threads);
+
+  if (!get_double(value, "discovery_period", config.discovery_period) ||
+      config.discovery_period <= 0.0)
+  {
+    errors.push_back("[discovery_period] must be a positive number");
+  }
+
+  return errors.size() == num_errors;
+}
+
+//////////////////////////////////////////////////
+bool
+validate_bridge_config(
+  const BridgeSetConfig & config,
+  std::vector<std::string> & errors)
+{
+  const size_t num_errors = errors.size();
+
+  std::set<std::string> executors;
+  for (const auto & executor : config.executors)
+  {
+    if (!executors.insert(executor.name).second)
+      errors.push_back("Executor [" + executor.name + "] defined twice");
+  }
+
+  // A topic may only have one bridge publishing into it on each side.
+  std::set<std::string> ros1_published;
+  std::set<std::string> ign_published;
+  std::set<std::string> ign_subscribed;
+  if (config.clock.enabled)
+  {
+    ros1_published.insert(config.clock.ros1_topic_name);
+    ign_subscribed.insert(config.clock.ign_topic_name);
+  }
+  for (const auto & bridge : config.bridges)
+  {
+    std::ostringstream name;
+    name << "Bridge [" << bridge.ros1_topic_name << "@" << bridge.ros1_type_name
+         << "@" << bridge.ign_type_name << "]";
+
+    if (bridge.generic)
+    {
+      try
+      {
+        GenericFactory(bridge.ros1_type_name, bridge.ign_type_name,
+                       bridge.field_mappings);
+      }
+      catch (std::runtime_error & e)
+      {
+        errors.push_back(name.str() + ": " + e.what());
+      }
+    }
+    else
+    {
+      try
+      {
+        get_factory(bridge.ros1_type_name, bridge.ign_type_name);
+      }
+      catch (std::runtime_error &)
+      {
+        errors.push_back(name.str() + ": no conversion between the types");
+      }
+    }
+
+    if (!bridge.executor.empty() && executors.count(bridge.executor) == 0)
+    {
+      errors.push_back(
+        name.str() + ": unknown executor [" + bridge.executor + "]");
+    }
+
+    if (TopicPattern::is_pattern(bridge.ros1_topic_name) ||
+        TopicPattern::is_pattern(bridge.ign_topic_name))
+    {
+      if (bridge.ros1_topic_name != bridge.ign_topic_name)
+      {
+        errors.push_back(
+          name.str() + ": a topic pattern must be the same on both sides");
+      }
+      try
+      {
+        TopicPattern pattern(bridge.ros1_topic_name);
+      }
+      catch (std::runtime_error & e)
+      {
+        errors.push_back(name.str() + ": " + e.what());
+      }
+    }
+
+    if (bridge.direction != BridgeDirection::ROS_TO_IGN &&
+        !ros1_published.insert(bridge.ros1_topic_name).second)
+    {
+      errors.push_back(name.str() + ": ROS 1 topic [" +
+        bridge.ros1_topic_name + "] is already bridged from Ignition");
+    }
+    if (bridge.direction != BridgeDirection::ROS_TO_IGN &&
+        !ign_subscribed.insert(bridge.ign_topic_name).second)
+    {
+      errors.push_back(name.str() + ": Ignition topic [" +
+        bridge.ign_topic_name + "] is already bridged to ROS 1");
+    }
+    if (bridge.direction != BridgeDirection::IGN_TO_ROS &&
+        !ign_published.insert(bridge.ign_topic_name).second)
+    {
+      errors.push_back(name.str() + ": Ignition topic [" +
+        bridge.ign_topic_name + "] is already bridged from ROS 1");
+    }
+  }
+
+  // A service may only be offered once on each side.
+  std::set<std::string> ros1_servers;
+  std::set<std::string> ign_servers;
+  for (const auto & service : config.services)
+  {
+    const std::string name = "Service [" + service.ros1_service_name + "]";
+
+    try
+    {
+      get_service_factory(service.ros1_type_name,
+        service.ign_request_type_name, service.ign_reply_type_name);
+    }
+    catch (std::runtime_error &)
+    {
+      errors.push_back(name + ": no conversion between the types");
+    }
+
+    if (service.direction == BridgeDirection::ROS_TO_IGN &&
+        !ros1_servers.insert(service.ros1_service_name).second)
+    {
+      errors.push_back(name + ": already offered to ROS 1");
+    }
+    if (service.direction == BridgeDirection::IGN_TO_ROS &&
+        !ign_servers.insert(service.ign_service_name).second)
+    {
+      errors.push_back(name + ": already offered to Ignition");
+    }
+  }
+
+  return errors.size() == num_errors;
+}
+
+//////////////////////////////////////////////////
+std::string
+to_string(BridgeDirection direction)
+{
+  switch (direction)
+  {
+    case BridgeDirection::ROS_TO_IGN:
+      return "ros_to_ign";
+    case BridgeDirection::IGN_TO_ROS:
+      return "ign_to_ros";
+    case BridgeDirection::BIDIRECTIONAL:
+    default:
+      return "bidirectional";
+  }
+}
+
+//////////////////////////////////////////////////
+std::string
+to_string(QueuePolicy policy)
+{
+  switch (policy)
+  {
+    case QueuePolicy::DROP_OLDEST:
+      return "drop_oldest";
+    case QueuePolicy::DROP_NEWEST:
+      return "drop_newest";
+    case QueuePolicy::SYNCHRONOUS:
+    default:
+      return "synchronous";
+  }
+}
+
+}  // namespace ros1_ign_bridge
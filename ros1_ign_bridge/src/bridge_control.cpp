@@ -0,0 +1,152 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "ros1_ign_bridge/bridge_control.hpp"
+
+namespace ros1_ign_bridge
+{
+
+//////////////////////////////////////////////////
+BridgeControl::BridgeControl(
+  BridgeRegistry & registry,
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const std::string & ign_prefix)
+: registry_(registry)
+{
+  add_server_ = ros1_node.advertiseService(
+    "add_bridge", &BridgeControl::on_ros1_add, this);
+  remove_server_ = ros1_node.advertiseService(
+    "remove_bridge", &BridgeControl::on_ros1_remove, this);
+  list_server_ = ros1_node.advertiseService(
+    "list_bridges", &BridgeControl::on_ros1_list, this);
+
+  std::function<bool(const ignition::msgs::StringMsg &,
+                     ignition::msgs::Boolean &)> add_cb =
+    [this](const ignition::msgs::StringMsg & req,
+           ignition::msgs::Boolean & rep)
+    {
+      std::string message;
+      rep.set_data(this->add(req.data(), 0, 0.0, false, message));
+      return true;
+    };
+  std::function<bool(const ignition::msgs::StringMsg &,
+                     ignition::msgs::Boolean &)> remove_cb =
+    [this](const ignition::msgs::StringMsg & req,
+           ignition::msgs::Boolean & rep)
+    {
+      std::string message;
+      rep.set_data(this->remove(req.data(), message));
+      return true;
+    };
+  std::function<bool(const ignition::msgs::Empty &,
+                     ignition::msgs::StringMsg_V &)> list_cb =
+    [this](const ignition::msgs::Empty &,
+           ignition::msgs::StringMsg_V & rep)
+    {
+      for (const auto & config : this->registry_.list())
+        rep.add_data(to_bridge_spec(config));
+      return true;
+    };
+
+  if (!ign_node->Advertise(ign_prefix + "/add_bridge", add_cb) ||
+      !ign_node->Advertise(ign_prefix + "/remove_bridge", remove_cb) ||
+      !ign_node->Advertise(ign_prefix + "/list_bridges", list_cb))
+  {
+    std::cerr << "Failed to advertise the Ignition bridge control services "
+              << "under [" << ign_prefix << "]" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeControl::add(
+  const std::string & spec, size_t queue_size, double max_rate,
+  bool lazy, std::string & message)
+{
+  BridgeConfig config;
+  if (!parse_bridge_spec(spec, config))
+  {
+    message = "Invalid bridge specification [" + spec + "]";
+    return false;
+  }
+  if (queue_size > 0)
+  {
+    config.subscriber_queue_size = queue_size;
+    config.publisher_queue_size = queue_size;
+  }
+  config.max_rate = max_rate;
+  config.lazy = lazy;
+
+  if (!registry_.add(config, message))
+  {
+    std::cerr << "Failed to add bridge [" << spec << "]: " << message
+              << std::endl;
+    return false;
+  }
+  message = "Added bridge [" + to_bridge_spec(config) + "]";
+  std::cout << message << std::endl;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeControl::remove(const std::string & topic_name, std::string & message)
+{
+  const size_t removed = registry_.remove(topic_name);
+  if (removed == 0)
+  {
+    message = "No bridge uses topic [" + topic_name + "]";
+    return false;
+  }
+  message = "Removed " + std::to_string(removed) + " bridge(s) using topic [" +
+    topic_name + "]";
+  std::cout << message << std::endl;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeControl::on_ros1_add(AddBridge::Request & req, AddBridge::Response & res)
+{
+  res.success = add(req.spec, req.queue_size, req.max_rate, req.lazy,
+                    res.message);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeControl::on_ros1_remove(
+  RemoveBridge::Request & req, RemoveBridge::Response & res)
+{
+  res.success = remove(req.topic, res.message);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeControl::on_ros1_list(
+  ListBridges::Request &, ListBridges::Response & res)
+{
+  for (const auto & config : registry_.list())
+    res.bridges.push_back(to_bridge_spec(config));
+  return true;
+}
+
+}  // namespace ros1_ign_bridge
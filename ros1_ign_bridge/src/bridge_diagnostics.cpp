@@ -0,0 +1,87 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <diagnostic_msgs/DiagnosticStatus.h>
+
+#include "ros1_ign_bridge/bridge_diagnostics.hpp"
+
+namespace ros1_ign_bridge
+{
+
+//////////////////////////////////////////////////
+void
+check_bridge_health(
+  const BridgeConfig & config,
+  const TopicStatistics & stats,
+  double rate,
+  diagnostic_updater::DiagnosticStatusWrapper & status)
+{
+  using diagnostic_msgs::DiagnosticStatus;
+
+  status.name = "ros1_ign_bridge: " + stats.ros_topic + " (" +
+    stats.direction + ")";
+  status.summary(DiagnosticStatus::OK, "OK");
+
+  if (config.expected_rate > 0.0)
+  {
+    const double min_rate =
+      config.expected_rate * (1.0 - config.rate_tolerance);
+    const double max_rate =
+      config.expected_rate * (1.0 + config.rate_tolerance);
+    if (rate == 0.0 && config.lazy)
+    {
+      status.mergeSummary(DiagnosticStatus::OK, "Idle");
+    }
+    else if (rate == 0.0)
+    {
+      status.mergeSummary(DiagnosticStatus::ERROR, "No messages forwarded");
+    }
+    else if (rate < min_rate)
+    {
+      status.mergeSummary(DiagnosticStatus::WARN, "Rate too low");
+    }
+    else if (rate > max_rate)
+    {
+      status.mergeSummary(DiagnosticStatus::WARN, "Rate too high");
+    }
+    status.add("Expected rate", config.expected_rate);
+    if (config.direction == BridgeDirection::BIDIRECTIONAL)
+      status.add("Rate out, both directions", rate);
+  }
+
+  if (config.max_age > 0.0)
+  {
+    if (stats.latency_p99 > config.max_age)
+    {
+      status.mergeSummary(DiagnosticStatus::ERROR, "Conversion lag too high");
+    }
+    else if (stats.latency_max > config.max_age)
+    {
+      status.mergeSummary(DiagnosticStatus::WARN, "Conversion lag spikes");
+    }
+    status.add("Max age", config.max_age);
+  }
+
+  status.add("ROS topic", stats.ros_topic);
+  status.add("Ignition topic", stats.ign_topic);
+  status.add("Rate in", stats.rate_in);
+  status.add("Rate out", stats.rate_out);
+  status.add("Latency p50", stats.latency_p50);
+  status.add("Latency p99", stats.latency_p99);
+  status.add("Latency max", stats.latency_max);
+  status.add("Messages dropped", stats.dropped);
+  status.add("Messages dropped by queues", stats.queue_dropped);
+}
+
+}  // namespace ros1_ign_bridge
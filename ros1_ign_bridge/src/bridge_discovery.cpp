@@ -0,0 +1,259 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// include ROS 1
+#include <ros/master.h>
+
+#include "ros1_ign_bridge/bridge_discovery.hpp"
+
+namespace ros1_ign_bridge
+{
+
+//////////////////////////////////////////////////
+BridgeDiscovery::BridgeDiscovery(
+  BridgeRegistry & registry,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  double period)
+: registry_(registry),
+  ign_node_(ign_node),
+  period_(period)
+{
+  thread_ = std::thread(&BridgeDiscovery::run, this);
+}
+
+//////////////////////////////////////////////////
+BridgeDiscovery::~BridgeDiscovery()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  thread_.join();
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeDiscovery::add_pattern(const BridgeConfig & config, std::string & error)
+{
+  if (config.ros1_topic_name != config.ign_topic_name)
+  {
+    error = "A topic pattern must be the same on both sides";
+    return false;
+  }
+
+  std::shared_ptr<const Pattern> pattern;
+  try
+  {
+    pattern.reset(new Pattern{config, TopicPattern(config.ros1_topic_name)});
+  }
+  catch (std::runtime_error & e)
+  {
+    error = e.what();
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    patterns_.push_back(pattern);
+    rescan_ = true;
+  }
+  wake_.notify_all();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void
+BridgeDiscovery::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_)
+  {
+    // A new pattern applies to the topics already seen too.
+    if (rescan_)
+    {
+      rescan_ = false;
+      ros1_topics_.clear();
+      ign_topics_.clear();
+    }
+    const auto patterns = patterns_;
+
+    // Listing and bridging wait on the ROS master and on Ignition
+    // discovery, without blocking add_pattern().
+    lock.unlock();
+    if (!patterns.empty())
+      scan(patterns);
+    lock.lock();
+
+    wake_.wait_for(lock, period_, [this] { return stop_ || rescan_; });
+  }
+}
+
+//////////////////////////////////////////////////
+void
+BridgeDiscovery::scan(
+  const std::vector<std::shared_ptr<const Pattern>> & patterns)
+{
+  // ROS 1: the master reports the types along with the names.
+  ros::master::V_TopicInfo infos;
+  if (ros::master::getTopics(infos))
+  {
+    std::sort(infos.begin(), infos.end(),
+      [](const ros::master::TopicInfo & a, const ros::master::TopicInfo & b)
+      {
+        return a.name < b.name;
+      });
+
+    std::vector<std::string> topics;
+    topics.reserve(infos.size());
+    auto known = ros1_topics_.cbegin();
+    for (const auto & info : infos)
+    {
+      while (known != ros1_topics_.cend() && *known < info.name)
+        ++known;
+      if (known == ros1_topics_.cend() || *known != info.name)
+        bridge_topic(patterns, info.name, info.datatype, true);
+      topics.push_back(info.name);
+    }
+    ros1_topics_.swap(topics);
+  }
+
+  // Ignition: the type is only asked for the names that match a pattern.
+  std::vector<std::string> topics;
+  if (!ign_node_->TopicList(topics))
+    return;
+  std::sort(topics.begin(), topics.end());
+
+  std::vector<std::string> added;
+  std::set_difference(
+    topics.begin(), topics.end(),
+    ign_topics_.begin(), ign_topics_.end(),
+    std::back_inserter(added));
+  const auto added_end = added.size();
+  for (const auto & topic : ign_pending_)
+  {
+    if (std::binary_search(topics.begin(), topics.end(), topic) &&
+        !std::binary_search(added.begin(), added.begin() + added_end, topic))
+    {
+      added.push_back(topic);
+    }
+  }
+  ign_topics_.swap(topics);
+  ign_pending_.clear();
+  forget_gone_topics();
+
+  for (const auto & topic : added)
+  {
+    if (bridged_.count(topic) > 0)
+      continue;
+
+    const bool matched = std::any_of(patterns.begin(), patterns.end(),
+      [&topic](const std::shared_ptr<const Pattern> & pattern)
+      {
+        return pattern->config.direction != BridgeDirection::ROS_TO_IGN &&
+          pattern->matcher.matches(topic);
+      });
+    if (!matched)
+      continue;
+
+    // The topic may be listed before its publisher is known.
+    std::vector<ignition::transport::MessagePublisher> publishers;
+    if (!ign_node_->TopicInfo(topic, publishers) || publishers.empty())
+    {
+      ign_pending_.push_back(topic);
+      continue;
+    }
+    bridge_topic(patterns, topic, publishers.front().MsgTypeName(), false);
+  }
+}
+
+//////////////////////////////////////////////////
+void
+BridgeDiscovery::forget_gone_topics()
+{
+  for (auto it = bridged_.begin(); it != bridged_.end();)
+  {
+    // Binary searches first: the registry is only asked about the few
+    // topics that went away.
+    if (std::binary_search(ros1_topics_.begin(), ros1_topics_.end(), *it) ||
+        std::binary_search(ign_topics_.begin(), ign_topics_.end(), *it) ||
+        registry_.contains(*it))
+    {
+      ++it;
+    }
+    else
+    {
+      it = bridged_.erase(it);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void
+BridgeDiscovery::bridge_topic(
+  const std::vector<std::shared_ptr<const Pattern>> & patterns,
+  const std::string & topic_name,
+  const std::string & type_name,
+  bool ros1_side)
+{
+  if (bridged_.count(topic_name) > 0)
+    return;
+
+  for (const auto & pattern : patterns)
+  {
+    const BridgeConfig & config = pattern->config;
+    const BridgeDirection excluded = ros1_side ?
+      BridgeDirection::IGN_TO_ROS : BridgeDirection::ROS_TO_IGN;
+    const std::string & pattern_type = ros1_side ?
+      config.ros1_type_name : config.ign_type_name;
+    if (config.direction == excluded || type_name != pattern_type ||
+        !pattern->matcher.matches(topic_name))
+    {
+      continue;
+    }
+
+    // Tried once: a failure, e.g. a topic already bridged explicitly, is
+    // not retried at every scan.
+    bridged_.insert(topic_name);
+
+    BridgeConfig bridge = config;
+    bridge.ros1_topic_name = topic_name;
+    bridge.ign_topic_name = topic_name;
+    std::string error;
+    if (registry_.add(bridge, error))
+    {
+      std::cout << "Bridging discovered topic [" << topic_name
+                << "] matching [" << pattern->matcher.pattern() << "]"
+                << std::endl;
+    }
+    else
+    {
+      std::cerr << "Failed to bridge discovered topic [" << topic_name
+                << "] matching [" << pattern->matcher.pattern() << "]: "
+                << error << std::endl;
+    }
+    return;
+  }
+}
+
+}  // namespace ros1_ign_bridge
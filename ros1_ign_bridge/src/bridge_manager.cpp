@@ -0,0 +1,446 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ros/callback_queue.h>
+#include <ros/ros.h>
+
+#include "ros1_ign_bridge/bridge_manager.hpp"
+#include "ros1_ign_bridge/thread_scheduling.hpp"
+#include "ros1_ign_bridge/topic_pattern.hpp"
+
+namespace ros1_ign_bridge
+{
+
+/// \brief A callback queue and the threads that service it.
+///
+/// ros::AsyncSpinner doesn't expose its threads, so the executor runs its own
+/// to be able to set their scheduling.
+class BridgeManager::Executor
+{
+public:
+  explicit Executor(const ExecutorConfig & config)
+  : config_(config)
+  {}
+
+  ~Executor()
+  {
+    stop();
+  }
+
+  /// \brief Start the threads, apply the scheduling of the configuration
+  /// and report the one achieved.
+  void
+  start()
+  {
+    if (running_)
+      return;
+    running_ = true;
+    for (unsigned int i = 0; i < config_.threads; ++i)
+    {
+      threads_.emplace_back(&Executor::run, this);
+      pthread_t handle = threads_.back().native_handle();
+
+      std::string error;
+      if (!set_thread_scheduling(
+          handle, config_.priority, config_.cpus, error))
+      {
+        std::cerr << "Failed to set the scheduling of executor ["
+                  << config_.name << "]: " << error << std::endl;
+      }
+      std::cout << "Executor [" << config_.name << "] thread " << i << ": "
+                << describe_thread_scheduling(handle) << std::endl;
+    }
+  }
+
+  void
+  stop()
+  {
+    running_ = false;
+    for (auto & thread : threads_)
+      thread.join();
+    threads_.clear();
+  }
+
+  ros::CallbackQueue queue;
+
+private:
+  void
+  run()
+  {
+    while (running_ && ros::ok())
+      queue.callAvailable(ros::WallDuration(0.1));
+  }
+
+  ExecutorConfig config_;
+  std::atomic<bool> running_{false};
+  std::vector<std::thread> threads_;
+};
+
+//////////////////////////////////////////////////
+BridgeManager::BridgeManager(
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node)
+: ros1_node_(ros1_node),
+  ign_node_(ign_node ? ign_node :
+            std::make_shared<ignition::transport::Node>()),
+  service_node_(ros1_node)
+{
+  registry_.reset(new BridgeRegistry(ros1_node_, ign_node_));
+}
+
+//////////////////////////////////////////////////
+BridgeManager::~BridgeManager()
+{
+  stop();
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeManager::configure(
+  const BridgeSetConfig & config, std::vector<std::string> & errors)
+{
+  // The bridges may use the executors that already exist.
+  BridgeSetConfig full_config = config;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto & executor : executors_)
+    {
+      ExecutorConfig existing;
+      existing.name = executor.first;
+      full_config.executors.push_back(existing);
+    }
+  }
+  if (!validate_bridge_config(full_config, errors))
+    return false;
+
+  const size_t num_errors = errors.size();
+  set_service_threads(config.service_threads);
+  set_discovery_period(config.discovery_period);
+  if (config.ign_threads > 0)
+    set_ign_dispatch(config.ign_nodes, config.ign_threads);
+
+  for (const auto & executor : config.executors)
+    add_executor(executor);
+
+  // Creating a bridge mostly waits on the ROS master and on Ignition
+  // discovery, so several are created at once. The errors are reported in
+  // the order of the configuration.
+  std::vector<std::string> bridge_errors(config.bridges.size());
+  std::atomic<size_t> next_bridge{0};
+  auto create_bridges = [&]()
+    {
+      size_t i;
+      while ((i = next_bridge++) < config.bridges.size())
+      {
+        const auto & bridge = config.bridges[i];
+        std::string error;
+        if (!add_bridge(bridge, error))
+        {
+          bridge_errors[i] = "Failed to create a bridge for topic [" +
+            bridge.ros1_topic_name + "] with ROS1 type [" +
+            bridge.ros1_type_name + "] and Ignition Transport type [" +
+            bridge.ign_type_name + "]: " + error;
+        }
+      }
+    };
+
+  const size_t num_threads = std::min<size_t>(
+    std::max(config.startup_threads, 1u), config.bridges.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i)
+    threads.emplace_back(create_bridges);
+  create_bridges();
+  for (auto & thread : threads)
+    thread.join();
+
+  for (auto & error : bridge_errors)
+  {
+    if (!error.empty())
+      errors.push_back(error);
+  }
+
+  for (const auto & service : config.services)
+  {
+    std::string error;
+    if (!add_service_bridge(service, error))
+    {
+      errors.push_back("Failed to create a bridge for service [" +
+        service.ros1_service_name + "] with ROS1 type [" +
+        service.ros1_type_name + "]: " + error);
+    }
+  }
+
+  if (config.clock.enabled)
+  {
+    std::string error;
+    if (!set_clock_bridge(config.clock, error))
+      errors.push_back("Failed to create the clock bridge: " + error);
+  }
+
+  return errors.size() == num_errors;
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeManager::add_executor(const ExecutorConfig & config)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopped_ || executors_.count(config.name))
+    return false;
+
+  auto & executor = executors_[config.name];
+  executor.reset(new Executor(config));
+  registry_->add_executor(config.name, &executor->queue);
+  if (started_)
+    executor->start();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeManager::add_bridge(const BridgeConfig & config, std::string & error)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_)
+    {
+      error = "The bridge manager is stopped";
+      return false;
+    }
+
+    if (TopicPattern::is_pattern(config.ros1_topic_name) ||
+        TopicPattern::is_pattern(config.ign_topic_name))
+    {
+      if (!discovery_)
+      {
+        discovery_.reset(
+          new BridgeDiscovery(*registry_, ign_node_, discovery_period_));
+      }
+      return discovery_->add_pattern(config, error);
+    }
+  }
+  return registry_->add(config, error);
+}
+
+//////////////////////////////////////////////////
+size_t
+BridgeManager::remove_bridge(const std::string & topic_name)
+{
+  return registry_->remove(topic_name);
+}
+
+//////////////////////////////////////////////////
+std::vector<BridgeConfig>
+BridgeManager::list_bridges() const
+{
+  return registry_->list();
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeManager::add_service_bridge(
+  const ServiceBridgeConfig & config, std::string & error)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopped_)
+  {
+    error = "The bridge manager is stopped";
+    return false;
+  }
+
+  // Service calls may block for up to their timeout, so they run on their
+  // own pool of threads instead of delaying the topics.
+  if (!service_executor_)
+  {
+    ExecutorConfig service_config;
+    service_config.name = "services";
+    service_config.threads = service_threads_;
+    service_executor_.reset(new Executor(service_config));
+    service_node_.setCallbackQueue(&service_executor_->queue);
+    if (started_)
+      service_executor_->start();
+  }
+
+  try
+  {
+    service_bridges_.push_back(
+      create_service_bridge(service_node_, ign_node_, config));
+  }
+  catch (std::runtime_error & e)
+  {
+    error = e.what();
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void
+BridgeManager::set_service_threads(unsigned int threads)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (threads > 0)
+    service_threads_ = threads;
+}
+
+//////////////////////////////////////////////////
+void
+BridgeManager::set_discovery_period(double period)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (period > 0.0)
+    discovery_period_ = period;
+}
+
+//////////////////////////////////////////////////
+void
+BridgeManager::set_ign_dispatch(unsigned int nodes, unsigned int threads)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopped_ || ign_dispatcher_)
+    return;
+  ign_dispatcher_ = std::make_shared<IgnDispatcher>(nodes, threads);
+  registry_->set_ign_dispatcher(ign_dispatcher_);
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeManager::set_clock_bridge(
+  const ClockBridgeConfig & config, std::string & error)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopped_)
+  {
+    error = "The bridge manager is stopped";
+    return false;
+  }
+
+  // The old bridge must be gone before the topics are advertised again.
+  clock_bridge_.reset();
+  clock_bridge_.reset(new ClockBridge(ros1_node_, ign_node_, config));
+  return true;
+}
+
+//////////////////////////////////////////////////
+void
+BridgeManager::enable_control(
+  ros::NodeHandle node, const std::string & ign_prefix)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!stopped_)
+    control_.reset(new BridgeControl(*registry_, node, ign_node_, ign_prefix));
+}
+
+//////////////////////////////////////////////////
+void
+BridgeManager::enable_statistics(
+  ros::NodeHandle node,
+  const std::string & ign_topic,
+  double period,
+  bool diagnostics)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!stopped_)
+  {
+    stats_publisher_.reset(new BridgeStatsPublisher(
+      *registry_, node, ign_node_, ign_topic, period, diagnostics));
+  }
+}
+
+//////////////////////////////////////////////////
+void
+BridgeManager::start()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (started_ || stopped_)
+    return;
+  started_ = true;
+
+  for (auto & executor : executors_)
+    executor.second->start();
+  if (service_executor_)
+    service_executor_->start();
+}
+
+//////////////////////////////////////////////////
+void
+BridgeManager::stop()
+{
+  // Taken out under the lock and torn down without it: the executor threads
+  // may be running a callback, e.g. of the control services, that waits for
+  // the lock, so joining them while holding it could deadlock.
+  std::unique_ptr<BridgeDiscovery> discovery;
+  std::unique_ptr<BridgeStatsPublisher> stats_publisher;
+  std::unique_ptr<BridgeControl> control;
+  std::unique_ptr<ClockBridge> clock_bridge;
+  std::map<std::string, std::unique_ptr<Executor>> executors;
+  std::unique_ptr<Executor> service_executor;
+  std::vector<ServiceBridgeHandles> service_bridges;
+  std::shared_ptr<IgnDispatcher> ign_dispatcher;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_)
+      return;
+    stopped_ = true;
+
+    discovery.swap(discovery_);
+    stats_publisher.swap(stats_publisher_);
+    control.swap(control_);
+    clock_bridge.swap(clock_bridge_);
+    executors.swap(executors_);
+    service_executor.swap(service_executor_);
+    service_bridges.swap(service_bridges_);
+    ign_dispatcher.swap(ign_dispatcher_);
+  }
+
+  // Stop everything that calls into the registry, then the threads, so that
+  // no callback runs while the bridges go away.
+  discovery.reset();
+  stats_publisher.reset();
+  control.reset();
+  clock_bridge.reset();
+  for (auto & executor : executors)
+    executor.second->stop();
+  if (service_executor)
+    service_executor->stop();
+
+  for (auto & service_bridge : service_bridges)
+    shutdown_bridge(service_bridge);
+  service_bridges.clear();
+  registry_->clear();
+  if (ign_dispatcher)
+    ign_dispatcher->stop();
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<ignition::transport::Node>
+BridgeManager::ign_node() const
+{
+  return ign_node_;
+}
+
+}  // namespace ros1_ign_bridge
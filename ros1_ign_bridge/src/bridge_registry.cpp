@@ -0,0 +1,326 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ros1_ign_bridge/bridge_registry.hpp"
+#include "ros1_ign_bridge/topic_pattern.hpp"
+
+namespace ros1_ign_bridge
+{
+
+//////////////////////////////////////////////////
+BridgeRegistry::BridgeRegistry(
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node)
+: ros1_node_(ros1_node),
+  ign_node_(ign_node)
+{
+}
+
+//////////////////////////////////////////////////
+BridgeRegistry::~BridgeRegistry()
+{
+  for (auto & entry : entries_)
+  {
+    if (entry.ready)
+      shutdown_bridge(entry.handles);
+  }
+}
+
+//////////////////////////////////////////////////
+void
+BridgeRegistry::add_executor(
+  const std::string & name, ros::CallbackQueueInterface * queue)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  executors_[name] = queue;
+}
+
+//////////////////////////////////////////////////
+void
+BridgeRegistry::set_ign_dispatcher(std::shared_ptr<IgnDispatcher> dispatcher)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  ign_dispatcher_ = dispatcher;
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeRegistry::add(const BridgeConfig & config, std::string & error)
+{
+  // Patterns are expanded by BridgeDiscovery into bridges of real topics.
+  if (TopicPattern::is_pattern(config.ros1_topic_name))
+  {
+    error = "Topic patterns are only accepted by the bridge manager";
+    return false;
+  }
+
+  // Check the types and the executor of the bridge. Compiling a generic
+  // conversion reads message definitions, so the lock is not held.
+  BridgeSetConfig set;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto & executor : executors_)
+    {
+      ExecutorConfig executor_config;
+      executor_config.name = executor.first;
+      set.executors.push_back(executor_config);
+    }
+  }
+  set.bridges.push_back(config);
+
+  std::vector<std::string> errors;
+  if (!validate_bridge_config(set, errors))
+  {
+    error = errors.front();
+    return false;
+  }
+
+  ros::NodeHandle bridge_node(ros1_node_);
+  std::shared_ptr<IgnDispatcher> dispatcher;
+  Entries::iterator entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_)
+    {
+      error = "The bridges are shutting down";
+      return false;
+    }
+    if (!check_topics(config, error))
+      return false;
+
+    // Executors are never removed, the validation found this one.
+    if (!config.executor.empty())
+      bridge_node.setCallbackQueue(executors_.at(config.executor));
+    dispatcher = ign_dispatcher_;
+
+    // Reserve the topics while the handles are created without the lock.
+    entry = entries_.insert(entries_.end(), Entry());
+    entry->config = config;
+    index(entry);
+    ++pending_;
+  }
+
+  BridgeHandles handles;
+  try
+  {
+    handles = create_bridge(bridge_node, ign_node_, config, dispatcher);
+  }
+  catch (std::runtime_error & e)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unindex(*entry);
+    entries_.erase(entry);
+    --pending_;
+    pending_done_.notify_all();
+    error = e.what();
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --pending_;
+    pending_done_.notify_all();
+    if (!closed_)
+    {
+      entry->handles = handles;
+      entry->ready = true;
+      return true;
+    }
+    unindex(*entry);
+    entries_.erase(entry);
+  }
+
+  // clear() ran while the bridge was created.
+  shutdown_bridge(handles);
+  error = "The bridges are shutting down";
+  return false;
+}
+
+//////////////////////////////////////////////////
+size_t
+BridgeRegistry::remove(const std::string & topic_name)
+{
+  Entries removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();)
+    {
+      auto next = std::next(it);
+      if (it->ready && (it->config.ros1_topic_name == topic_name ||
+                        it->config.ign_topic_name == topic_name))
+      {
+        unindex(*it);
+        removed.splice(removed.end(), entries_, it);
+      }
+      it = next;
+    }
+  }
+
+  for (auto & entry : removed)
+    shutdown_bridge(entry.handles);
+  return removed.size();
+}
+
+//////////////////////////////////////////////////
+void
+BridgeRegistry::clear()
+{
+  Entries removed;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    closed_ = true;
+    pending_done_.wait(lock, [this] { return pending_ == 0; });
+    removed.swap(entries_);
+    ros1_publishers_.clear();
+    ign_publishers_.clear();
+    ign_subscribers_.clear();
+  }
+
+  for (auto & entry : removed)
+    shutdown_bridge(entry.handles);
+}
+
+//////////////////////////////////////////////////
+std::vector<BridgeConfig>
+BridgeRegistry::list() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<BridgeConfig> configs;
+  for (const auto & entry : entries_)
+  {
+    if (entry.ready)
+      configs.push_back(entry.config);
+  }
+  return configs;
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeRegistry::contains(const std::string & topic_name) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::any_of(entries_.begin(), entries_.end(),
+    [&topic_name](const Entry & entry)
+    {
+      return entry.config.ros1_topic_name == topic_name ||
+        entry.config.ign_topic_name == topic_name;
+    });
+}
+
+//////////////////////////////////////////////////
+std::vector<BridgeDirectionStats>
+BridgeRegistry::collect_stats()
+{
+  // Keep the states alive while they are read outside the lock.
+  std::vector<std::pair<BridgeDirectionStats, std::shared_ptr<BridgeState>>>
+    states;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto & entry : entries_)
+    {
+      if (!entry.ready)
+        continue;
+
+      BridgeDirectionStats stats;
+      stats.config = entry.config;
+      if (entry.handles.bridge1toIgn.state)
+      {
+        stats.direction = BridgeDirection::ROS_TO_IGN;
+        states.emplace_back(stats, entry.handles.bridge1toIgn.state);
+      }
+      if (entry.handles.bridgeIgnto1.state)
+      {
+        stats.direction = BridgeDirection::IGN_TO_ROS;
+        states.emplace_back(stats, entry.handles.bridgeIgnto1.state);
+      }
+    }
+  }
+
+  std::vector<BridgeDirectionStats> result;
+  result.reserve(states.size());
+  for (auto & state : states)
+  {
+    state.first.stats = state.second->stats.snapshot();
+    result.push_back(state.first);
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeRegistry::check_topics(
+  const BridgeConfig & config, std::string & error) const
+{
+  const bool to_ros1 = config.direction != BridgeDirection::ROS_TO_IGN;
+  const bool to_ign = config.direction != BridgeDirection::IGN_TO_ROS;
+  if (to_ros1 && ros1_publishers_.count(config.ros1_topic_name) > 0)
+  {
+    error = "ROS 1 topic [" + config.ros1_topic_name +
+      "] is already bridged from Ignition";
+    return false;
+  }
+  if (to_ign && ign_publishers_.count(config.ign_topic_name) > 0)
+  {
+    error = "Ignition topic [" + config.ign_topic_name +
+      "] is already bridged from ROS 1";
+    return false;
+  }
+  if (to_ros1 && ign_subscribers_.count(config.ign_topic_name) > 0)
+  {
+    error = "Ignition topic [" + config.ign_topic_name +
+      "] is already bridged to ROS 1";
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void
+BridgeRegistry::index(Entries::iterator entry)
+{
+  const BridgeConfig & config = entry->config;
+  if (config.direction != BridgeDirection::ROS_TO_IGN)
+  {
+    ros1_publishers_[config.ros1_topic_name] = entry;
+    ign_subscribers_[config.ign_topic_name] = entry;
+  }
+  if (config.direction != BridgeDirection::IGN_TO_ROS)
+    ign_publishers_[config.ign_topic_name] = entry;
+}
+
+//////////////////////////////////////////////////
+void
+BridgeRegistry::unindex(const Entry & entry)
+{
+  const BridgeConfig & config = entry.config;
+  if (config.direction != BridgeDirection::ROS_TO_IGN)
+  {
+    ros1_publishers_.erase(config.ros1_topic_name);
+    ign_subscribers_.erase(config.ign_topic_name);
+  }
+  if (config.direction != BridgeDirection::IGN_TO_ROS)
+    ign_publishers_.erase(config.ign_topic_name);
+}
+
+}  // namespace ros1_ign_bridge
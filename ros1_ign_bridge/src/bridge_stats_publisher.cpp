@@ -0,0 +1,202 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include <diagnostic_updater/DiagnosticStatusWrapper.h>
+#include <ignition/msgs.hh>
+
+#include "ros1_ign_bridge/BridgeStatistics.h"
+#include "ros1_ign_bridge/bridge_diagnostics.hpp"
+#include "ros1_ign_bridge/bridge_stats_publisher.hpp"
+
+namespace ros1_ign_bridge
+{
+
+namespace
+{
+
+void
+set_param(ignition::msgs::Param & param, const std::string & key,
+          const std::string & value)
+{
+  auto & any = (*param.mutable_params())[key];
+  any.set_type(ignition::msgs::Any::STRING);
+  any.set_string_value(value);
+}
+
+void
+set_param(ignition::msgs::Param & param, const std::string & key,
+          double value)
+{
+  auto & any = (*param.mutable_params())[key];
+  any.set_type(ignition::msgs::Any::DOUBLE);
+  any.set_double_value(value);
+}
+
+double
+rate(uint64_t current, uint64_t previous, double period)
+{
+  return current >= previous && period > 0.0 ?
+    (current - previous) / period : 0.0;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+BridgeStatsPublisher::BridgeStatsPublisher(
+  BridgeRegistry & registry,
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const std::string & ign_topic,
+  double period,
+  bool diagnostics)
+: registry_(registry),
+  last_report_(ros::WallTime::now())
+{
+  ros1_pub_ = ros1_node.advertise<BridgeStatistics>("statistics", 1);
+  ign_pub_ = ign_node->Advertise<ignition::msgs::Param_V>(ign_topic);
+  if (diagnostics)
+  {
+    diagnostics_pub_ =
+      ros1_node.advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 1);
+  }
+  // Wall time, so that reports keep coming while the simulation is paused.
+  timer_ = ros1_node.createWallTimer(
+    ros::WallDuration(period), &BridgeStatsPublisher::publish, this);
+}
+
+//////////////////////////////////////////////////
+void
+BridgeStatsPublisher::publish(const ros::WallTimerEvent &)
+{
+  const ros::WallTime now = ros::WallTime::now();
+  const double period = (now - last_report_).toSec();
+  last_report_ = now;
+
+  BridgeStatistics ros1_msg;
+  ros1_msg.header.stamp.fromNSec(now.toNSec());
+  ros1_msg.period = period;
+
+  diagnostic_msgs::DiagnosticArray diagnostics_msg;
+  diagnostics_msg.header.stamp = ros::Time::now();
+
+  ignition::msgs::Param_V ign_msg;
+  ign_msg.mutable_header()->mutable_stamp()->set_sec(now.sec);
+  ign_msg.mutable_header()->mutable_stamp()->set_nsec(now.nsec);
+
+  // Rebuilt every time so that removed bridges are forgotten.
+  std::map<std::string, Totals> totals;
+  const auto entries = registry_.collect_stats();
+  std::vector<const BridgeConfig *> configs;
+  std::map<std::string, double> bridge_rates;
+  for (const auto & entry : entries)
+  {
+    const auto & stats = entry.stats;
+    const std::string direction = to_string(entry.direction);
+    const std::string key = entry.config.ros1_topic_name + "|" +
+      entry.config.ign_topic_name + "|" + direction;
+
+    Totals & current = totals[key];
+    current.messages_in = stats.messages_in;
+    current.messages_out = stats.messages_out;
+    current.bytes_in = stats.bytes_in;
+    current.bytes_out = stats.bytes_out;
+    const Totals & previous = previous_[key];
+
+    TopicStatistics topic;
+    topic.ros_topic = entry.config.ros1_topic_name;
+    topic.ign_topic = entry.config.ign_topic_name;
+    topic.ros_type = entry.config.ros1_type_name;
+    topic.ign_type = entry.config.ign_type_name;
+    topic.direction = direction;
+    topic.messages_in = stats.messages_in;
+    topic.messages_out = stats.messages_out;
+    topic.bytes_in = stats.bytes_in;
+    topic.bytes_out = stats.bytes_out;
+    topic.dropped = stats.dropped;
+    topic.queue_dropped = stats.queue_dropped;
+    topic.echo_filtered = stats.echo_filtered;
+    topic.rate_in = rate(current.messages_in, previous.messages_in, period);
+    topic.rate_out = rate(current.messages_out, previous.messages_out, period);
+    topic.bandwidth_in = rate(current.bytes_in, previous.bytes_in, period);
+    topic.bandwidth_out = rate(current.bytes_out, previous.bytes_out, period);
+    topic.latency_p50 =
+      LatencyHistogram::percentile(stats.latency_counts, 0.50) * 1e-9;
+    topic.latency_p90 =
+      LatencyHistogram::percentile(stats.latency_counts, 0.90) * 1e-9;
+    topic.latency_p99 =
+      LatencyHistogram::percentile(stats.latency_counts, 0.99) * 1e-9;
+    topic.latency_max = stats.latency_max_ns * 1e-9;
+    ros1_msg.topics.push_back(topic);
+    configs.push_back(&entry.config);
+    bridge_rates[entry.config.ros1_topic_name + "|" +
+      entry.config.ign_topic_name] += topic.rate_out;
+
+    auto * param = ign_msg.add_param();
+    set_param(*param, "ros_topic", topic.ros_topic);
+    set_param(*param, "ign_topic", topic.ign_topic);
+    set_param(*param, "ros_type", topic.ros_type);
+    set_param(*param, "ign_type", topic.ign_type);
+    set_param(*param, "direction", topic.direction);
+    // Counters are doubles, exact up to 2^53.
+    set_param(*param, "messages_in", static_cast<double>(topic.messages_in));
+    set_param(*param, "messages_out", static_cast<double>(topic.messages_out));
+    set_param(*param, "bytes_in", static_cast<double>(topic.bytes_in));
+    set_param(*param, "bytes_out", static_cast<double>(topic.bytes_out));
+    set_param(*param, "dropped", static_cast<double>(topic.dropped));
+    set_param(*param, "queue_dropped",
+              static_cast<double>(topic.queue_dropped));
+    set_param(*param, "echo_filtered",
+              static_cast<double>(topic.echo_filtered));
+    set_param(*param, "rate_in", topic.rate_in);
+    set_param(*param, "rate_out", topic.rate_out);
+    set_param(*param, "bandwidth_in", topic.bandwidth_in);
+    set_param(*param, "bandwidth_out", topic.bandwidth_out);
+    set_param(*param, "latency_p50", topic.latency_p50);
+    set_param(*param, "latency_p90", topic.latency_p90);
+    set_param(*param, "latency_p99", topic.latency_p99);
+    set_param(*param, "latency_max", topic.latency_max);
+  }
+  previous_.swap(totals);
+
+  if (diagnostics_pub_)
+  {
+    // Once both directions of the bidirectional bridges are known.
+    for (size_t i = 0; i < configs.size(); ++i)
+    {
+      const BridgeConfig & config = *configs[i];
+      const TopicStatistics & topic = ros1_msg.topics[i];
+      const double rate = config.direction == BridgeDirection::BIDIRECTIONAL ?
+        bridge_rates[config.ros1_topic_name + "|" + config.ign_topic_name] :
+        topic.rate_out;
+
+      diagnostic_updater::DiagnosticStatusWrapper status;
+      status.hardware_id = ros::this_node::getName();
+      check_bridge_health(config, topic, rate, status);
+      diagnostics_msg.status.push_back(status);
+    }
+  }
+
+  ros1_pub_.publish(ros1_msg);
+  ign_pub_.Publish(ign_msg);
+  if (diagnostics_pub_)
+    diagnostics_pub_.publish(diagnostics_msg);
+}
+
+}  // namespace ros1_ign_bridge
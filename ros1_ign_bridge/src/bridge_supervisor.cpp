@@ -0,0 +1,239 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ros1_ign_bridge/bridge_supervisor.hpp"
+
+namespace ros1_ign_bridge
+{
+
+namespace
+{
+
+/// \brief A worker running for this long is considered healthy again.
+const std::chrono::seconds kHealthyRun(60);
+
+const std::chrono::seconds kMaxBackoff(30);
+
+/// \brief Time given to the workers to exit after SIGINT.
+const std::chrono::seconds kStopTimeout(5);
+
+//////////////////////////////////////////////////
+std::string
+describe_exit(int status)
+{
+  if (WIFEXITED(status))
+    return "exited with status " + std::to_string(WEXITSTATUS(status));
+  if (WIFSIGNALED(status))
+    return std::string("was killed by ") + strsignal(WTERMSIG(status));
+  return "stopped";
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+std::string
+process_class(const BridgeConfig & config)
+{
+  if (!config.process.empty())
+    return config.process;
+
+  // Large messages whose conversion must not delay the others.
+  if (config.ros1_type_name == "sensor_msgs/Image" ||
+      config.ros1_type_name == "sensor_msgs/CompressedImage" ||
+      config.ros1_type_name == "sensor_msgs/PointCloud2" ||
+      config.ros1_type_name == "sensor_msgs/LaserScan")
+  {
+    return "sensors";
+  }
+
+  // Commands to the simulation.
+  if (config.direction == BridgeDirection::ROS_TO_IGN)
+    return "control";
+
+  return "state";
+}
+
+//////////////////////////////////////////////////
+BridgeSupervisor::BridgeSupervisor(const std::string & executable)
+: executable_(executable)
+{
+}
+
+//////////////////////////////////////////////////
+BridgeSupervisor::~BridgeSupervisor()
+{
+  stop_all();
+}
+
+//////////////////////////////////////////////////
+void
+BridgeSupervisor::add_worker(
+  const std::string & name, const std::vector<std::string> & args)
+{
+  Worker worker;
+  worker.name = name;
+  worker.args = args;
+  workers_.push_back(worker);
+}
+
+//////////////////////////////////////////////////
+void
+BridgeSupervisor::run(const std::function<bool()> & keep_running)
+{
+  using Clock = std::chrono::steady_clock;
+
+  while (keep_running())
+  {
+    const auto now = Clock::now();
+    for (auto & worker : workers_)
+    {
+      if (worker.pid > 0)
+      {
+        int status = 0;
+        if (waitpid(worker.pid, &status, WNOHANG) != worker.pid)
+          continue;
+
+        worker.pid = -1;
+        // Restart right away after a long run, later and later after
+        // repeated failures.
+        if (now - worker.started >= kHealthyRun)
+          worker.backoff = std::chrono::seconds(1);
+        worker.next_start = now + worker.backoff;
+        std::cerr << "Bridge worker [" << worker.name << "] "
+                  << describe_exit(status) << ", restarting in "
+                  << worker.backoff.count() << " s" << std::endl;
+        worker.backoff = std::min(worker.backoff * 2, kMaxBackoff);
+        ++worker.restarts;
+        continue;
+      }
+
+      if (now >= worker.next_start && !start(worker))
+        worker.next_start = now + worker.backoff;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+
+  stop_all();
+}
+
+//////////////////////////////////////////////////
+pid_t
+BridgeSupervisor::pid(const std::string & name) const
+{
+  for (const auto & worker : workers_)
+  {
+    if (worker.name == name)
+      return worker.pid;
+  }
+  return -1;
+}
+
+//////////////////////////////////////////////////
+unsigned int
+BridgeSupervisor::restarts(const std::string & name) const
+{
+  for (const auto & worker : workers_)
+  {
+    if (worker.name == name)
+      return worker.restarts;
+  }
+  return 0;
+}
+
+//////////////////////////////////////////////////
+bool
+BridgeSupervisor::start(Worker & worker)
+{
+  // Everything the child needs is prepared before fork(), after which only
+  // async-signal-safe calls are allowed.
+  std::vector<char *> argv;
+  argv.push_back(const_cast<char *>(executable_.c_str()));
+  for (auto & arg : worker.args)
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  argv.push_back(nullptr);
+  const pid_t parent = getpid();
+
+  const pid_t pid = fork();
+  if (pid < 0)
+  {
+    std::cerr << "Failed to start bridge worker [" << worker.name << "]: "
+              << std::strerror(errno) << std::endl;
+    return false;
+  }
+  if (pid == 0)
+  {
+    // Don't outlive the supervisor, even if it is killed.
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+    if (getppid() != parent)
+      _exit(1);
+    execv(executable_.c_str(), argv.data());
+    _exit(127);
+  }
+
+  worker.pid = pid;
+  worker.started = std::chrono::steady_clock::now();
+  std::cout << "Started bridge worker [" << worker.name << "] with pid "
+            << pid << std::endl;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void
+BridgeSupervisor::stop_all()
+{
+  for (auto & worker : workers_)
+  {
+    if (worker.pid > 0)
+      kill(worker.pid, SIGINT);
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() + kStopTimeout;
+  for (auto & worker : workers_)
+  {
+    while (worker.pid > 0)
+    {
+      if (waitpid(worker.pid, nullptr, WNOHANG) == worker.pid)
+      {
+        worker.pid = -1;
+      }
+      else if (std::chrono::steady_clock::now() >= deadline)
+      {
+        std::cerr << "Bridge worker [" << worker.name << "] did not stop, "
+                  << "killing it" << std::endl;
+        kill(worker.pid, SIGKILL);
+        waitpid(worker.pid, nullptr, 0);
+        worker.pid = -1;
+      }
+      else
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      }
+    }
+  }
+}
+
+}  // namespace ros1_ign_bridge
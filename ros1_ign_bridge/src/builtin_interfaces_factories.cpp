@@ -12,12 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 // include builtin interfaces
 #include "ros1_ign_bridge/builtin_interfaces_factories.hpp"
 #include "ros1_ign_bridge/convert_builtin_interfaces.hpp"
+#include "ros1_ign_bridge/converter_plugins.hpp"
 
 namespace ros1_ign_bridge
 {
@@ -259,6 +264,17 @@ get_factory_builtin_interfaces(
       >
     >("sensor_msgs/PointCloud2", ign_type_name);
   }
+  if (
+    (ros1_type_name == "tf2_msgs/TFMessage" || ros1_type_name == "") &&
+     ign_type_name == "ignition.msgs.Pose_V")
+  {
+    return std::make_shared<
+      Factory<
+        tf2_msgs::TFMessage,
+        ignition::msgs::Pose_V
+      >
+    >("tf2_msgs/TFMessage", ign_type_name);
+  }
   return std::shared_ptr<FactoryInterface>();
 }
 
@@ -266,13 +282,137 @@ std::shared_ptr<FactoryInterface>
 get_factory(const std::string & ros1_type_name,
             const std::string & ign_type_name)
 {
+  // Factories hold no per-bridge state, so a single one per pair serves
+  // every bridge and both of its directions. The cache is never destroyed:
+  // factories from plugins must not outlive the plugin loader, which may be
+  // destroyed first at exit.
+  using Cache = std::map<std::pair<std::string, std::string>,
+    std::shared_ptr<FactoryInterface>>;
+  static Cache & cache = *new Cache();
+  static std::mutex mutex;
+
+  const auto key = std::make_pair(ros1_type_name, ign_type_name);
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = cache.find(key);
+  if (it != cache.end())
+    return it->second;
+
   std::shared_ptr<FactoryInterface> factory;
   factory = get_factory_builtin_interfaces(ros1_type_name, ign_type_name);
+  if (!factory)
+    factory = get_factory_from_plugins(ros1_type_name, ign_type_name);
+  if (!factory)
+    throw std::runtime_error("No template specialization for the pair");
+
+  cache.emplace(key, factory);
+  return factory;
+};
+
+std::shared_ptr<ServiceFactoryInterface>
+get_service_factory_builtin_interfaces(
+  const std::string & ros1_type_name,
+  const std::string & ign_request_type_name,
+  const std::string & ign_reply_type_name)
+{
+  // mapping from string to specialized template
+  if (
+    ros1_type_name == "std_srvs/Empty" &&
+    ign_request_type_name == "ignition.msgs.Empty" &&
+    ign_reply_type_name == "ignition.msgs.Empty")
+  {
+    return std::make_shared<
+      ServiceFactory<
+        std_srvs::Empty,
+        ignition::msgs::Empty,
+        ignition::msgs::Empty
+      >
+    >(ros1_type_name, ign_request_type_name, ign_reply_type_name);
+  }
+  if (
+    ros1_type_name == "std_srvs/SetBool" &&
+    ign_request_type_name == "ignition.msgs.Boolean" &&
+    ign_reply_type_name == "ignition.msgs.Boolean")
+  {
+    return std::make_shared<
+      ServiceFactory<
+        std_srvs::SetBool,
+        ignition::msgs::Boolean,
+        ignition::msgs::Boolean
+      >
+    >(ros1_type_name, ign_request_type_name, ign_reply_type_name);
+  }
+  if (
+    ros1_type_name == "std_srvs/Trigger" &&
+    ign_request_type_name == "ignition.msgs.Empty" &&
+    ign_reply_type_name == "ignition.msgs.Boolean")
+  {
+    return std::make_shared<
+      ServiceFactory<
+        std_srvs::Trigger,
+        ignition::msgs::Empty,
+        ignition::msgs::Boolean
+      >
+    >(ros1_type_name, ign_request_type_name, ign_reply_type_name);
+  }
+  if (
+    ros1_type_name == "ros1_ign_bridge/ControlWorld" &&
+    ign_request_type_name == "ignition.msgs.WorldControl" &&
+    ign_reply_type_name == "ignition.msgs.Boolean")
+  {
+    return std::make_shared<
+      ServiceFactory<
+        ros1_ign_bridge::ControlWorld,
+        ignition::msgs::WorldControl,
+        ignition::msgs::Boolean
+      >
+    >(ros1_type_name, ign_request_type_name, ign_reply_type_name);
+  }
+  return std::shared_ptr<ServiceFactoryInterface>();
+}
+
+std::shared_ptr<ServiceFactoryInterface>
+get_service_factory(const std::string & ros1_type_name,
+                    const std::string & ign_request_type_name,
+                    const std::string & ign_reply_type_name)
+{
+  std::shared_ptr<ServiceFactoryInterface> factory;
+  factory = get_service_factory_builtin_interfaces(
+    ros1_type_name, ign_request_type_name, ign_reply_type_name);
   if (factory)
     return factory;
 
-  throw std::runtime_error("No template specialization for the pair");
-};
+  throw std::runtime_error("No template specialization for the service");
+}
+
+const std::vector<std::pair<std::string, std::string>> &
+get_builtin_interfaces_type_pairs()
+{
+  static const std::vector<std::pair<std::string, std::string>> pairs = {
+    {"std_msgs/Float32", "ignition.msgs.Float"},
+    {"std_msgs/Header", "ignition.msgs.Header"},
+    {"std_msgs/String", "ignition.msgs.StringMsg"},
+    {"geometry_msgs/Quaternion", "ignition.msgs.Quaternion"},
+    {"rosgraph_msgs/Clock", "ignition.msgs.Clock"},
+    {"geometry_msgs/Vector3", "ignition.msgs.Vector3d"},
+    {"geometry_msgs/Point", "ignition.msgs.Vector3d"},
+    {"geometry_msgs/Pose", "ignition.msgs.Pose"},
+    {"geometry_msgs/PoseStamped", "ignition.msgs.Pose"},
+    {"geometry_msgs/Transform", "ignition.msgs.Pose"},
+    {"geometry_msgs/TransformStamped", "ignition.msgs.Pose"},
+    {"geometry_msgs/Twist", "ignition.msgs.Twist"},
+    {"mav_msgs/Actuators", "ignition.msgs.Actuators"},
+    {"sensor_msgs/FluidPressure", "ignition.msgs.Fluid"},
+    {"sensor_msgs/Image", "ignition.msgs.Image"},
+    {"sensor_msgs/CameraInfo", "ignition.msgs.CameraInfo"},
+    {"sensor_msgs/Imu", "ignition.msgs.IMU"},
+    {"sensor_msgs/JointState", "ignition.msgs.Model"},
+    {"sensor_msgs/LaserScan", "ignition.msgs.LaserScan"},
+    {"sensor_msgs/MagneticField", "ignition.msgs.Magnetometer"},
+    {"sensor_msgs/PointCloud2", "ignition.msgs.PointCloud"},
+    {"tf2_msgs/TFMessage", "ignition.msgs.Pose_V"},
+  };
+  return pairs;
+}
 
 // conversion functions for available interfaces
 
@@ -785,4 +925,29 @@ Factory<
   ros1_ign_bridge::convert_ign_to_1(ign_msg, ros1_msg);
 }
 
+// tf2_msgs
+template<>
+void
+Factory<
+  tf2_msgs::TFMessage,
+  ignition::msgs::Pose_V
+>::convert_1_to_ign(
+  const tf2_msgs::TFMessage & ros1_msg,
+  ignition::msgs::Pose_V & ign_msg)
+{
+  ros1_ign_bridge::convert_1_to_ign(ros1_msg, ign_msg);
+}
+
+template<>
+void
+Factory<
+  tf2_msgs::TFMessage,
+  ignition::msgs::Pose_V
+>::convert_ign_to_1(
+  const ignition::msgs::Pose_V & ign_msg,
+  tf2_msgs::TFMessage & ros1_msg)
+{
+  ros1_ign_bridge::convert_ign_to_1(ign_msg, ros1_msg);
+}
+
 }  // namespace ros1_ign_bridge
@@ -0,0 +1,161 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <pthread.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// include ROS 1
+#include <rosgraph_msgs/Clock.h>
+
+#include "ros1_ign_bridge/clock_bridge.hpp"
+#include "ros1_ign_bridge/thread_scheduling.hpp"
+
+namespace ros1_ign_bridge
+{
+
+//////////////////////////////////////////////////
+ClockBridge::ClockBridge(
+  ros::NodeHandle ros1_node,
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const ClockBridgeConfig & config)
+: config_(config),
+  ign_node_(ign_node),
+  period_ns_(config.max_rate > 0.0 ?
+             static_cast<int64_t>(1e9 / config.max_rate) : 0)
+{
+  // Only the latest time matters, older ones are never worth queueing.
+  ros1_pub_ = ros1_node.advertise<rosgraph_msgs::Clock>(
+    config_.ros1_topic_name, 1);
+  thread_ = std::thread(&ClockBridge::run, this);
+  ign_node_->Subscribe(config_.ign_topic_name, &ClockBridge::on_clock, this);
+}
+
+//////////////////////////////////////////////////
+ClockBridge::~ClockBridge()
+{
+  ign_node_->Unsubscribe(config_.ign_topic_name);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  condition_.notify_all();
+  thread_.join();
+  ros1_pub_.shutdown();
+}
+
+//////////////////////////////////////////////////
+uint64_t
+ClockBridge::received() const
+{
+  return received_.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t
+ClockBridge::published() const
+{
+  return published_.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t
+ClockBridge::backwards() const
+{
+  return backwards_.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void
+ClockBridge::on_clock(const ignition::msgs::Clock & ign_msg)
+{
+  received_.fetch_add(1, std::memory_order_relaxed);
+  const int64_t time_ns =
+    ign_msg.sim().sec() * 1000000000LL + ign_msg.sim().nsec();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (time_ns == latest_ns_)
+      return;
+
+    // The simulation only goes back in time when the world is reset, the
+    // clock starts over from the new time.
+    if (time_ns < latest_ns_)
+    {
+      backwards_.fetch_add(1, std::memory_order_relaxed);
+      reset_ = true;
+    }
+    latest_ns_ = time_ns;
+    pending_ = true;
+  }
+  condition_.notify_one();
+}
+
+//////////////////////////////////////////////////
+void
+ClockBridge::run()
+{
+  if (config_.priority > 0 || !config_.cpus.empty())
+  {
+    std::string error;
+    if (!set_thread_scheduling(
+        pthread_self(), config_.priority, config_.cpus, error))
+    {
+      std::cerr << "Failed to set the scheduling of the clock bridge: "
+                << error << std::endl;
+    }
+    std::cout << "Clock bridge thread: "
+              << describe_thread_scheduling(pthread_self()) << std::endl;
+  }
+
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point next_publish;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    condition_.wait(lock, [this] { return !running_ || pending_; });
+    if (!running_)
+      break;
+
+    // Decimate: times received before the period has elapsed replace the
+    // pending one, and the latest is published at the end of the period.
+    // A reset is published right away, so that subscribers don't keep
+    // waiting on a time that won't come anymore.
+    if (period_ns_ > 0)
+    {
+      condition_.wait_until(lock, next_publish,
+        [this] { return !running_ || reset_; });
+      if (!running_)
+        break;
+    }
+
+    rosgraph_msgs::Clock ros1_msg;
+    ros1_msg.clock.fromNSec(latest_ns_);
+    pending_ = false;
+    reset_ = false;
+    lock.unlock();
+
+    ros1_pub_.publish(ros1_msg);
+    published_.fetch_add(1, std::memory_order_relaxed);
+    next_publish = Clock::now() + std::chrono::nanoseconds(period_ns_);
+
+    lock.lock();
+  }
+}
+
+}  // namespace ros1_ign_bridge
@@ -0,0 +1,1383 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// include ROS 1
+#include <ros/package.h>
+
+#include "ros1_ign_bridge/conversion_plan.hpp"
+
+namespace ros1_ign_bridge
+{
+
+using google::protobuf::Descriptor;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+
+using Primitive = ConversionPlan::Primitive;
+using Op = ConversionPlan::Op;
+
+namespace
+{
+
+const std::map<std::string, Primitive> & primitives()
+{
+  static const std::map<std::string, Primitive> types = {
+    {"bool", Primitive::BOOL},
+    {"int8", Primitive::INT8},
+    {"byte", Primitive::INT8},
+    {"uint8", Primitive::UINT8},
+    {"char", Primitive::UINT8},
+    {"int16", Primitive::INT16},
+    {"uint16", Primitive::UINT16},
+    {"int32", Primitive::INT32},
+    {"uint32", Primitive::UINT32},
+    {"int64", Primitive::INT64},
+    {"uint64", Primitive::UINT64},
+    {"float32", Primitive::FLOAT32},
+    {"float64", Primitive::FLOAT64},
+    {"string", Primitive::STRING},
+  };
+  return types;
+}
+
+Primitive
+primitive_of(const std::string & type)
+{
+  auto it = primitives().find(type);
+  return it == primitives().end() ? Primitive::MESSAGE : it->second;
+}
+
+size_t
+primitive_size(Primitive primitive)
+{
+  switch (primitive)
+  {
+    case Primitive::BOOL:
+    case Primitive::INT8:
+    case Primitive::UINT8:
+      return 1;
+    case Primitive::INT16:
+    case Primitive::UINT16:
+      return 2;
+    case Primitive::INT32:
+    case Primitive::UINT32:
+    case Primitive::FLOAT32:
+      return 4;
+    case Primitive::INT64:
+    case Primitive::UINT64:
+    case Primitive::FLOAT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+/// \brief Whether an array of the primitive has the memory layout of a
+/// repeated field of the C++ type.
+bool
+is_bulk_compatible(Primitive primitive, FieldDescriptor::CppType cpp_type)
+{
+  switch (primitive)
+  {
+    case Primitive::INT32:
+      return cpp_type == FieldDescriptor::CPPTYPE_INT32;
+    case Primitive::UINT32:
+      return cpp_type == FieldDescriptor::CPPTYPE_UINT32;
+    case Primitive::INT64:
+      return cpp_type == FieldDescriptor::CPPTYPE_INT64;
+    case Primitive::UINT64:
+      return cpp_type == FieldDescriptor::CPPTYPE_UINT64;
+    case Primitive::FLOAT32:
+      return cpp_type == FieldDescriptor::CPPTYPE_FLOAT;
+    case Primitive::FLOAT64:
+      return cpp_type == FieldDescriptor::CPPTYPE_DOUBLE;
+    default:
+      return false;
+  }
+}
+
+bool
+is_scalar(FieldDescriptor::CppType cpp_type)
+{
+  return cpp_type != FieldDescriptor::CPPTYPE_STRING &&
+    cpp_type != FieldDescriptor::CPPTYPE_MESSAGE;
+}
+
+/// \brief Length of a fixed size array, e.g. the "9" of "float64[9]".
+/// \throws std::runtime_error if it isn't a non-negative integer.
+int
+parse_array_length(const std::string & text, const std::string & where)
+{
+  const bool digits = !text.empty() &&
+    text.find_first_not_of("0123456789") == std::string::npos;
+  errno = 0;
+  const long length = digits ? std::strtol(text.c_str(), nullptr, 10) : -1;
+  if (!digits || errno == ERANGE ||
+      length > std::numeric_limits<int>::max())
+  {
+    throw std::runtime_error("Invalid array length [" + text + "] in [" +
+                             where + "]");
+  }
+  return static_cast<int>(length);
+}
+
+/// \brief The fields of the map of a message such as ignition.msgs.Header,
+/// i.e. a repeated "data" field of messages with a "key" string and a
+/// repeated "value" string.
+bool
+find_map_fields(
+  const Descriptor * descriptor,
+  const FieldDescriptor *& data,
+  const FieldDescriptor *& key,
+  const FieldDescriptor *& value)
+{
+  data = descriptor ? descriptor->FindFieldByName("data") : nullptr;
+  if (!data || !data->is_repeated() ||
+      data->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE)
+    return false;
+  key = data->message_type()->FindFieldByName("key");
+  value = data->message_type()->FindFieldByName("value");
+  return key && !key->is_repeated() &&
+    key->cpp_type() == FieldDescriptor::CPPTYPE_STRING &&
+    value && value->is_repeated() &&
+    value->cpp_type() == FieldDescriptor::CPPTYPE_STRING;
+}
+
+std::string
+trim(const std::string & text)
+{
+  const auto begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos)
+    return std::string();
+  const auto end = text.find_last_not_of(" \t\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+/// \brief A number read from, or to be written to, a ROS 1 message.
+struct Scalar
+{
+  enum class Kind {SIGNED, UNSIGNED, REAL};
+
+  Kind kind = Kind::SIGNED;
+  int64_t i = 0;
+  uint64_t u = 0;
+  double d = 0.0;
+
+  int64_t
+  as_int64() const
+  {
+    return kind == Kind::SIGNED ? i :
+      kind == Kind::UNSIGNED ? static_cast<int64_t>(u) :
+      static_cast<int64_t>(d);
+  }
+
+  uint64_t
+  as_uint64() const
+  {
+    return kind == Kind::UNSIGNED ? u :
+      kind == Kind::SIGNED ? static_cast<uint64_t>(i) :
+      static_cast<uint64_t>(d);
+  }
+
+  double
+  as_double() const
+  {
+    return kind == Kind::REAL ? d :
+      kind == Kind::SIGNED ? static_cast<double>(i) : static_cast<double>(u);
+  }
+};
+
+/// \brief Text of a number stored in a map entry.
+std::string
+scalar_to_string(Primitive primitive, const Scalar & value)
+{
+  switch (primitive)
+  {
+    case Primitive::FLOAT32:
+    case Primitive::FLOAT64:
+    {
+      std::ostringstream text;
+      text.precision(17);
+      text << value.as_double();
+      return text.str();
+    }
+    case Primitive::BOOL:
+    case Primitive::UINT8:
+    case Primitive::UINT16:
+    case Primitive::UINT32:
+    case Primitive::UINT64:
+      return std::to_string(value.as_uint64());
+    default:
+      return std::to_string(value.as_int64());
+  }
+}
+
+/// \brief Number stored in a map entry, 0 if it isn't one.
+Scalar
+scalar_from_string(Primitive primitive, const std::string & text)
+{
+  Scalar value;
+  switch (primitive)
+  {
+    case Primitive::FLOAT32:
+    case Primitive::FLOAT64:
+      value.kind = Scalar::Kind::REAL;
+      value.d = std::strtod(text.c_str(), nullptr);
+      break;
+    case Primitive::BOOL:
+    case Primitive::UINT8:
+    case Primitive::UINT16:
+    case Primitive::UINT32:
+    case Primitive::UINT64:
+      value.kind = Scalar::Kind::UNSIGNED;
+      value.u = std::strtoull(text.c_str(), nullptr, 10);
+      break;
+    default:
+      value.i = std::strtoll(text.c_str(), nullptr, 10);
+      break;
+  }
+  return value;
+}
+
+Scalar
+get_scalar(const Reflection * reflection, const Message & msg,
+           const FieldDescriptor * field, int index)
+{
+  Scalar value;
+  const bool repeated = index >= 0;
+  switch (field->cpp_type())
+  {
+    case FieldDescriptor::CPPTYPE_INT32:
+      value.i = repeated ? reflection->GetRepeatedInt32(msg, field, index) :
+        reflection->GetInt32(msg, field);
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      value.i = repeated ? reflection->GetRepeatedInt64(msg, field, index) :
+        reflection->GetInt64(msg, field);
+      break;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      value.i = repeated ? reflection->GetRepeatedEnumValue(msg, field, index) :
+        reflection->GetEnumValue(msg, field);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      value.kind = Scalar::Kind::UNSIGNED;
+      value.u = repeated ? reflection->GetRepeatedUInt32(msg, field, index) :
+        reflection->GetUInt32(msg, field);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      value.kind = Scalar::Kind::UNSIGNED;
+      value.u = repeated ? reflection->GetRepeatedUInt64(msg, field, index) :
+        reflection->GetUInt64(msg, field);
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      value.kind = Scalar::Kind::UNSIGNED;
+      value.u = repeated ? reflection->GetRepeatedBool(msg, field, index) :
+        reflection->GetBool(msg, field);
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      value.kind = Scalar::Kind::REAL;
+      value.d = repeated ? reflection->GetRepeatedFloat(msg, field, index) :
+        reflection->GetFloat(msg, field);
+      break;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      value.kind = Scalar::Kind::REAL;
+      value.d = repeated ? reflection->GetRepeatedDouble(msg, field, index) :
+        reflection->GetDouble(msg, field);
+      break;
+    default:
+      break;
+  }
+  return value;
+}
+
+void
+set_scalar(const Reflection * reflection, Message * msg,
+           const FieldDescriptor * field, const Scalar & value)
+{
+  const bool add = field->is_repeated();
+  switch (field->cpp_type())
+  {
+    case FieldDescriptor::CPPTYPE_INT32:
+    {
+      const auto v = static_cast<int32_t>(value.as_int64());
+      add ? reflection->AddInt32(msg, field, v) :
+        reflection->SetInt32(msg, field, v);
+      break;
+    }
+    case FieldDescriptor::CPPTYPE_INT64:
+      add ? reflection->AddInt64(msg, field, value.as_int64()) :
+        reflection->SetInt64(msg, field, value.as_int64());
+      break;
+    case FieldDescriptor::CPPTYPE_ENUM:
+    {
+      const auto v = static_cast<int>(value.as_int64());
+      add ? reflection->AddEnumValue(msg, field, v) :
+        reflection->SetEnumValue(msg, field, v);
+      break;
+    }
+    case FieldDescriptor::CPPTYPE_UINT32:
+    {
+      const auto v = static_cast<uint32_t>(value.as_uint64());
+      add ? reflection->AddUInt32(msg, field, v) :
+        reflection->SetUInt32(msg, field, v);
+      break;
+    }
+    case FieldDescriptor::CPPTYPE_UINT64:
+      add ? reflection->AddUInt64(msg, field, value.as_uint64()) :
+        reflection->SetUInt64(msg, field, value.as_uint64());
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      add ? reflection->AddBool(msg, field, value.as_uint64() != 0) :
+        reflection->SetBool(msg, field, value.as_uint64() != 0);
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+    {
+      const auto v = static_cast<float>(value.as_double());
+      add ? reflection->AddFloat(msg, field, v) :
+        reflection->SetFloat(msg, field, v);
+      break;
+    }
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      add ? reflection->AddDouble(msg, field, value.as_double()) :
+        reflection->SetDouble(msg, field, value.as_double());
+      break;
+    default:
+      break;
+  }
+}
+
+template<typename T>
+void
+bulk_to_ign(const Reflection * reflection, Message * msg,
+            const FieldDescriptor * field, const uint8_t * data, size_t count)
+{
+  auto * repeated = reflection->MutableRepeatedField<T>(msg, field);
+  repeated->Resize(static_cast<int>(count), T());
+  if (count > 0)
+    std::memcpy(repeated->mutable_data(), data, count * sizeof(T));
+}
+
+template<typename T>
+const uint8_t *
+bulk_from_ign(const Reflection * reflection, const Message & msg,
+              const FieldDescriptor * field, size_t & count)
+{
+  const auto & repeated = reflection->GetRepeatedField<T>(msg, field);
+  count = static_cast<size_t>(repeated.size());
+  return reinterpret_cast<const uint8_t *>(repeated.data());
+}
+
+/// \brief Hex MD5 digest of a text, as in RFC 1321.
+std::string
+md5_hex(const std::string & text)
+{
+  static const uint32_t shifts[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+  static const uint32_t sines[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a,
+    0xa8304613, 0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+    0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340,
+    0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8,
+    0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+    0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+    0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92,
+    0xffeff47d, 0x85845dd1, 0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+    0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+  // Padded with 0x80, zeros and the length in bits to whole blocks.
+  std::string data = text;
+  const uint64_t bits = static_cast<uint64_t>(text.size()) * 8;
+  data += static_cast<char>(0x80);
+  while (data.size() % 64 != 56)
+    data += '\0';
+  for (int i = 0; i < 8; ++i)
+    data += static_cast<char>((bits >> (8 * i)) & 0xff);
+
+  uint32_t state[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+  for (size_t block = 0; block < data.size(); block += 64)
+  {
+    uint32_t words[16];
+    for (int i = 0; i < 16; ++i)
+    {
+      words[i] = 0;
+      for (int j = 0; j < 4; ++j)
+      {
+        words[i] |= static_cast<uint32_t>(
+          static_cast<uint8_t>(data[block + i * 4 + j])) << (8 * j);
+      }
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    for (int i = 0; i < 64; ++i)
+    {
+      uint32_t f;
+      int g;
+      if (i < 16)
+      {
+        f = (b & c) | (~b & d);
+        g = i;
+      }
+      else if (i < 32)
+      {
+        f = (d & b) | (~d & c);
+        g = (5 * i + 1) % 16;
+      }
+      else if (i < 48)
+      {
+        f = b ^ c ^ d;
+        g = (3 * i + 5) % 16;
+      }
+      else
+      {
+        f = c ^ (b | ~d);
+        g = (7 * i) % 16;
+      }
+      const uint32_t sum = a + f + sines[i] + words[g];
+      a = d;
+      d = c;
+      c = b;
+      b += (sum << shifts[i]) | (sum >> (32 - shifts[i]));
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+  }
+
+  static const char digits[] = "0123456789abcdef";
+  std::string hex;
+  for (const uint32_t word : state)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      const uint8_t byte = (word >> (8 * i)) & 0xff;
+      hex += digits[byte >> 4];
+      hex += digits[byte & 0xf];
+    }
+  }
+  return hex;
+}
+
+/// \brief MD5 sum of a message type, memoized in sums for the types used
+/// several times.
+const std::string &
+message_md5(
+  const std::string & type,
+  const RosMessageSpecs & specs,
+  std::map<std::string, std::string> & sums)
+{
+  auto known = sums.find(type);
+  if (known != sums.end())
+    return known->second;
+
+  auto spec = specs.find(type);
+  if (spec == specs.end())
+    throw std::runtime_error("Missing definition of [" + type + "]");
+
+  // genmsg hashes the constants, then the fields with the builtin types as
+  // written and the message types replaced by their own sum, one per line.
+  std::string text;
+  for (const auto & constant : spec->second.constants)
+    text += constant + "\n";
+  for (const auto & field : spec->second.fields)
+  {
+    if (primitive_of(field.type) != Primitive::MESSAGE ||
+        field.type == "time" || field.type == "duration")
+    {
+      text += field.type;
+      if (field.is_array)
+      {
+        text += "[" + (field.array_length >= 0 ?
+          std::to_string(field.array_length) : std::string()) + "]";
+      }
+    }
+    else
+    {
+      text += message_md5(field.type, specs, sums);
+    }
+    text += " " + field.name + "\n";
+  }
+  if (!text.empty())
+    text.pop_back();
+
+  return sums[type] = md5_hex(text);
+}
+
+}  // namespace
+
+/// \brief Bounds checked cursor over a serialized ROS 1 message.
+class ConversionPlan::Reader
+{
+public:
+  Reader(const uint8_t * data, size_t size)
+  : data_(data), end_(data + size)
+  {}
+
+  size_t
+  remaining() const
+  {
+    return static_cast<size_t>(end_ - data_);
+  }
+
+  const uint8_t *
+  bytes(size_t size)
+  {
+    if (size > remaining())
+      throw std::runtime_error("Truncated ROS 1 message");
+    const uint8_t * result = data_;
+    data_ += size;
+    return result;
+  }
+
+  uint32_t
+  length()
+  {
+    uint32_t value;
+    std::memcpy(&value, bytes(sizeof(value)), sizeof(value));
+    return value;
+  }
+
+  template<typename T>
+  T
+  read()
+  {
+    T value;
+    std::memcpy(&value, bytes(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  Scalar
+  scalar(Primitive primitive)
+  {
+    Scalar value;
+    switch (primitive)
+    {
+      case Primitive::BOOL:
+      case Primitive::UINT8:
+        value.kind = Scalar::Kind::UNSIGNED;
+        value.u = read<uint8_t>();
+        break;
+      case Primitive::INT8:
+        value.i = read<int8_t>();
+        break;
+      case Primitive::INT16:
+        value.i = read<int16_t>();
+        break;
+      case Primitive::UINT16:
+        value.kind = Scalar::Kind::UNSIGNED;
+        value.u = read<uint16_t>();
+        break;
+      case Primitive::INT32:
+        value.i = read<int32_t>();
+        break;
+      case Primitive::UINT32:
+        value.kind = Scalar::Kind::UNSIGNED;
+        value.u = read<uint32_t>();
+        break;
+      case Primitive::INT64:
+        value.i = read<int64_t>();
+        break;
+      case Primitive::UINT64:
+        value.kind = Scalar::Kind::UNSIGNED;
+        value.u = read<uint64_t>();
+        break;
+      case Primitive::FLOAT32:
+        value.kind = Scalar::Kind::REAL;
+        value.d = read<float>();
+        break;
+      case Primitive::FLOAT64:
+        value.kind = Scalar::Kind::REAL;
+        value.d = read<double>();
+        break;
+      default:
+        break;
+    }
+    return value;
+  }
+
+private:
+  const uint8_t * data_;
+  const uint8_t * end_;
+};
+
+/// \brief Appends to a serialized ROS 1 message.
+class ConversionPlan::Writer
+{
+public:
+  explicit Writer(std::vector<uint8_t> & data)
+  : data_(data)
+  {}
+
+  void
+  bytes(const void * source, size_t size)
+  {
+    const size_t offset = data_.size();
+    data_.resize(offset + size);
+    if (size > 0)
+      std::memcpy(data_.data() + offset, source, size);
+  }
+
+  void
+  zeros(size_t size)
+  {
+    data_.resize(data_.size() + size, 0);
+  }
+
+  void
+  length(size_t value)
+  {
+    const uint32_t length = static_cast<uint32_t>(value);
+    bytes(&length, sizeof(length));
+  }
+
+  template<typename T>
+  void
+  write(T value)
+  {
+    bytes(&value, sizeof(T));
+  }
+
+  void
+  scalar(Primitive primitive, const Scalar & value)
+  {
+    switch (primitive)
+    {
+      case Primitive::BOOL:
+        write<uint8_t>(value.as_uint64() != 0);
+        break;
+      case Primitive::UINT8:
+        write(static_cast<uint8_t>(value.as_uint64()));
+        break;
+      case Primitive::INT8:
+        write(static_cast<int8_t>(value.as_int64()));
+        break;
+      case Primitive::INT16:
+        write(static_cast<int16_t>(value.as_int64()));
+        break;
+      case Primitive::UINT16:
+        write(static_cast<uint16_t>(value.as_uint64()));
+        break;
+      case Primitive::INT32:
+        write(static_cast<int32_t>(value.as_int64()));
+        break;
+      case Primitive::UINT32:
+        write(static_cast<uint32_t>(value.as_uint64()));
+        break;
+      case Primitive::INT64:
+        write(value.as_int64());
+        break;
+      case Primitive::UINT64:
+        write(value.as_uint64());
+        break;
+      case Primitive::FLOAT32:
+        write(static_cast<float>(value.as_double()));
+        break;
+      case Primitive::FLOAT64:
+        write(value.as_double());
+        break;
+      default:
+        break;
+    }
+  }
+
+private:
+  std::vector<uint8_t> & data_;
+};
+
+//////////////////////////////////////////////////
+void
+load_ros_message_specs(
+  const std::string & type,
+  RosMessageSpecs & specs,
+  std::string & definition)
+{
+  // time and duration are messages with two fields for the plan.
+  if (!specs.count("time"))
+  {
+    specs["time"] = RosMessageSpec{"time",
+      {{"sec", "uint32", false, -1}, {"nsec", "uint32", false, -1}}, {}};
+    specs["duration"] = RosMessageSpec{"duration",
+      {{"sec", "int32", false, -1}, {"nsec", "int32", false, -1}}, {}};
+  }
+
+  // Depth first, so that the definition lists every dependency once.
+  std::vector<std::string> pending = {type};
+  std::vector<std::string> loaded;
+  std::map<std::string, std::string> texts;
+  while (!pending.empty())
+  {
+    const std::string current = pending.back();
+    pending.pop_back();
+    if (texts.count(current))
+      continue;
+
+    const auto slash = current.find('/');
+    if (slash == std::string::npos)
+      throw std::runtime_error("Invalid ROS 1 message type [" + current + "]");
+    const std::string package = current.substr(0, slash);
+    const std::string package_path = ros::package::getPath(package);
+    if (package_path.empty())
+      throw std::runtime_error("Unknown ROS 1 package [" + package + "]");
+
+    const std::string path =
+      package_path + "/msg/" + current.substr(slash + 1) + ".msg";
+    std::ifstream file(path);
+    if (!file)
+      throw std::runtime_error("Can't read the definition of [" + current +
+                               "] from [" + path + "]");
+    std::stringstream text;
+    text << file.rdbuf();
+    texts[current] = text.str();
+    loaded.push_back(current);
+
+    RosMessageSpec spec;
+    spec.type = current;
+    std::istringstream lines(texts[current]);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+      const std::string raw = trim(line);
+      line = trim(line.substr(0, line.find('#')));
+      if (line.empty())
+        continue;
+
+      const auto space = line.find_first_of(" \t");
+      if (space == std::string::npos)
+      {
+        throw std::runtime_error("Invalid line [" + line + "] in [" + path +
+                                 "]");
+      }
+      const std::string name = trim(line.substr(space));
+      // Constants are not serialized. The value of a string constant is
+      // everything after "=", "#" included.
+      const auto equals = name.find('=');
+      if (equals != std::string::npos)
+      {
+        const std::string type = line.substr(0, space);
+        const std::string value = type == "string" ?
+          trim(raw.substr(raw.find('=') + 1)) : trim(name.substr(equals + 1));
+        spec.constants.push_back(
+          type + " " + trim(name.substr(0, equals)) + "=" + value);
+        continue;
+      }
+
+      RosFieldSpec field;
+      field.name = name;
+      field.type = line.substr(0, space);
+      const auto bracket = field.type.find('[');
+      if (bracket != std::string::npos)
+      {
+        field.is_array = true;
+        const std::string length = field.type.substr(
+          bracket + 1, field.type.size() - bracket - 2);
+        field.array_length = length.empty() ? -1 :
+          parse_array_length(length, path);
+        field.type = field.type.substr(0, bracket);
+      }
+
+      if (field.type == "Header")
+        field.type = "std_msgs/Header";
+      else if (primitive_of(field.type) == Primitive::MESSAGE &&
+               field.type != "time" && field.type != "duration" &&
+               field.type.find('/') == std::string::npos)
+        field.type = package + "/" + field.type;
+
+      if (primitive_of(field.type) == Primitive::MESSAGE &&
+          !specs.count(field.type))
+        pending.push_back(field.type);
+      spec.fields.push_back(field);
+    }
+    specs[current] = spec;
+  }
+
+  definition = texts[type];
+  for (const auto & dependency : loaded)
+  {
+    if (dependency == type)
+      continue;
+    definition += "\n" + std::string(80, '=') + "\nMSG: " + dependency + "\n" +
+      texts[dependency];
+  }
+}
+
+//////////////////////////////////////////////////
+std::string
+ros_message_md5(const std::string & type, const RosMessageSpecs & specs)
+{
+  std::map<std::string, std::string> sums;
+  return message_md5(type, specs, sums);
+}
+
+//////////////////////////////////////////////////
+ConversionPlan::ConversionPlan(
+  const std::string & ros1_type,
+  const RosMessageSpecs & specs,
+  const Descriptor * descriptor,
+  const std::map<std::string, std::string> & field_mappings)
+: descriptor_(descriptor),
+  md5sum_(ros_message_md5(ros1_type, specs))
+{
+  compile_level(ros1_type, specs, descriptor, &field_mappings);
+}
+
+//////////////////////////////////////////////////
+const Descriptor *
+ConversionPlan::descriptor() const
+{
+  return descriptor_;
+}
+
+//////////////////////////////////////////////////
+const std::string &
+ConversionPlan::md5sum() const
+{
+  return md5sum_;
+}
+
+//////////////////////////////////////////////////
+int
+ConversionPlan::compile_level(
+  const std::string & ros1_type,
+  const RosMessageSpecs & specs,
+  const Descriptor * descriptor,
+  const std::map<std::string, std::string> * field_mappings)
+{
+  const int level = static_cast<int>(levels_.size());
+  levels_.emplace_back();
+  compile_fields(level, ros1_type, specs, descriptor, descriptor, {}, "",
+                 field_mappings);
+  return level;
+}
+
+//////////////////////////////////////////////////
+void
+ConversionPlan::compile_fields(
+  int level,
+  const std::string & ros1_type,
+  const RosMessageSpecs & specs,
+  const Descriptor * root,
+  const Descriptor * context,
+  const std::vector<const FieldDescriptor *> & prefix,
+  const std::string & ros1_prefix,
+  const std::map<std::string, std::string> * field_mappings)
+{
+  auto spec = specs.find(ros1_type);
+  if (spec == specs.end())
+    throw std::runtime_error("Unknown ROS 1 message type [" + ros1_type + "]");
+
+  for (const auto & field : spec->second.fields)
+  {
+    const std::string ros1_path = ros1_prefix + field.name;
+    const std::string where = "[" + ros1_path + "]";
+
+    // Find the protobuf counterpart, if any.
+    std::vector<const FieldDescriptor *> path;
+    const bool mapped = field_mappings && field_mappings->count(ros1_path);
+    if (mapped)
+    {
+      const auto mapping = field_mappings->find(ros1_path);
+      std::istringstream segments(mapping->second);
+      std::string segment;
+      const Descriptor * current = root;
+      while (!mapping->second.empty() && std::getline(segments, segment, '.'))
+      {
+        const FieldDescriptor * target =
+          current ? current->FindFieldByName(segment) : nullptr;
+        if (!target)
+        {
+          throw std::runtime_error("No field [" + mapping->second + "] in [" +
+                                   root->full_name() + "] for " + where);
+        }
+        path.push_back(target);
+        current = target->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+          !target->is_repeated() ? target->message_type() : nullptr;
+      }
+    }
+    else if (context)
+    {
+      const FieldDescriptor * target = context->FindFieldByName(field.name);
+      if (target)
+      {
+        path = prefix;
+        path.push_back(target);
+      }
+    }
+    const FieldDescriptor * target = path.empty() ? nullptr : path.back();
+
+    Op op;
+    op.primitive = primitive_of(field.type);
+    op.array_length = field.array_length;
+    op.path = path;
+
+    // Without a field of its own, e.g. the frame_id of a std_msgs/Header
+    // converted to an ignition.msgs.Header, a string or a number goes into
+    // the key/value map of the message, if it has one.
+    const FieldDescriptor * data_field = nullptr;
+    if (!target && !mapped && !field.is_array &&
+        op.primitive != Primitive::MESSAGE &&
+        find_map_fields(context, data_field, op.key_field, op.value_field))
+    {
+      op.kind = Op::Kind::MAP_ENTRY;
+      op.key = field.name;
+      op.path = prefix;
+      op.path.push_back(data_field);
+      levels_[level].ops.push_back(op);
+      continue;
+    }
+
+    if (op.primitive == Primitive::MESSAGE && !field.is_array)
+    {
+      // Nested messages are flattened into the current level.
+      const Descriptor * child_context = nullptr;
+      if (target)
+      {
+        if (target->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE ||
+            target->is_repeated())
+        {
+          throw std::runtime_error(where + " is a message but [" +
+                                   target->full_name() + "] is not");
+        }
+        child_context = target->message_type();
+      }
+      compile_fields(level, field.type, specs, root, child_context, path,
+                     ros1_path + ".", field_mappings);
+      continue;
+    }
+
+    const auto error = [&]()
+      {
+        return std::runtime_error("Can't convert " + where + " of type [" +
+          field.type + (field.is_array ? "[]" : "") + "] to [" +
+          target->full_name() + "]");
+      };
+
+    if (!field.is_array)
+    {
+      if (op.primitive == Primitive::STRING)
+      {
+        op.kind = Op::Kind::STRING;
+        if (target && (target->is_repeated() ||
+            target->cpp_type() != FieldDescriptor::CPPTYPE_STRING))
+          throw error();
+      }
+      else
+      {
+        op.kind = Op::Kind::SCALAR;
+        if (target && (target->is_repeated() || !is_scalar(target->cpp_type())))
+          throw error();
+      }
+    }
+    else if (op.primitive == Primitive::MESSAGE)
+    {
+      op.kind = Op::Kind::MESSAGE_ARRAY;
+      if (target && (!target->is_repeated() ||
+          target->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE))
+        throw error();
+      op.level = compile_level(field.type, specs,
+        target ? target->message_type() : nullptr, nullptr);
+    }
+    else if (op.primitive == Primitive::STRING)
+    {
+      op.kind = Op::Kind::STRING_ARRAY;
+      if (target && (!target->is_repeated() ||
+          target->cpp_type() != FieldDescriptor::CPPTYPE_STRING))
+        throw error();
+    }
+    else if ((op.primitive == Primitive::UINT8 ||
+              op.primitive == Primitive::INT8) &&
+             (!target || (!target->is_repeated() &&
+              target->cpp_type() == FieldDescriptor::CPPTYPE_STRING)))
+    {
+      op.kind = Op::Kind::BYTES_ARRAY;
+    }
+    else if (target && target->is_repeated() &&
+             is_bulk_compatible(op.primitive, target->cpp_type()))
+    {
+      op.kind = Op::Kind::BULK_ARRAY;
+    }
+    else if (!target)
+    {
+      // Skipped or zeroed as a whole, the element type doesn't matter.
+      op.kind = Op::Kind::BULK_ARRAY;
+    }
+    else
+    {
+      op.kind = Op::Kind::SCALAR_ARRAY;
+      if (!target->is_repeated() || !is_scalar(target->cpp_type()))
+        throw error();
+    }
+
+    levels_[level].ops.push_back(op);
+  }
+}
+
+//////////////////////////////////////////////////
+void
+ConversionPlan::ros1_to_ign(
+  const uint8_t * data, size_t size, Message & ign_msg) const
+{
+  Reader reader(data, size);
+  run_ros1_to_ign(0, reader, &ign_msg);
+}
+
+//////////////////////////////////////////////////
+void
+ConversionPlan::ign_to_ros1(
+  const Message & ign_msg, std::vector<uint8_t> & data) const
+{
+  data.clear();
+  Writer writer(data);
+  run_ign_to_ros1(0, &ign_msg, writer);
+}
+
+//////////////////////////////////////////////////
+void
+ConversionPlan::run_ros1_to_ign(
+  int level, Reader & reader, Message * ign_msg) const
+{
+  for (const auto & op : levels_[level].ops)
+  {
+    // Message holding the target field, null to only skip the data.
+    Message * parent = nullptr;
+    const FieldDescriptor * field = nullptr;
+    if (ign_msg && !op.path.empty())
+    {
+      parent = ign_msg;
+      for (size_t i = 0; i + 1 < op.path.size(); ++i)
+        parent = parent->GetReflection()->MutableMessage(parent, op.path[i]);
+      field = op.path.back();
+    }
+    const Reflection * reflection = parent ? parent->GetReflection() : nullptr;
+
+    if (op.kind == Op::Kind::SCALAR)
+    {
+      const Scalar value = reader.scalar(op.primitive);
+      if (parent)
+        set_scalar(reflection, parent, field, value);
+      continue;
+    }
+    if (op.kind == Op::Kind::STRING)
+    {
+      const uint32_t size = reader.length();
+      const uint8_t * data = reader.bytes(size);
+      if (parent)
+      {
+        reflection->SetString(parent, field,
+          std::string(reinterpret_cast<const char *>(data), size));
+      }
+      continue;
+    }
+    if (op.kind == Op::Kind::MAP_ENTRY)
+    {
+      std::string value;
+      if (op.primitive == Primitive::STRING)
+      {
+        const uint32_t size = reader.length();
+        value.assign(reinterpret_cast<const char *>(reader.bytes(size)), size);
+      }
+      else
+      {
+        value = scalar_to_string(op.primitive, reader.scalar(op.primitive));
+      }
+      if (parent)
+      {
+        Message * entry = reflection->AddMessage(parent, field);
+        const Reflection * entry_reflection = entry->GetReflection();
+        entry_reflection->SetString(entry, op.key_field, op.key);
+        entry_reflection->AddString(entry, op.value_field, value);
+      }
+      continue;
+    }
+
+    const size_t count = op.array_length >= 0 ?
+      static_cast<size_t>(op.array_length) : reader.length();
+    switch (op.kind)
+    {
+      case Op::Kind::BYTES_ARRAY:
+      {
+        const uint8_t * data = reader.bytes(count);
+        if (parent)
+        {
+          reflection->SetString(parent, field,
+            std::string(reinterpret_cast<const char *>(data), count));
+        }
+        break;
+      }
+      case Op::Kind::BULK_ARRAY:
+      {
+        const size_t element_size = primitive_size(op.primitive);
+        if (count > reader.remaining() / element_size)
+          throw std::runtime_error("Truncated ROS 1 message");
+        const uint8_t * data = reader.bytes(count * element_size);
+        if (!parent)
+          break;
+        switch (op.primitive)
+        {
+          case Primitive::INT32:
+            bulk_to_ign<int32_t>(reflection, parent, field, data, count);
+            break;
+          case Primitive::UINT32:
+            bulk_to_ign<uint32_t>(reflection, parent, field, data, count);
+            break;
+          case Primitive::INT64:
+            bulk_to_ign<int64_t>(reflection, parent, field, data, count);
+            break;
+          case Primitive::UINT64:
+            bulk_to_ign<uint64_t>(reflection, parent, field, data, count);
+            break;
+          case Primitive::FLOAT32:
+            bulk_to_ign<float>(reflection, parent, field, data, count);
+            break;
+          case Primitive::FLOAT64:
+            bulk_to_ign<double>(reflection, parent, field, data, count);
+            break;
+          default:
+            break;
+        }
+        break;
+      }
+      case Op::Kind::SCALAR_ARRAY:
+      {
+        if (count > reader.remaining() / primitive_size(op.primitive))
+          throw std::runtime_error("Truncated ROS 1 message");
+        if (!parent)
+        {
+          reader.bytes(count * primitive_size(op.primitive));
+          break;
+        }
+        reflection->ClearField(parent, field);
+        for (size_t i = 0; i < count; ++i)
+          set_scalar(reflection, parent, field, reader.scalar(op.primitive));
+        break;
+      }
+      case Op::Kind::STRING_ARRAY:
+      {
+        if (count > reader.remaining() / sizeof(uint32_t))
+          throw std::runtime_error("Truncated ROS 1 message");
+        if (parent)
+          reflection->ClearField(parent, field);
+        for (size_t i = 0; i < count; ++i)
+        {
+          const uint32_t size = reader.length();
+          const uint8_t * data = reader.bytes(size);
+          if (parent)
+          {
+            reflection->AddString(parent, field,
+              std::string(reinterpret_cast<const char *>(data), size));
+          }
+        }
+        break;
+      }
+      case Op::Kind::MESSAGE_ARRAY:
+      {
+        // Empty messages take no space, so only bound the others.
+        if (!levels_[op.level].ops.empty() && count > reader.remaining())
+          throw std::runtime_error("Truncated ROS 1 message");
+        if (parent)
+          reflection->ClearField(parent, field);
+        for (size_t i = 0; i < count; ++i)
+        {
+          run_ros1_to_ign(op.level, reader,
+            parent ? reflection->AddMessage(parent, field) : nullptr);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void
+ConversionPlan::run_ign_to_ros1(
+  int level, const Message * ign_msg, Writer & writer) const
+{
+  for (const auto & op : levels_[level].ops)
+  {
+    // Message holding the source field, null to write zeros.
+    const Message * parent = nullptr;
+    const FieldDescriptor * field = nullptr;
+    if (ign_msg && !op.path.empty())
+    {
+      parent = ign_msg;
+      for (size_t i = 0; i + 1 < op.path.size(); ++i)
+        parent = &parent->GetReflection()->GetMessage(*parent, op.path[i]);
+      field = op.path.back();
+    }
+    const Reflection * reflection = parent ? parent->GetReflection() : nullptr;
+
+    if (op.kind == Op::Kind::SCALAR)
+    {
+      writer.scalar(op.primitive,
+        parent ? get_scalar(reflection, *parent, field, -1) : Scalar());
+      continue;
+    }
+
+    std::string scratch;
+    if (op.kind == Op::Kind::STRING)
+    {
+      const std::string & value = parent ?
+        reflection->GetStringReference(*parent, field, &scratch) : scratch;
+      writer.length(value.size());
+      writer.bytes(value.data(), value.size());
+      continue;
+    }
+    if (op.kind == Op::Kind::MAP_ENTRY)
+    {
+      // The first value of the first entry with the key, if any.
+      std::string value;
+      const int entries = parent ? reflection->FieldSize(*parent, field) : 0;
+      for (int i = 0; i < entries; ++i)
+      {
+        const Message & entry =
+          reflection->GetRepeatedMessage(*parent, field, i);
+        const Reflection * entry_reflection = entry.GetReflection();
+        if (entry_reflection->GetStringReference(
+              entry, op.key_field, &scratch) == op.key)
+        {
+          if (entry_reflection->FieldSize(entry, op.value_field) > 0)
+          {
+            value =
+              entry_reflection->GetRepeatedString(entry, op.value_field, 0);
+          }
+          break;
+        }
+      }
+      if (op.primitive == Primitive::STRING)
+      {
+        writer.length(value.size());
+        writer.bytes(value.data(), value.size());
+      }
+      else
+      {
+        writer.scalar(op.primitive, scalar_from_string(op.primitive, value));
+      }
+      continue;
+    }
+
+    // Elements available on the protobuf side, and written on the ROS side.
+    size_t available = 0;
+    const uint8_t * data = nullptr;
+    size_t element_size = primitive_size(op.primitive);
+    if (op.kind == Op::Kind::BYTES_ARRAY)
+    {
+      element_size = 1;
+      if (parent)
+      {
+        const std::string & value =
+          reflection->GetStringReference(*parent, field, &scratch);
+        data = reinterpret_cast<const uint8_t *>(value.data());
+        available = value.size();
+      }
+    }
+    else if (op.kind == Op::Kind::BULK_ARRAY && parent)
+    {
+      switch (op.primitive)
+      {
+        case Primitive::INT32:
+          data = bulk_from_ign<int32_t>(reflection, *parent, field, available);
+          break;
+        case Primitive::UINT32:
+          data = bulk_from_ign<uint32_t>(reflection, *parent, field, available);
+          break;
+        case Primitive::INT64:
+          data = bulk_from_ign<int64_t>(reflection, *parent, field, available);
+          break;
+        case Primitive::UINT64:
+          data = bulk_from_ign<uint64_t>(reflection, *parent, field, available);
+          break;
+        case Primitive::FLOAT32:
+          data = bulk_from_ign<float>(reflection, *parent, field, available);
+          break;
+        case Primitive::FLOAT64:
+          data = bulk_from_ign<double>(reflection, *parent, field, available);
+          break;
+        default:
+          break;
+      }
+    }
+    else if (parent)
+    {
+      available = static_cast<size_t>(reflection->FieldSize(*parent, field));
+    }
+
+    // Fixed size arrays are truncated or padded with zeros.
+    const size_t count = op.array_length >= 0 ?
+      static_cast<size_t>(op.array_length) : available;
+    if (op.array_length < 0)
+      writer.length(count);
+    const size_t copied = std::min(count, available);
+
+    switch (op.kind)
+    {
+      case Op::Kind::BYTES_ARRAY:
+      case Op::Kind::BULK_ARRAY:
+        writer.bytes(data, copied * element_size);
+        writer.zeros((count - copied) * element_size);
+        break;
+      case Op::Kind::SCALAR_ARRAY:
+        for (size_t i = 0; i < count; ++i)
+        {
+          writer.scalar(op.primitive, i < copied ?
+            get_scalar(reflection, *parent, field, static_cast<int>(i)) :
+            Scalar());
+        }
+        break;
+      case Op::Kind::STRING_ARRAY:
+        for (size_t i = 0; i < count; ++i)
+        {
+          const std::string & value = i < copied ?
+            reflection->GetRepeatedStringReference(
+              *parent, field, static_cast<int>(i), &scratch) :
+            std::string();
+          writer.length(value.size());
+          writer.bytes(value.data(), value.size());
+        }
+        break;
+      case Op::Kind::MESSAGE_ARRAY:
+        for (size_t i = 0; i < count; ++i)
+        {
+          run_ign_to_ros1(op.level, i < copied ?
+            &reflection->GetRepeatedMessage(
+              *parent, field, static_cast<int>(i)) : nullptr,
+            writer);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+}  // namespace ros1_ign_bridge
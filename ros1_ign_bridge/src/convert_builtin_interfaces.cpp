@@ -14,6 +14,8 @@
 
 #include <algorithm>
 #include <exception>
+#include <string>
+#include <unordered_map>
 
 #include "ros1_ign_bridge/convert_builtin_interfaces.hpp"
 
@@ -492,7 +494,11 @@ convert_1_to_ign(
 
   ign_msg.set_step(ign_msg.width() * num_channels * octets_per_channel);
 
-  ign_msg.set_data(&(ros1_msg.data[0]), ign_msg.step() * ign_msg.height());
+  // Never read past the end of a truncated image.
+  const size_t size = std::min<size_t>(
+    static_cast<size_t>(ign_msg.step()) * ign_msg.height(),
+    ros1_msg.data.size());
+  ign_msg.set_data(ros1_msg.data.data(), size);
 }
 
 template<>
@@ -582,12 +588,15 @@ convert_ign_to_1(
   ros1_msg.is_bigendian = false;
   ros1_msg.step = ros1_msg.width * num_channels * octets_per_channel;
 
-  auto count = ros1_msg.step * ros1_msg.height;
-  ros1_msg.data.resize(ros1_msg.step * ros1_msg.height);
-  std::copy(
+  // assign() reuses the capacity of a recycled buffer without zeroing it
+  // first. A truncated image is padded with zeros, so that the result always
+  // holds step * height bytes.
+  const size_t count = static_cast<size_t>(ros1_msg.step) * ros1_msg.height;
+  const size_t available = std::min(count, ign_msg.data().size());
+  ros1_msg.data.assign(
     ign_msg.data().begin(),
-    ign_msg.data().begin() + count,
-    ros1_msg.data.begin());
+    ign_msg.data().begin() + available);
+  ros1_msg.data.resize(count, 0);
 }
 
 template<>
@@ -753,13 +762,24 @@ convert_1_to_ign(
 {
   convert_1_to_ign(ros1_msg.header, (*ign_msg.mutable_header()));
 
-  for (auto i = 0u; i < ros1_msg.position.size(); ++i)
+  // The arrays may have different lengths, e.g. an empty effort when it is
+  // not measured. Missing values are left at zero.
+  const size_t count = std::max(
+    std::max(ros1_msg.name.size(), ros1_msg.position.size()),
+    std::max(ros1_msg.velocity.size(), ros1_msg.effort.size()));
+  ign_msg.mutable_joint()->Reserve(static_cast<int>(count));
+  for (auto i = 0u; i < count; ++i)
   {
     auto newJoint = ign_msg.add_joint();
-    newJoint->set_name(ros1_msg.name[i]);
-    newJoint->mutable_axis1()->set_position(ros1_msg.position[i]);
-    newJoint->mutable_axis1()->set_velocity(ros1_msg.velocity[i]);
-    newJoint->mutable_axis1()->set_force(ros1_msg.effort[i]);
+    if (i < ros1_msg.name.size())
+      newJoint->set_name(ros1_msg.name[i]);
+    auto axis = newJoint->mutable_axis1();
+    if (i < ros1_msg.position.size())
+      axis->set_position(ros1_msg.position[i]);
+    if (i < ros1_msg.velocity.size())
+      axis->set_velocity(ros1_msg.velocity[i]);
+    if (i < ros1_msg.effort.size())
+      axis->set_force(ros1_msg.effort[i]);
   }
 }
 
@@ -771,6 +791,10 @@ convert_ign_to_1(
 {
   convert_ign_to_1(ign_msg.header(), ros1_msg.header);
 
+  ros1_msg.name.reserve(ign_msg.joint_size());
+  ros1_msg.position.reserve(ign_msg.joint_size());
+  ros1_msg.velocity.reserve(ign_msg.joint_size());
+  ros1_msg.effort.reserve(ign_msg.joint_size());
   for (auto i = 0; i < ign_msg.joint_size(); ++i)
   {
     ros1_msg.name.push_back(ign_msg.joint(i).name());
@@ -786,8 +810,10 @@ convert_1_to_ign(
   const sensor_msgs::LaserScan & ros1_msg,
   ignition::msgs::LaserScan & ign_msg)
 {
+  // The readings are counted from the data rather than from the angles,
+  // which may disagree with it, or divide by zero.
   const unsigned int num_readings =
-    (ros1_msg.angle_max - ros1_msg.angle_min) / ros1_msg.angle_increment;
+    static_cast<unsigned int>(ros1_msg.ranges.size());
 
   convert_1_to_ign(ros1_msg.header, (*ign_msg.mutable_header()));
   ign_msg.set_frame(ros1_msg.header.frame_id);
@@ -804,10 +830,16 @@ convert_1_to_ign(
   ign_msg.set_vertical_angle_step(0.0);
   ign_msg.set_vertical_count(0u);
 
-  for (auto i = 0u; i < ign_msg.count(); ++i)
-  {
+  ign_msg.mutable_ranges()->Reserve(num_readings);
+  for (auto i = 0u; i < num_readings; ++i)
     ign_msg.add_ranges(ros1_msg.ranges[i]);
-    ign_msg.add_intensities(ros1_msg.intensities[i]);
+
+  // Intensities are optional; partial ones can't be matched to the ranges.
+  if (ros1_msg.intensities.size() == num_readings)
+  {
+    ign_msg.mutable_intensities()->Reserve(num_readings);
+    for (auto i = 0u; i < num_readings; ++i)
+      ign_msg.add_intensities(ros1_msg.intensities[i]);
   }
 }
 
@@ -831,25 +863,35 @@ convert_ign_to_1(
   ros1_msg.range_min = ign_msg.range_min();
   ros1_msg.range_max = ign_msg.range_max();
 
-  auto count = ign_msg.count();
-  auto vertical_count = ign_msg.vertical_count();
+  size_t count = ign_msg.count();
+  const size_t vertical_count = ign_msg.vertical_count();
+  const size_t num_ranges = static_cast<size_t>(ign_msg.ranges_size());
 
-  // If there are multiple vertical beams, use the one in the middle.
+  // If there are multiple vertical beams, use the one in the middle. Fall
+  // back to the first readings when the counts don't match the data.
   size_t start = (vertical_count / 2) * count;
+  if (count > num_ranges || start > num_ranges - count)
+  {
+    start = 0;
+    count = std::min(count, num_ranges);
+  }
 
   // Copy ranges into ROS message.
-  ros1_msg.ranges.resize(count);
-  std::copy(
+  ros1_msg.ranges.assign(
     ign_msg.ranges().begin() + start,
-    ign_msg.ranges().begin() + start + count,
-    ros1_msg.ranges.begin());
+    ign_msg.ranges().begin() + start + count);
 
-  // Copy intensities into ROS message.
-  ros1_msg.intensities.resize(count);
-  std::copy(
-    ign_msg.intensities().begin() + start,
-    ign_msg.intensities().begin() + start + count,
-    ros1_msg.intensities.begin());
+  // Copy intensities into ROS message, when there are enough of them.
+  if (start + count <= static_cast<size_t>(ign_msg.intensities_size()))
+  {
+    ros1_msg.intensities.assign(
+      ign_msg.intensities().begin() + start,
+      ign_msg.intensities().begin() + start + count);
+  }
+  else
+  {
+    ros1_msg.intensities.clear();
+  }
 }
 
 template<>
@@ -898,4 +940,240 @@ convert_ign_to_1(
             << "[sensor_msgs::PointCloud2]" << std::endl;
 }
 
+namespace
+{
+
+// Model names repeat every simulation step, so each thread keeps the TF
+// version of the frame ids it has seen. The cache is bounded in case the
+// names are generated, and emptied when full: callers copy the result before
+// the next lookup rather than keep a reference to it.
+const std::string & cached_frame_id_ign_to_1(const std::string &frame_id)
+{
+  thread_local std::unordered_map<std::string, std::string> cache;
+  auto it = cache.find(frame_id);
+  if (it != cache.end())
+    return it->second;
+
+  if (cache.size() >= 4096)
+    cache.clear();
+  return cache.emplace(frame_id, frame_id_ign_to_1(frame_id)).first->second;
+}
+
+}  // namespace
+
+template<>
+void
+convert_1_to_ign(
+  const tf2_msgs::TFMessage & ros1_msg,
+  ignition::msgs::Pose_V & ign_msg)
+{
+  if (!ros1_msg.transforms.empty())
+  {
+    const auto & stamp = ros1_msg.transforms.front().header.stamp;
+    ign_msg.mutable_header()->mutable_stamp()->set_sec(stamp.sec);
+    ign_msg.mutable_header()->mutable_stamp()->set_nsec(stamp.nsec);
+  }
+
+  ign_msg.mutable_pose()->Reserve(ros1_msg.transforms.size());
+  for (const auto & transform : ros1_msg.transforms)
+  {
+    auto pose = ign_msg.add_pose();
+    convert_1_to_ign(transform, *pose);
+    pose->set_name(transform.child_frame_id);
+  }
+}
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Pose_V & ign_msg,
+  tf2_msgs::TFMessage & ros1_msg)
+{
+  // Poses without a stamp or a parent frame take those of the vector.
+  const ros::Time stamp(ign_msg.header().stamp().sec(),
+                        ign_msg.header().stamp().nsec());
+  bool has_frame_id = false;
+  std::string frame_id;
+  for (const auto & aPair : ign_msg.header().data())
+  {
+    if (aPair.key() == "frame_id" && aPair.value_size() > 0)
+    {
+      has_frame_id = true;
+      frame_id = cached_frame_id_ign_to_1(aPair.value(0));
+    }
+  }
+
+  ros1_msg.transforms.resize(ign_msg.pose_size());
+  for (auto i = 0; i < ign_msg.pose_size(); ++i)
+  {
+    const auto & pose = ign_msg.pose(i);
+    auto & transform = ros1_msg.transforms[i];
+
+    transform.header.stamp = pose.header().has_stamp() ?
+      ros::Time(pose.header().stamp().sec(), pose.header().stamp().nsec()) :
+      stamp;
+    if (has_frame_id)
+      transform.header.frame_id = frame_id;
+    transform.child_frame_id = cached_frame_id_ign_to_1(pose.name());
+    for (const auto & aPair : pose.header().data())
+    {
+      if (aPair.value_size() == 0)
+        continue;
+      if (aPair.key() == "frame_id")
+        transform.header.frame_id = cached_frame_id_ign_to_1(aPair.value(0));
+      else if (aPair.key() == "child_frame_id")
+        transform.child_frame_id = cached_frame_id_ign_to_1(aPair.value(0));
+    }
+
+    convert_ign_to_1(pose, transform.transform);
+  }
+}
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::Empty::Request & /*ros1_msg*/,
+  ignition::msgs::Empty & /*ign_msg*/)
+{
+}
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Empty & /*ign_msg*/,
+  std_srvs::Empty::Request & /*ros1_msg*/)
+{
+}
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::Empty::Response & /*ros1_msg*/,
+  ignition::msgs::Empty & /*ign_msg*/)
+{
+}
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Empty & /*ign_msg*/,
+  std_srvs::Empty::Response & /*ros1_msg*/)
+{
+}
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::SetBool::Request & ros1_msg,
+  ignition::msgs::Boolean & ign_msg)
+{
+  ign_msg.set_data(ros1_msg.data);
+}
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Boolean & ign_msg,
+  std_srvs::SetBool::Request & ros1_msg)
+{
+  ros1_msg.data = ign_msg.data();
+}
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::SetBool::Response & ros1_msg,
+  ignition::msgs::Boolean & ign_msg)
+{
+  // The message isn't supported in ignition::msgs::Boolean.
+  ign_msg.set_data(ros1_msg.success);
+}
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Boolean & ign_msg,
+  std_srvs::SetBool::Response & ros1_msg)
+{
+  ros1_msg.success = ign_msg.data();
+}
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::Trigger::Request & /*ros1_msg*/,
+  ignition::msgs::Empty & /*ign_msg*/)
+{
+}
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Empty & /*ign_msg*/,
+  std_srvs::Trigger::Request & /*ros1_msg*/)
+{
+}
+
+template<>
+void
+convert_1_to_ign(
+  const std_srvs::Trigger::Response & ros1_msg,
+  ignition::msgs::Boolean & ign_msg)
+{
+  // The message isn't supported in ignition::msgs::Boolean.
+  ign_msg.set_data(ros1_msg.success);
+}
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Boolean & ign_msg,
+  std_srvs::Trigger::Response & ros1_msg)
+{
+  ros1_msg.success = ign_msg.data();
+}
+
+template<>
+void
+convert_1_to_ign(
+  const ros1_ign_bridge::ControlWorld::Request & ros1_msg,
+  ignition::msgs::WorldControl & ign_msg)
+{
+  ign_msg.set_pause(ros1_msg.pause);
+  ign_msg.set_step(ros1_msg.step);
+  ign_msg.set_multi_step(ros1_msg.multi_step);
+  if (ros1_msg.reset)
+    ign_msg.mutable_reset()->set_all(true);
+}
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::WorldControl & ign_msg,
+  ros1_ign_bridge::ControlWorld::Request & ros1_msg)
+{
+  ros1_msg.pause = ign_msg.pause();
+  ros1_msg.step = ign_msg.step();
+  ros1_msg.multi_step = ign_msg.multi_step();
+  ros1_msg.reset = ign_msg.has_reset() && ign_msg.reset().all();
+}
+
+template<>
+void
+convert_1_to_ign(
+  const ros1_ign_bridge::ControlWorld::Response & ros1_msg,
+  ignition::msgs::Boolean & ign_msg)
+{
+  ign_msg.set_data(ros1_msg.success);
+}
+
+template<>
+void
+convert_ign_to_1(
+  const ignition::msgs::Boolean & ign_msg,
+  ros1_ign_bridge::ControlWorld::Response & ros1_msg)
+{
+  ros1_msg.success = ign_msg.data();
+}
+
 }  // namespace ros1_ign_bridge
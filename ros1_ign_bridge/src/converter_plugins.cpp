@@ -0,0 +1,115 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pluginlib/class_loader.h>
+
+#include "ros1_ign_bridge/converter_plugin.hpp"
+#include "ros1_ign_bridge/converter_plugins.hpp"
+
+namespace ros1_ign_bridge
+{
+
+namespace
+{
+
+/// \brief Lazily created loader and the plugins loaded so far.
+struct PluginCache
+{
+  PluginCache()
+  : loader("ros1_ign_bridge", "ros1_ign_bridge::ConverterPlugin")
+  {}
+
+  // Declared first so that the plugins are destroyed before their loader.
+  pluginlib::ClassLoader<ConverterPlugin> loader;
+  std::map<std::string, boost::shared_ptr<ConverterPlugin>> plugins;
+  std::mutex mutex;
+};
+
+PluginCache &
+plugin_cache()
+{
+  static PluginCache cache;
+  return cache;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+std::shared_ptr<FactoryInterface>
+get_factory_from_plugins(
+  const std::string & ros1_type_name,
+  const std::string & ign_type_name)
+{
+  const std::string lookup_name = ros1_type_name + "@" + ign_type_name;
+
+  PluginCache & cache = plugin_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+
+  auto & plugin = cache.plugins[lookup_name];
+  if (!plugin)
+  {
+    if (!cache.loader.isClassAvailable(lookup_name))
+    {
+      cache.plugins.erase(lookup_name);
+      return nullptr;
+    }
+
+    try
+    {
+      plugin = cache.loader.createInstance(lookup_name);
+    }
+    catch (pluginlib::PluginlibException & e)
+    {
+      cache.plugins.erase(lookup_name);
+      std::cerr << "Failed to load the converter plugin [" << lookup_name
+                << "]: " << e.what() << std::endl;
+      return nullptr;
+    }
+  }
+
+  return plugin->create_factory(ros1_type_name, ign_type_name);
+}
+
+//////////////////////////////////////////////////
+std::vector<std::pair<std::string, std::string>>
+get_plugin_type_pairs()
+{
+  PluginCache & cache = plugin_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+
+  std::vector<std::pair<std::string, std::string>> pairs;
+  for (const auto & lookup_name : cache.loader.getDeclaredClasses())
+  {
+    const auto separator = lookup_name.find('@');
+    if (separator == std::string::npos)
+    {
+      std::cerr << "Ignoring converter plugin [" << lookup_name << "]: its "
+                << "name must be <ROS1_type>@<Ign_type>" << std::endl;
+      continue;
+    }
+    pairs.emplace_back(lookup_name.substr(0, separator),
+                       lookup_name.substr(separator + 1));
+  }
+  return pairs;
+}
+
+}  // namespace ros1_ign_bridge
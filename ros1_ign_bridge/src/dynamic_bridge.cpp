@@ -0,0 +1,322 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// include ROS 1
+#ifdef __clang__
+# pragma clang diagnostic push
+# pragma clang diagnostic ignored "-Wunused-parameter"
+#endif
+#include <ros/master.h>
+#include <ros/ros.h>
+#ifdef __clang__
+# pragma clang diagnostic pop
+#endif
+
+// include Ignition Transport
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge.hpp"
+#include "ros1_ign_bridge/bridge_config.hpp"
+#include "ros1_ign_bridge/converter_plugins.hpp"
+
+/// \brief Bridges every topic with a known type pair, creating and removing
+/// bridges as publishers come and go on either side.
+class DynamicBridge
+{
+public:
+  DynamicBridge(
+    ros::NodeHandle ros1_node,
+    std::shared_ptr<ignition::transport::Node> ign_node,
+    size_t queue_size)
+  : ros1_node_(ros1_node),
+    ign_node_(ign_node),
+    queue_size_(queue_size)
+  {
+    // Builtin pairs come first so that plugins can't override them. Plugin
+    // libraries are only loaded once a topic of theirs shows up.
+    auto pairs = ros1_ign_bridge::get_builtin_interfaces_type_pairs();
+    auto plugin_pairs = ros1_ign_bridge::get_plugin_type_pairs();
+    pairs.insert(pairs.end(), plugin_pairs.begin(), plugin_pairs.end());
+    for (const auto & pair : pairs)
+    {
+      // Keep the first, preferred, counterpart of each type.
+      ros1_to_ign_types_.insert(pair);
+      ign_to_ros1_types_.insert(std::make_pair(pair.second, pair.first));
+    }
+  }
+
+  ~DynamicBridge()
+  {
+    for (auto & bridge : ros1_to_ign_)
+      ros1_ign_bridge::shutdown_bridge(bridge.second);
+    for (auto & bridge : ign_to_ros1_)
+      ros1_ign_bridge::shutdown_bridge(bridge.second);
+  }
+
+  /// \brief Compare the current topics on both sides with the previous scan
+  /// and update the bridges accordingly.
+  void
+  scan()
+  {
+    std::unordered_map<std::string, std::string> ros1_topics;
+    if (get_ros1_published_topics(ros1_topics))
+      update_ros1_to_ign(ros1_topics);
+
+    std::vector<std::string> ign_topics;
+    if (ign_node_->TopicList(ign_topics))
+      update_ign_to_ros1(ign_topics);
+  }
+
+private:
+  /// \brief Topics with at least one publisher other than this node, and
+  /// their types.
+  bool
+  get_ros1_published_topics(
+    std::unordered_map<std::string, std::string> & topics)
+  {
+    ros::master::V_TopicInfo topic_infos;
+    if (!ros::master::getTopics(topic_infos))
+      return false;
+
+    XmlRpc::XmlRpcValue args, result, payload;
+    args[0] = ros::this_node::getName();
+    if (!ros::master::execute("getSystemState", args, result, payload, true))
+      return false;
+
+    // payload[0] is the list of [topic, [publisher nodes]].
+    std::unordered_set<std::string> external;
+    XmlRpc::XmlRpcValue & publishers = payload[0];
+    for (int i = 0; i < publishers.size(); ++i)
+    {
+      XmlRpc::XmlRpcValue & nodes = publishers[i][1];
+      for (int j = 0; j < nodes.size(); ++j)
+      {
+        if (static_cast<std::string>(nodes[j]) != ros::this_node::getName())
+        {
+          external.insert(static_cast<std::string>(publishers[i][0]));
+          break;
+        }
+      }
+    }
+
+    for (const auto & info : topic_infos)
+    {
+      if (external.count(info.name) > 0)
+        topics[info.name] = info.datatype;
+    }
+    return true;
+  }
+
+  void
+  update_ros1_to_ign(
+    const std::unordered_map<std::string, std::string> & topics)
+  {
+    // Remove the bridges whose external publishers are gone.
+    for (auto it = ros1_to_ign_.begin(); it != ros1_to_ign_.end();)
+    {
+      if (topics.count(it->first) == 0)
+      {
+        std::cout << "Removing bridge for ROS 1 topic [" << it->first << "]"
+                  << std::endl;
+        ros1_ign_bridge::shutdown_bridge(it->second);
+        ign_pending_.insert(it->first);
+        it = ros1_to_ign_.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    for (const auto & topic : topics)
+    {
+      // Topics we publish ourselves, or already bridge, are skipped.
+      if (ros1_to_ign_.count(topic.first) > 0 ||
+          ign_to_ros1_.count(topic.first) > 0)
+      {
+        continue;
+      }
+
+      auto type = ros1_to_ign_types_.find(topic.second);
+      if (type == ros1_to_ign_types_.end())
+        continue;
+
+      try
+      {
+        ros1_to_ign_[topic.first] =
+          ros1_ign_bridge::create_bridge_from_ros_to_ign(
+            ros1_node_, ign_node_,
+            topic.second, topic.first, queue_size_,
+            type->second, topic.first, queue_size_);
+        std::cout << "Bridging ROS 1 topic [" << topic.first << "] ("
+                  << topic.second << " -> " << type->second << ")"
+                  << std::endl;
+      }
+      catch (std::runtime_error &_e)
+      {
+        std::cerr << "Failed to bridge ROS 1 topic [" << topic.first << "]: "
+                  << _e.what() << std::endl;
+      }
+    }
+  }
+
+  void
+  update_ign_to_ros1(std::vector<std::string> & topics)
+  {
+    std::sort(topics.begin(), topics.end());
+
+    // Only the topics that appeared or disappeared since the last scan, plus
+    // the ones that became eligible again or couldn't be bridged yet, are
+    // looked at.
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    std::set_difference(
+      topics.begin(), topics.end(),
+      ign_topics_.begin(), ign_topics_.end(),
+      std::back_inserter(added));
+    std::set_difference(
+      ign_topics_.begin(), ign_topics_.end(),
+      topics.begin(), topics.end(),
+      std::back_inserter(removed));
+    ign_topics_.swap(topics);
+
+    for (const auto & topic : removed)
+    {
+      ign_pending_.erase(topic);
+      auto bridge = ign_to_ros1_.find(topic);
+      if (bridge == ign_to_ros1_.end())
+        continue;
+      std::cout << "Removing bridge for Ignition topic [" << topic << "]"
+                << std::endl;
+      ros1_ign_bridge::shutdown_bridge(bridge->second);
+      ign_to_ros1_.erase(bridge);
+    }
+
+    for (const auto & topic : ign_pending_)
+    {
+      if (std::binary_search(ign_topics_.begin(), ign_topics_.end(), topic))
+        added.push_back(topic);
+    }
+    ign_pending_.clear();
+
+    for (const auto & topic : added)
+    {
+      // Topics published by our own ROS 1 -> Ignition bridges are skipped,
+      // they are looked at again once that bridge goes away.
+      if (ign_to_ros1_.count(topic) > 0 || ros1_to_ign_.count(topic) > 0)
+        continue;
+
+      // A topic is often listed before its publisher is known, and a
+      // publisher of another type may come later, so both are retried at
+      // the next scan for as long as the topic is listed.
+      std::vector<ignition::transport::MessagePublisher> publishers;
+      if (!ign_node_->TopicInfo(topic, publishers) || publishers.empty())
+      {
+        ign_pending_.insert(topic);
+        continue;
+      }
+
+      const std::string ign_type_name = publishers.front().MsgTypeName();
+      auto type = ign_to_ros1_types_.find(ign_type_name);
+      if (type == ign_to_ros1_types_.end())
+      {
+        ign_pending_.insert(topic);
+        continue;
+      }
+
+      try
+      {
+        ign_to_ros1_[topic] =
+          ros1_ign_bridge::create_bridge_from_ign_to_ros(
+            ign_node_, ros1_node_,
+            ign_type_name, topic, queue_size_,
+            type->second, topic, queue_size_);
+        std::cout << "Bridging Ignition topic [" << topic << "] ("
+                  << ign_type_name << " -> " << type->second << ")"
+                  << std::endl;
+      }
+      catch (std::runtime_error &_e)
+      {
+        std::cerr << "Failed to bridge Ignition topic [" << topic << "]: "
+                  << _e.what() << std::endl;
+      }
+    }
+  }
+
+  ros::NodeHandle ros1_node_;
+  std::shared_ptr<ignition::transport::Node> ign_node_;
+  size_t queue_size_;
+
+  /// \brief Preferred counterpart of each type with a factory.
+  std::map<std::string, std::string> ros1_to_ign_types_;
+  std::map<std::string, std::string> ign_to_ros1_types_;
+
+  /// \brief Active bridges indexed by topic name.
+  std::map<std::string, ros1_ign_bridge::Bridge1toIgnHandles> ros1_to_ign_;
+  std::map<std::string, ros1_ign_bridge::BridgeIgnto1Handles> ign_to_ros1_;
+
+  /// \brief Sorted Ignition topic list of the previous scan.
+  std::vector<std::string> ign_topics_;
+
+  /// \brief Ignition topics to look at again in the next scan.
+  std::set<std::string> ign_pending_;
+};
+
+//////////////////////////////////////////////////
+int main(int argc, char * argv[])
+{
+  // ROS 1 node
+  ros::init(argc, argv, "ros_ign_dynamic_bridge");
+  ros::NodeHandle ros1_node;
+  ros::NodeHandle private_node("~");
+
+  double scan_period = private_node.param("scan_period", 1.0);
+  int queue_size = private_node.param("queue_size", 10);
+  if (scan_period <= 0.0 || queue_size < 0)
+  {
+    std::cerr << "[~scan_period] must be positive and [~queue_size] must not "
+              << "be negative" << std::endl;
+    return -1;
+  }
+
+  // Ignition node
+  auto ign_node = std::make_shared<ignition::transport::Node>();
+
+  // ROS 1 asynchronous spinner
+  ros::AsyncSpinner async_spinner(1);
+  async_spinner.start();
+
+  DynamicBridge bridge(ros1_node, ign_node, static_cast<size_t>(queue_size));
+
+  ros::WallRate rate(1.0 / scan_period);
+  while (ros::ok())
+  {
+    bridge.scan();
+    rate.sleep();
+  }
+
+  return 0;
+}
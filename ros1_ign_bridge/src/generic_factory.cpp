@@ -0,0 +1,283 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// include ROS 1
+#include <ros/ros.h>
+#include <topic_tools/shape_shifter.h>
+
+// include Ignition Transport
+#include <ignition/msgs/Factory.hh>
+
+#include "ros1_ign_bridge/generic_factory.hpp"
+#include "ros1_ign_bridge/ign_publish_queue.hpp"
+#include "ros1_ign_bridge/trace.hpp"
+
+namespace ros1_ign_bridge
+{
+
+namespace
+{
+
+void
+ros1_callback(
+  const ros::MessageEvent<topic_tools::ShapeShifter const> & ros1_msg_event,
+  ignition::transport::Node::Publisher ign_pub,
+  const std::string & ros1_type_name,
+  const std::string & ign_type_name,
+  std::shared_ptr<const ConversionPlan> plan,
+  std::shared_ptr<BridgeState> state)
+{
+  ROS1_IGN_BRIDGE_TRACE_SCOPE("ros1_callback", state->trace_label);
+
+  const boost::shared_ptr<ros::M_string> & connection_header =
+    ros1_msg_event.getConnectionHeaderPtr();
+  if (!connection_header)
+  {
+    std::cerr << "  dropping message without connection header" << std::endl;
+    return;
+  }
+
+  auto callerid = connection_header->find("callerid");
+  if (callerid != connection_header->end() &&
+      callerid->second == ros::this_node::getName())
+  {
+    state->stats.echo_filtered.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  const int64_t start_ns = steady_now_ns();
+  state->stats.messages_in.fetch_add(1, std::memory_order_relaxed);
+
+  if (state->lazy && !ign_pub.HasConnections())
+    return;
+
+  if (!state->rate_limiter.allow())
+  {
+    state->stats.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  const auto & ros1_msg = ros1_msg_event.getConstMessage();
+
+  // Publishers advertising "*", like topic_tools relays, connect whatever
+  // their type.
+  if (ros1_msg->getDataType() != ros1_type_name)
+  {
+    state->stats.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  thread_local std::vector<uint8_t> buffer;
+  buffer.resize(ros1_msg->size());
+  ros::serialization::OStream stream(buffer.data(), buffer.size());
+  ros1_msg->write(stream);
+
+  auto ign_msg = ignition::msgs::Factory::New(ign_type_name);
+  try
+  {
+    ROS1_IGN_BRIDGE_TRACE_SCOPE("convert_1_to_ign", state->trace_label);
+    plan->ros1_to_ign(buffer.data(), buffer.size(), *ign_msg);
+  }
+  catch (const std::exception & e)
+  {
+    std::cerr << "Failed to convert a [" << ros1_msg->getDataType()
+              << "] message: " << e.what() << std::endl;
+    state->stats.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  if (state->publish_queue)
+  {
+    state->publish_queue->push(std::move(ign_msg), start_ns,
+      state->stats.sample_sizes(), buffer.size());
+    return;
+  }
+
+  {
+    ROS1_IGN_BRIDGE_TRACE_SCOPE("ign_publish", state->trace_label);
+    ign_pub.Publish(*ign_msg);
+  }
+
+  state->stats.record_forwarded(start_ns);
+  if (state->stats.sample_sizes())
+    state->stats.record_sizes(buffer.size(), ign_msg->ByteSizeLong());
+}
+
+void
+ign_callback(
+  const google::protobuf::Message & ign_msg,
+  ros::Publisher ros1_pub,
+  const std::string & ros1_type_name,
+  const std::string & definition,
+  std::shared_ptr<const ConversionPlan> plan,
+  std::shared_ptr<BridgeState> state)
+{
+  ROS1_IGN_BRIDGE_TRACE_SCOPE("ign_callback", state->trace_label);
+
+  if (ign_msg.GetDescriptor() != plan->descriptor())
+    return;
+
+  const int64_t start_ns = steady_now_ns();
+  state->stats.messages_in.fetch_add(1, std::memory_order_relaxed);
+
+  if (!state->rate_limiter.allow())
+  {
+    state->stats.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  thread_local std::vector<uint8_t> buffer;
+  topic_tools::ShapeShifter ros1_msg;
+  {
+    ROS1_IGN_BRIDGE_TRACE_SCOPE("convert_ign_to_1", state->trace_label);
+    plan->ign_to_ros1(ign_msg, buffer);
+    ros1_msg.morph(plan->md5sum(), ros1_type_name, definition, "false");
+    ros::serialization::IStream stream(buffer.data(), buffer.size());
+    ros1_msg.read(stream);
+  }
+  {
+    ROS1_IGN_BRIDGE_TRACE_SCOPE("ros1_publish", state->trace_label);
+    ros1_pub.publish(ros1_msg);
+  }
+
+  state->stats.record_forwarded(start_ns);
+  if (state->stats.sample_sizes())
+    state->stats.record_sizes(ign_msg.ByteSizeLong(), buffer.size());
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+GenericFactory::GenericFactory(
+  const std::string & ros1_type_name,
+  const std::string & ign_type_name,
+  const std::map<std::string, std::string> & field_mappings)
+: ros1_type_name_(ros1_type_name),
+  ign_type_name_(ign_type_name)
+{
+  RosMessageSpecs specs;
+  load_ros_message_specs(ros1_type_name, specs, definition_);
+
+  auto ign_msg = ignition::msgs::Factory::New(ign_type_name);
+  if (!ign_msg)
+  {
+    throw std::runtime_error(
+      "Unknown Ignition message type [" + ign_type_name + "]");
+  }
+
+  // Descriptors live in the generated pool for the whole process.
+  plan_ = std::make_shared<ConversionPlan>(
+    ros1_type_name, specs, ign_msg->GetDescriptor(), field_mappings);
+}
+
+//////////////////////////////////////////////////
+ros::Publisher
+GenericFactory::create_ros1_publisher(
+  ros::NodeHandle node,
+  const std::string & topic_name,
+  size_t queue_size,
+  const ros::SubscriberStatusCallback & connect_cb,
+  const ros::SubscriberStatusCallback & disconnect_cb)
+{
+  ros::AdvertiseOptions ops(topic_name, static_cast<uint32_t>(queue_size),
+    plan_->md5sum(), ros1_type_name_, definition_, connect_cb,
+    disconnect_cb);
+  return node.advertise(ops);
+}
+
+//////////////////////////////////////////////////
+ignition::transport::Node::Publisher
+GenericFactory::create_ign_publisher(
+  std::shared_ptr<ignition::transport::Node> ign_node,
+  const std::string & topic_name,
+  size_t /*queue_size*/,
+  size_t msgs_per_sec)
+{
+  return ign_node->Advertise(topic_name, ign_type_name_,
+    ign_advertise_options(msgs_per_sec));
+}
+
+//////////////////////////////////////////////////
+ros::Subscriber
+GenericFactory::create_ros1_subscriber(
+  ros::NodeHandle node,
+  const std::string & topic_name,
+  size_t queue_size,
+  ignition::transport::Node::Publisher & ign_pub,
+  std::shared_ptr<BridgeState> state)
+{
+  ros::SubscribeOptions ops;
+  ops.topic = topic_name;
+  ops.queue_size = static_cast<uint32_t>(queue_size);
+  ops.md5sum = plan_->md5sum();
+  ops.datatype = ros1_type_name_;
+  ops.helper = ros::SubscriptionCallbackHelperPtr(
+    new ros::SubscriptionCallbackHelperT
+      <const ros::MessageEvent<topic_tools::ShapeShifter const> &>(
+        boost::bind(&ros1_callback, _1, ign_pub, ros1_type_name_,
+                    ign_type_name_, plan_, state)));
+  return node.subscribe(ops);
+}
+
+//////////////////////////////////////////////////
+void
+GenericFactory::create_ign_subscriber(
+  std::shared_ptr<ignition::transport::Node> node,
+  const std::string & topic_name,
+  size_t /*queue_size*/,
+  ros::Publisher ros1_pub,
+  std::shared_ptr<BridgeState> state,
+  size_t msgs_per_sec)
+{
+  auto plan = plan_;
+  const std::string ros1_type_name = ros1_type_name_;
+  const std::string definition = definition_;
+  std::function<void(const google::protobuf::Message &,
+                     const ignition::transport::MessageInfo &)> subCb =
+    [ros1_pub, ros1_type_name, definition, plan, state](
+      const google::protobuf::Message & _msg,
+      const ignition::transport::MessageInfo &)
+    {
+      ign_callback(_msg, ros1_pub, ros1_type_name, definition, plan, state);
+    };
+
+  node->Subscribe(topic_name, subCb, ign_subscribe_options(msgs_per_sec));
+}
+
+//////////////////////////////////////////////////
+bool
+GenericFactory::forward_ign_serialized(
+  const char * data,
+  size_t size,
+  ros::Publisher ros1_pub,
+  std::shared_ptr<BridgeState> state)
+{
+  auto ign_msg = ignition::msgs::Factory::New(ign_type_name_);
+  if (!ign_msg || !ign_msg->ParseFromArray(data, static_cast<int>(size)))
+    return false;
+  ign_callback(*ign_msg, ros1_pub, ros1_type_name_, definition_, plan_, state);
+  return true;
+}
+
+}  // namespace ros1_ign_bridge
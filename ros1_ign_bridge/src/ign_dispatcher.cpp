@@ -0,0 +1,252 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "ros1_ign_bridge/ign_dispatcher.hpp"
+
+namespace ros1_ign_bridge
+{
+
+//////////////////////////////////////////////////
+IgnDispatcher::IgnDispatcher(size_t num_nodes, size_t num_threads)
+: routes_(new RouteTable())
+{
+  for (size_t i = 0; i < std::max<size_t>(num_nodes, 1); ++i)
+    nodes_.push_back(std::make_shared<ignition::transport::Node>());
+
+  for (size_t i = 0; i < std::max<size_t>(num_threads, 1); ++i)
+    workers_.emplace_back(new Worker());
+  for (auto & worker : workers_)
+    worker->thread = std::thread(&IgnDispatcher::run, this, std::ref(*worker));
+}
+
+//////////////////////////////////////////////////
+IgnDispatcher::~IgnDispatcher()
+{
+  stop();
+  // The nodes go first, so that no callback runs during the destruction of
+  // the other members.
+  nodes_.clear();
+  delete routes_.load();
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<ignition::transport::Node>
+IgnDispatcher::node(const std::string & topic_name) const
+{
+  return nodes_[std::hash<std::string>()(topic_name) % nodes_.size()];
+}
+
+//////////////////////////////////////////////////
+bool
+IgnDispatcher::subscribe(
+  const std::string & topic_name,
+  const std::string & ign_type_name,
+  std::shared_ptr<FactoryInterface> factory,
+  ros::Publisher ros1_pub,
+  std::shared_ptr<BridgeState> state,
+  size_t queue_size,
+  size_t msgs_per_sec)
+{
+  if (!running_)
+    return false;
+
+  auto route = std::make_shared<Route>();
+  route->factory = factory;
+  route->ros1_pub = ros1_pub;
+  route->state = state;
+  route->worker = std::hash<std::string>()(topic_name) % workers_.size();
+  route->queue_size = std::max<size_t>(queue_size, 1);
+
+  uint32_t route_id;
+  std::shared_ptr<Route> replaced;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto inserted = route_ids_.emplace(
+      topic_name, static_cast<uint32_t>(route_ids_.size()));
+    route_id = inserted.first->second;
+    replaced = set_route(route_id, route);
+  }
+  // Like unsubscribe(), so that the old callback doesn't deliver twice.
+  if (replaced)
+  {
+    node(topic_name)->Unsubscribe(topic_name);
+    deactivate(*replaced);
+  }
+
+  // Capturing no more than this and the id keeps the callback within the
+  // small buffer of std::function.
+  auto callback = [this, route_id](const char * data, const size_t size,
+                                   const ignition::transport::MessageInfo &)
+    {
+      on_message(route_id, data, size);
+    };
+  if (!node(topic_name)->SubscribeRaw(topic_name, callback, ign_type_name,
+        ign_subscribe_options(msgs_per_sec)))
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_route(route_id, nullptr);
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void
+IgnDispatcher::unsubscribe(const std::string & topic_name)
+{
+  node(topic_name)->Unsubscribe(topic_name);
+
+  std::shared_ptr<Route> route;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = route_ids_.find(topic_name);
+    if (it != route_ids_.end())
+      route = set_route(it->second, nullptr);
+  }
+  if (route)
+    deactivate(*route);
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<IgnDispatcher::Route>
+IgnDispatcher::set_route(uint32_t route_id, std::shared_ptr<Route> route)
+{
+  std::unique_ptr<RouteTable> table(new RouteTable(*routes_.load()));
+  if (route_id >= table->size())
+    table->resize(route_id + 1);
+  std::shared_ptr<Route> replaced = (*table)[route_id];
+  (*table)[route_id] = route;
+
+  retired_.emplace_back(routes_.exchange(table.release()));
+  // A reader that loaded one of the retired tables counted itself before,
+  // so none is left once the count is seen at zero after the exchange.
+  if (readers_.load() == 0)
+    retired_.clear();
+  return replaced;
+}
+
+//////////////////////////////////////////////////
+void
+IgnDispatcher::deactivate(Route & route)
+{
+  route.active = false;
+  std::lock_guard<std::mutex> lock(workers_[route.worker]->mutex);
+  route.items.clear();
+}
+
+//////////////////////////////////////////////////
+void
+IgnDispatcher::stop()
+{
+  if (!running_.exchange(false))
+    return;
+
+  for (auto & worker : workers_)
+  {
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      for (auto & route : worker->ready)
+        route->items.clear();
+      worker->ready.clear();
+    }
+    worker->condition.notify_all();
+    worker->thread.join();
+  }
+}
+
+//////////////////////////////////////////////////
+void
+IgnDispatcher::on_message(uint32_t route_id, const char * data, size_t size)
+{
+  if (!running_)
+    return;
+
+  std::shared_ptr<Route> route;
+  readers_.fetch_add(1);
+  const RouteTable & routes = *routes_.load();
+  if (route_id < routes.size())
+    route = routes[route_id];
+  readers_.fetch_sub(1);
+  if (!route)
+    return;
+
+  Worker & worker = *workers_[route->worker];
+  {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (!route->active)
+      return;
+    if (route->items.size() >= route->queue_size)
+    {
+      route->items.pop_front();
+      route->state->stats.queue_dropped.fetch_add(1,
+        std::memory_order_relaxed);
+    }
+    route->items.emplace_back(data, size);
+    if (route->ready)
+      return;
+    route->ready = true;
+    worker.ready.push_back(route);
+  }
+  worker.condition.notify_one();
+}
+
+//////////////////////////////////////////////////
+void
+IgnDispatcher::run(Worker & worker)
+{
+  std::unique_lock<std::mutex> lock(worker.mutex);
+  while (true)
+  {
+    worker.condition.wait(lock,
+      [this, &worker] { return !running_ || !worker.ready.empty(); });
+    if (!running_)
+      break;
+
+    // One message per route, which goes back to the end of the list while it
+    // has more, so that the topics of the worker take turns.
+    std::shared_ptr<Route> route = std::move(worker.ready.front());
+    worker.ready.pop_front();
+    if (route->items.empty())
+    {
+      route->ready = false;
+      continue;
+    }
+    std::string data = std::move(route->items.front());
+    route->items.pop_front();
+    if (route->items.empty())
+      route->ready = false;
+    else
+      worker.ready.push_back(route);
+    lock.unlock();
+
+    if (route->active &&
+        !route->factory->forward_ign_serialized(
+          data.data(), data.size(), route->ros1_pub, route->state))
+    {
+      route->state->stats.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    route.reset();
+
+    lock.lock();
+  }
+}
+
+}  // namespace ros1_ign_bridge
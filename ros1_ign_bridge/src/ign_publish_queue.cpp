@@ -0,0 +1,118 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "ros1_ign_bridge/ign_publish_queue.hpp"
+#include "ros1_ign_bridge/trace.hpp"
+
+namespace ros1_ign_bridge
+{
+
+//////////////////////////////////////////////////
+IgnPublishQueue::IgnPublishQueue(
+  const ignition::transport::Node::Publisher & publisher,
+  size_t capacity,
+  QueuePolicy policy,
+  BridgeStats & stats,
+  uint32_t trace_label)
+: publisher_(publisher),
+  capacity_(std::max<size_t>(capacity, 1)),
+  policy_(policy),
+  stats_(stats),
+  trace_label_(trace_label)
+{
+  thread_ = std::thread(&IgnPublishQueue::run, this);
+}
+
+//////////////////////////////////////////////////
+IgnPublishQueue::~IgnPublishQueue()
+{
+  stop();
+}
+
+//////////////////////////////////////////////////
+bool
+IgnPublishQueue::push(
+  std::unique_ptr<google::protobuf::Message> msg,
+  int64_t start_ns,
+  bool sampled,
+  uint64_t in_bytes)
+{
+  bool dropped = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_)
+      return false;
+
+    if (items_.size() >= capacity_)
+    {
+      dropped = true;
+      stats_.queue_dropped.fetch_add(1, std::memory_order_relaxed);
+      if (policy_ == QueuePolicy::DROP_NEWEST)
+        return false;
+      items_.pop_front();
+    }
+    items_.push_back(Item{std::move(msg), start_ns, sampled, in_bytes});
+  }
+  condition_.notify_one();
+  return !dropped;
+}
+
+//////////////////////////////////////////////////
+void
+IgnPublishQueue::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_)
+      return;
+    running_ = false;
+    items_.clear();
+  }
+  condition_.notify_all();
+  thread_.join();
+}
+
+//////////////////////////////////////////////////
+void
+IgnPublishQueue::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    condition_.wait(lock, [this] { return !running_ || !items_.empty(); });
+    if (!running_)
+      break;
+
+    Item item = std::move(items_.front());
+    items_.pop_front();
+    lock.unlock();
+
+    {
+      ROS1_IGN_BRIDGE_TRACE_SCOPE("ign_publish", trace_label_);
+      publisher_.Publish(*item.msg);
+    }
+    stats_.record_forwarded(item.start_ns);
+    if (item.sampled)
+      stats_.record_sizes(item.in_bytes, item.msg->ByteSizeLong());
+
+    lock.lock();
+  }
+}
+
+}  // namespace ros1_ign_bridge
@@ -12,10 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <unistd.h>
+
+#include <chrono>
 #include <iostream>
-#include <list>
-#include <memory>
+#include <map>
 #include <string>
+#include <vector>
 
 // include ROS 1
 #ifdef __clang__
@@ -30,7 +33,10 @@
 // include Ignition Transport
 #include <ignition/transport/Node.hh>
 
-#include "ros1_ign_bridge/bridge.hpp"
+#include "ros1_ign_bridge/bridge_config.hpp"
+#include "ros1_ign_bridge/bridge_manager.hpp"
+#include "ros1_ign_bridge/bridge_supervisor.hpp"
+#include "ros1_ign_bridge/trace.hpp"
 
 //////////////////////////////////////////////////
 void usage()
@@ -39,84 +45,239 @@ void usage()
             << "  parameter_bridge <topic@ROS1_type@Ign_type> .. "
             << " <topic@ROS1_type@Ign_type>\n\n"
             << "E.g.: parameter_bridge /chatter@std_msgs/String@ignition.msgs"
-            << ".StringMsg" << std::endl;
+            << ".StringMsg\n\n"
+            << "The bridges can also be configured through the private "
+            << "parameters [~bridges]\nand [~executors], which allow per-topic "
+            << "queue sizes, directions, rate limits,\nlazy mode, executors "
+            << "and topic remapping, and [~services], which bridges "
+            << "services.\nBridges can be added and removed at runtime "
+            << "through the [~add_bridge],\n[~remove_bridge] and "
+            << "[~list_bridges] services, and with [~supervise] set they run "
+            << "in worker\nprocesses restarted on failure. See the README for "
+            << "details."
+            << std::endl;
 }
 
 //////////////////////////////////////////////////
-int main(int argc, char * argv[])
+/// \brief Run the bridges in worker processes, one per
+/// ros1_ign_bridge::process_class(). Each worker is this program configured
+/// through its own private parameters, which get the bridges of its class
+/// and a copy of the other settings. The services go to the "state" worker
+/// and the clock to the "control" one.
+/// \param[in] param_config The bridges, services and clock parameters.
+/// \param[in] config Their parsed version, followed by the bridges given as
+/// arguments.
+/// \param[in] specs The bridges given as arguments.
+int supervise(
+  XmlRpc::XmlRpcValue & param_config,
+  const ros1_ign_bridge::BridgeSetConfig & config,
+  const std::vector<std::string> & specs)
 {
-  if (argc < 2)
+  const std::string name = ros::this_node::getName();
+  XmlRpc::XmlRpcValue private_params;
+  ros::param::get(name, private_params);
+
+  std::map<std::string, XmlRpc::XmlRpcValue> params;
+  std::map<std::string, std::vector<std::string>> args;
+  auto worker = [&](const std::string & process) -> XmlRpc::XmlRpcValue &
+    {
+      auto it = params.find(process);
+      if (it != params.end())
+        return it->second;
+
+      XmlRpc::XmlRpcValue value;
+      if (private_params.getType() == XmlRpc::XmlRpcValue::TypeStruct)
+      {
+        for (auto & member : private_params)
+        {
+          if (member.first == "ign_control_prefix" &&
+              member.second.getType() == XmlRpc::XmlRpcValue::TypeString)
+          {
+            // Each worker offers its own control services.
+            value[member.first] =
+              static_cast<std::string>(member.second) + "_" + process;
+          }
+          else if (member.first != "bridges" && member.first != "services" &&
+                   member.first != "clock" && member.first != "supervise")
+          {
+            value[member.first] = member.second;
+          }
+        }
+      }
+      value["bridges"].setSize(0);
+      value["allow_empty"] = true;
+      return params.emplace(process, value).first->second;
+    };
+
+  const int num_param_bridges = param_config.hasMember("bridges") ?
+    param_config["bridges"].size() : 0;
+  for (size_t i = 0; i < config.bridges.size(); ++i)
   {
-    usage();
+    const std::string process =
+      ros1_ign_bridge::process_class(config.bridges[i]);
+    auto & bridges = worker(process)["bridges"];
+    if (static_cast<int>(i) < num_param_bridges)
+      bridges[bridges.size()] = param_config["bridges"][static_cast<int>(i)];
+    else
+      args[process].push_back(specs[i - num_param_bridges]);
+  }
+  if (param_config.hasMember("services"))
+    worker("state")["services"] = param_config["services"];
+  if (param_config.hasMember("clock"))
+    worker("control")["clock"] = param_config["clock"];
+
+  char executable[4096] = {0};
+  if (readlink("/proc/self/exe", executable, sizeof(executable) - 1) < 0)
+  {
+    std::cerr << "Failed to find the bridge executable" << std::endl;
     return -1;
   }
 
+  // The workers are named after the supervisor, in its namespace.
+  const std::string base_name = name.substr(name.rfind('/') + 1);
+  ros1_ign_bridge::BridgeSupervisor supervisor(executable);
+  for (auto & entry : params)
+  {
+    const std::string worker_name = name + "_" + entry.first;
+    ros::param::set(worker_name, entry.second);
+
+    std::vector<std::string> worker_args = args[entry.first];
+    worker_args.push_back("__name:=" + base_name + "_" + entry.first);
+    worker_args.push_back("__ns:=" + ros::this_node::getNamespace());
+    supervisor.add_worker(worker_name, worker_args);
+  }
+
+  supervisor.run([] { return ros::ok(); });
+  return 0;
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char * argv[])
+{
   // ROS 1 node
   ros::init(argc, argv, "ros_ign_bridge");
   ros::NodeHandle ros1_node;
+  ros::NodeHandle private_node("~");
 
-  // Ignition node
-  auto ign_node = std::make_shared<ignition::transport::Node>();
+  // Parse and validate the whole configuration before creating any bridge.
+  ros1_ign_bridge::BridgeSetConfig config;
+  std::vector<std::string> errors;
 
-  std::list<ros1_ign_bridge::BridgeHandles> all_handles;
+  XmlRpc::XmlRpcValue param_config;
+  XmlRpc::XmlRpcValue param_value;
+  if (private_node.getParam("bridges", param_value))
+    param_config["bridges"] = param_value;
+  if (private_node.getParam("executors", param_value))
+    param_config["executors"] = param_value;
+  if (private_node.getParam("services", param_value))
+    param_config["services"] = param_value;
+  if (private_node.getParam("service_threads", param_value))
+    param_config["service_threads"] = param_value;
+  if (private_node.getParam("startup_threads", param_value))
+    param_config["startup_threads"] = param_value;
+  if (private_node.getParam("ign_nodes", param_value))
+    param_config["ign_nodes"] = param_value;
+  if (private_node.getParam("ign_threads", param_value))
+    param_config["ign_threads"] = param_value;
+  if (private_node.getParam("discovery_period", param_value))
+    param_config["discovery_period"] = param_value;
+  if (private_node.getParam("clock", param_value))
+    param_config["clock"] = param_value;
+  if (param_config.valid())
+    ros1_ign_bridge::parse_bridge_config(param_config, config, errors);
 
-  // Parse all arguments.
-  const std::string delim = "@";
-  const size_t queue_size = 10;
+  // ros::init() has already removed the remapping arguments.
+  std::vector<std::string> specs;
   for (auto i = 1; i < argc; ++i)
   {
-    std::string arg = std::string(argv[i]);
-    auto delimPos = arg.find(delim);
-    if (delimPos == std::string::npos || delimPos == 0)
-    {
-     usage();
-     return -1;
-    }
-    std::string topic_name = arg.substr(0, delimPos);
-    arg.erase(0, delimPos + delim.size());
-
-    delimPos = arg.find(delim);
-    if (delimPos == std::string::npos || delimPos == 0)
+    ros1_ign_bridge::BridgeConfig bridge;
+    if (!ros1_ign_bridge::parse_bridge_spec(argv[i], bridge))
     {
       usage();
       return -1;
     }
-    std::string ros1_type_name = arg.substr(0, delimPos);
-    arg.erase(0, delimPos + delim.size());
+    config.bridges.push_back(bridge);
+    specs.push_back(argv[i]);
+  }
 
-    delimPos = arg.find(delim);
-    if (delimPos != std::string::npos || arg.empty())
-    {
-      usage();
-      return -1;
-    }
-    std::string ign_type_name = arg;
+  if (config.bridges.empty() && config.services.empty() &&
+      !private_node.param("allow_empty", false))
+  {
+    usage();
+    return -1;
+  }
 
-    try
-    {
-      ros1_ign_bridge::BridgeHandles handles =
-        ros1_ign_bridge::create_bidirectional_bridge(
-          ros1_node, ign_node,
-          ros1_type_name, ign_type_name,
-          topic_name, queue_size);
+  ros1_ign_bridge::validate_bridge_config(config, errors);
+  if (!errors.empty())
+  {
+    std::cerr << "Invalid bridge configuration:" << std::endl;
+    for (const auto & error : errors)
+      std::cerr << "  " << error << std::endl;
+    return -1;
+  }
+
+  // Supervisor mode: the bridges run in worker processes.
+  if (private_node.param("supervise", false))
+    return supervise(param_config, config, specs);
+
+  // The threads run before the bridges are created, so that each bridge
+  // forwards as soon as it exists, even while a large set is still being
+  // created.
+  ros1_ign_bridge::BridgeManager manager(ros1_node);
+  manager.start();
+  ros::AsyncSpinner async_spinner(1);
+  async_spinner.start();
 
-      all_handles.push_back(handles);
+  // A bridge that fails to start is reported but is not fatal.
+  const auto start_time = std::chrono::steady_clock::now();
+  if (!manager.configure(config, errors))
+  {
+    for (const auto & error : errors)
+      std::cerr << error << std::endl;
+  }
+  std::cout << "Created " << manager.list_bridges().size() << " bridges in "
+            << std::chrono::duration<double>(
+                 std::chrono::steady_clock::now() - start_time).count()
+            << " s" << std::endl;
+
+  // Services to add and remove bridges at runtime.
+  const std::string ign_prefix = private_node.param<std::string>(
+    "ign_control_prefix", ros::this_node::getName());
+  manager.enable_control(private_node, ign_prefix);
+
+  // Periodic traffic statistics and health, unless disabled with a zero
+  // period.
+  const double statistics_period =
+    private_node.param("statistics_period", 1.0);
+  if (statistics_period > 0.0)
+  {
+    manager.enable_statistics(private_node, ign_prefix + "/statistics",
+      statistics_period, private_node.param("diagnostics", true));
+  }
+
+  // Per-message tracing, written until shutdown.
+  const std::string trace_file = private_node.param<std::string>(
+    "trace_file", "");
+  if (!trace_file.empty())
+  {
+    if (!ros1_ign_bridge::Tracer::compiled_in())
+    {
+      std::cerr << "Tracing was disabled at compile time, ignoring "
+                << "[~trace_file]" << std::endl;
     }
-    catch (std::runtime_error &_e)
+    else if (!ros1_ign_bridge::Tracer::instance().start(trace_file))
     {
-      std::cerr << "Failed to create a bridge for topic [" << topic_name << "] "
-                << "with ROS1 type [" << ros1_type_name << "] and "
-                << "Ignition Transport type [" << ign_type_name << "]"
+      std::cerr << "Failed to open trace file [" << trace_file << "]"
                 << std::endl;
     }
   }
 
-  // ROS 1 asynchronous spinner
-  ros::AsyncSpinner async_spinner(1);
-  async_spinner.start();
-
   // Zzzzzz.
   ignition::transport::waitForShutdown();
 
+  async_spinner.stop();
+  manager.stop();
+  ros1_ign_bridge::Tracer::instance().stop();
+
   return 0;
 }
@@ -0,0 +1,116 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ros1_ign_bridge/thread_scheduling.hpp"
+
+namespace ros1_ign_bridge
+{
+
+//////////////////////////////////////////////////
+bool
+set_thread_scheduling(
+  pthread_t thread,
+  int priority,
+  const std::vector<int> & cpus,
+  std::string & error)
+{
+  bool ok = true;
+  if (priority > 0)
+  {
+    sched_param param;
+    param.sched_priority = priority;
+    const int result = pthread_setschedparam(thread, SCHED_FIFO, &param);
+    if (result != 0)
+    {
+      error = "SCHED_FIFO priority [" + std::to_string(priority) + "]: " +
+        std::strerror(result) + ", check the rtprio limit of the user";
+      ok = false;
+    }
+  }
+
+  if (!cpus.empty())
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+    {
+      if (cpu >= 0 && cpu < CPU_SETSIZE)
+        CPU_SET(cpu, &set);
+    }
+    const int result = pthread_setaffinity_np(thread, sizeof(set), &set);
+    if (result != 0)
+    {
+      if (!ok)
+        error += "; ";
+      error += std::string("CPU affinity: ") + std::strerror(result);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+//////////////////////////////////////////////////
+std::string
+describe_thread_scheduling(pthread_t thread)
+{
+  std::ostringstream description;
+
+  int policy = 0;
+  sched_param param;
+  if (pthread_getschedparam(thread, &policy, &param) != 0)
+  {
+    description << "unknown policy";
+  }
+  else if (policy == SCHED_FIFO || policy == SCHED_RR)
+  {
+    description << (policy == SCHED_FIFO ? "SCHED_FIFO" : "SCHED_RR")
+                << " priority " << param.sched_priority;
+  }
+  else
+  {
+    description << "SCHED_OTHER";
+  }
+
+  cpu_set_t set;
+  if (pthread_getaffinity_np(thread, sizeof(set), &set) != 0)
+    return description.str();
+
+  // Consecutive CPUs are written as ranges, e.g. "0-3,6".
+  description << ", CPUs ";
+  bool first = true;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+  {
+    if (!CPU_ISSET(cpu, &set))
+      continue;
+    int last = cpu;
+    while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &set))
+      ++last;
+    description << (first ? "" : ",") << cpu;
+    if (last > cpu)
+      description << "-" << last;
+    first = false;
+    cpu = last;
+  }
+  return description.str();
+}
+
+}  // namespace ros1_ign_bridge
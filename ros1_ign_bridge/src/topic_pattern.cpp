@@ -0,0 +1,219 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <regex>
+#include <stdexcept>
+#include <string>
+
+#include "ros1_ign_bridge/topic_pattern.hpp"
+
+namespace ros1_ign_bridge
+{
+
+namespace
+{
+
+const char kRegexPrefix[] = "re:";
+const size_t kRegexPrefixSize = sizeof(kRegexPrefix) - 1;
+
+}  // namespace
+
+//////////////////////////////////////////////////
+bool
+TopicPattern::is_pattern(const std::string & topic_name)
+{
+  return topic_name.compare(0, kRegexPrefixSize, kRegexPrefix) == 0 ||
+    topic_name.find_first_of("*?[\\") != std::string::npos;
+}
+
+//////////////////////////////////////////////////
+TopicPattern::TopicPattern(const std::string & pattern)
+: pattern_(pattern)
+{
+  if (pattern.compare(0, kRegexPrefixSize, kRegexPrefix) == 0)
+  {
+    try
+    {
+      regex_.reset(new std::regex(pattern.substr(kRegexPrefixSize),
+        std::regex::ECMAScript | std::regex::optimize));
+    }
+    catch (const std::regex_error & e)
+    {
+      throw std::runtime_error(
+        "Invalid topic pattern [" + pattern + "]: " + e.what());
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < pattern.size(); ++i)
+  {
+    const char c = pattern[i];
+    Token token;
+    if (c == '*')
+    {
+      token.kind = Token::STAR;
+      if (i + 1 < pattern.size() && pattern[i + 1] == '*')
+      {
+        token.kind = Token::STAR_STAR;
+        ++i;
+      }
+      // Consecutive stars match the same names as one.
+      if (!tokens_.empty() && (tokens_.back().kind == Token::STAR ||
+          tokens_.back().kind == Token::STAR_STAR))
+      {
+        if (token.kind == Token::STAR_STAR)
+          tokens_.back().kind = Token::STAR_STAR;
+        continue;
+      }
+    }
+    else if (c == '?')
+    {
+      token.kind = Token::ONE;
+    }
+    else if (c == '[')
+    {
+      token.kind = Token::SET;
+      size_t j = i + 1;
+      const bool negated = j < pattern.size() && pattern[j] == '!';
+      if (negated)
+        ++j;
+      // A "]" right after the opening bracket is part of the set.
+      const size_t first = j;
+      while (j < pattern.size() && (pattern[j] != ']' || j == first))
+      {
+        unsigned char low = pattern[j];
+        unsigned char high = low;
+        if (j + 2 < pattern.size() && pattern[j + 1] == '-' &&
+            pattern[j + 2] != ']')
+        {
+          high = pattern[j + 2];
+          j += 2;
+        }
+        if (low > high)
+        {
+          throw std::runtime_error(
+            "Invalid topic pattern [" + pattern + "]: bad range in set");
+        }
+        for (unsigned int k = low; k <= high; ++k)
+          token.chars.set(k);
+        ++j;
+      }
+      if (j >= pattern.size())
+      {
+        throw std::runtime_error(
+          "Invalid topic pattern [" + pattern + "]: unterminated set");
+      }
+      if (negated)
+        token.chars.flip();
+      // Like "*" and "?", a set doesn't match across levels.
+      token.chars.reset('/');
+      i = j;
+    }
+    else
+    {
+      if (c == '\\')
+      {
+        if (++i >= pattern.size())
+        {
+          throw std::runtime_error(
+            "Invalid topic pattern [" + pattern + "]: trailing \\");
+        }
+      }
+      if (tokens_.empty() || tokens_.back().kind != Token::LITERAL)
+      {
+        token.kind = Token::LITERAL;
+        tokens_.push_back(token);
+      }
+      tokens_.back().text += pattern[i];
+      continue;
+    }
+    tokens_.push_back(token);
+  }
+
+  if (!tokens_.empty() && tokens_.front().kind == Token::LITERAL)
+    prefix_ = tokens_.front().text;
+}
+
+//////////////////////////////////////////////////
+bool
+TopicPattern::matches(const std::string & topic_name) const
+{
+  if (regex_)
+    return std::regex_match(topic_name, *regex_);
+
+  if (topic_name.compare(0, prefix_.size(), prefix_) != 0)
+    return false;
+  return match_from(topic_name, prefix_.empty() ? 0 : 1, prefix_.size());
+}
+
+//////////////////////////////////////////////////
+const std::string &
+TopicPattern::pattern() const
+{
+  return pattern_;
+}
+
+//////////////////////////////////////////////////
+bool
+TopicPattern::match_from(
+  const std::string & name, size_t token, size_t pos) const
+{
+  for (; token < tokens_.size(); ++token)
+  {
+    const Token & t = tokens_[token];
+    switch (t.kind)
+    {
+      case Token::LITERAL:
+        if (name.compare(pos, t.text.size(), t.text) != 0)
+          return false;
+        pos += t.text.size();
+        break;
+      case Token::ONE:
+        if (pos >= name.size() || name[pos] == '/')
+          return false;
+        ++pos;
+        break;
+      case Token::SET:
+        if (pos >= name.size() ||
+            !t.chars.test(static_cast<unsigned char>(name[pos])))
+        {
+          return false;
+        }
+        ++pos;
+        break;
+      case Token::STAR:
+      case Token::STAR_STAR:
+      {
+        const bool any_level = t.kind == Token::STAR_STAR;
+        if (token + 1 == tokens_.size())
+        {
+          return any_level ||
+            name.find('/', pos) == std::string::npos;
+        }
+        // Try the shortest expansions first; stars are rarely more than a
+        // couple per pattern, so the backtracking stays shallow.
+        for (size_t end = pos; ; ++end)
+        {
+          if (match_from(name, token + 1, end))
+            return true;
+          if (end >= name.size() || (!any_level && name[end] == '/'))
+            return false;
+        }
+      }
+    }
+  }
+  return pos == name.size();
+}
+
+}  // namespace ros1_ign_bridge
@@ -0,0 +1,216 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "ros1_ign_bridge/trace.hpp"
+
+namespace ros1_ign_bridge
+{
+
+namespace
+{
+
+std::string
+escape_json(const std::string & value)
+{
+  std::string result;
+  result.reserve(value.size());
+  for (const char c : value)
+  {
+    if (c == '"' || c == '\\')
+      result += '\\';
+    result += c;
+  }
+  return result;
+}
+
+}  // namespace
+
+/// \brief Ring buffer written by a single thread and drained by the writer.
+struct Tracer::ThreadBuffer
+{
+  static constexpr uint64_t kCapacity = 1 << 14;
+
+  explicit ThreadBuffer(uint32_t tid)
+  : tid(tid)
+  {}
+
+  const uint32_t tid;
+  std::array<TraceEvent, kCapacity> events;
+  std::atomic<uint64_t> head{0};
+  std::atomic<uint64_t> tail{0};
+  std::atomic<uint64_t> dropped{0};
+};
+
+std::atomic<bool> Tracer::enabled_{false};
+
+//////////////////////////////////////////////////
+Tracer &
+Tracer::instance()
+{
+  static Tracer tracer;
+  return tracer;
+}
+
+//////////////////////////////////////////////////
+Tracer::~Tracer()
+{
+  stop();
+}
+
+//////////////////////////////////////////////////
+bool
+Tracer::start(const std::string & path)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_)
+    return false;
+
+  file_.open(path, std::ios::out | std::ios::trunc);
+  if (!file_)
+    return false;
+
+  // JSON array format: the closing bracket is optional, so the file stays
+  // usable if the process dies while tracing.
+  file_ << "[" << std::fixed << std::setprecision(3);
+  first_event_ = true;
+  dropped_ = 0;
+
+  running_ = true;
+  writer_ = std::thread(&Tracer::run, this);
+  enabled_.store(true, std::memory_order_relaxed);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void
+Tracer::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_)
+      return;
+    enabled_.store(false, std::memory_order_relaxed);
+    running_ = false;
+  }
+  writer_.join();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  flush();
+  file_ << "\n]\n";
+  file_.close();
+  if (dropped_ > 0)
+  {
+    std::cerr << "Tracing dropped " << dropped_ << " events because the "
+              << "buffers were full" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+uint32_t
+Tracer::intern(const std::string & name)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto inserted = label_ids_.emplace(
+    name, static_cast<uint32_t>(labels_.size()));
+  if (inserted.second)
+    labels_.push_back(name);
+  return inserted.first->second;
+}
+
+//////////////////////////////////////////////////
+void
+Tracer::record(const TraceEvent & event)
+{
+  ThreadBuffer & buffer = thread_buffer();
+  const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+  if (head - buffer.tail.load(std::memory_order_acquire) >=
+      ThreadBuffer::kCapacity)
+  {
+    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer.events[head % ThreadBuffer::kCapacity] = event;
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////
+Tracer::ThreadBuffer &
+Tracer::thread_buffer()
+{
+  // Buffers outlive their threads, so that the pending events can still be
+  // written after a thread exits.
+  thread_local ThreadBuffer * buffer = nullptr;
+  if (!buffer)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.emplace_back(
+      new ThreadBuffer(static_cast<uint32_t>(buffers_.size() + 1)));
+    buffer = buffers_.back().get();
+  }
+  return *buffer;
+}
+
+//////////////////////////////////////////////////
+void
+Tracer::run()
+{
+  while (running_)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush();
+  }
+}
+
+//////////////////////////////////////////////////
+void
+Tracer::flush()
+{
+  const auto pid = getpid();
+  for (auto & buffer : buffers_)
+  {
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+    uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail)
+    {
+      const TraceEvent & event =
+        buffer->events[tail % ThreadBuffer::kCapacity];
+      const std::string & label = event.label < labels_.size() ?
+        labels_[event.label] : std::string();
+
+      file_ << (first_event_ ? "\n" : ",\n")
+            << "{\"name\":\"" << event.stage << "\""
+            << ",\"cat\":\"" << escape_json(label) << "\""
+            << ",\"ph\":\"X\""
+            << ",\"ts\":" << event.start_ns / 1e3
+            << ",\"dur\":" << event.duration_ns / 1e3
+            << ",\"pid\":" << pid
+            << ",\"tid\":" << buffer->tid << "}";
+      first_event_ = false;
+    }
+    buffer->tail.store(tail, std::memory_order_release);
+    dropped_ += buffer->dropped.exchange(0, std::memory_order_relaxed);
+  }
+  file_.flush();
+}
+
+}  // namespace ros1_ign_bridge
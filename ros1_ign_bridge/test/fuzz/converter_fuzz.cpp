@@ -0,0 +1,432 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Randomized round trips through the converters with payloads of every size
+// bucket, well-formed and malformed, plus conversion throughput per bucket.
+// Build with -fsanitize=address to turn out of bounds accesses into
+// failures. The seed and the number of iterations can be set through the
+// ROS1_IGN_BRIDGE_FUZZ_SEED and ROS1_IGN_BRIDGE_FUZZ_ITERATIONS environment
+// variables; the seed is printed so that a failure can be replayed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ros1_ign_bridge/convert_builtin_interfaces.hpp"
+
+using ros1_ign_bridge::convert_1_to_ign;
+using ros1_ign_bridge::convert_ign_to_1;
+
+namespace
+{
+
+/// \brief Payload sizes in bytes, from empty to a few megapixels.
+const std::vector<size_t> kSizeBuckets =
+  {0, 1, 7, 64, 1024, 16 * 1024, 256 * 1024, 4 * 1024 * 1024};
+
+/// \brief Encodings supported by the Image converters and their pixel size.
+const std::vector<std::pair<std::string, unsigned int>> kEncodings =
+{
+  {"mono8", 1}, {"mono16", 2}, {"rgb8", 3}, {"rgba8", 4}, {"bgra8", 4},
+  {"rgb16", 6}, {"bgr8", 3}, {"bgr16", 6}, {"32FC1", 4}
+};
+
+//////////////////////////////////////////////////
+size_t env_or(const char * name, size_t fallback)
+{
+  const char * value = std::getenv(name);
+  return value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+//////////////////////////////////////////////////
+/// \brief Random generator shared by the tests, seeded once per run.
+std::mt19937_64 & rng()
+{
+  static std::mt19937_64 generator(
+    env_or("ROS1_IGN_BRIDGE_FUZZ_SEED", 42));
+  return generator;
+}
+
+size_t iterations()
+{
+  return env_or("ROS1_IGN_BRIDGE_FUZZ_ITERATIONS", 200);
+}
+
+//////////////////////////////////////////////////
+size_t random_size(size_t max)
+{
+  return std::uniform_int_distribution<size_t>(0, max)(rng());
+}
+
+size_t random_bucket()
+{
+  // Small buckets are cheap, so they get most of the iterations.
+  const size_t index = std::min(random_size(kSizeBuckets.size() - 1),
+    random_size(kSizeBuckets.size() - 1));
+  return kSizeBuckets[index];
+}
+
+float random_float()
+{
+  return std::uniform_real_distribution<float>(-1e3f, 1e3f)(rng());
+}
+
+std::string random_name(size_t max_length)
+{
+  static const char kChars[] = "abcdefghijklmnopqrstuvwxyz0123456789_/";
+  std::string name(random_size(max_length), 'a');
+  for (auto & c : name)
+    c = kChars[random_size(sizeof(kChars) - 2)];
+  return name;
+}
+
+void random_header(std_msgs::Header & header)
+{
+  header.stamp.sec = static_cast<uint32_t>(random_size(2000000000));
+  header.stamp.nsec = static_cast<uint32_t>(random_size(999999999));
+  header.frame_id = random_name(16);
+}
+
+void expect_header_eq(
+  const std_msgs::Header & expected, const std_msgs::Header & actual)
+{
+  EXPECT_EQ(expected.stamp, actual.stamp);
+  EXPECT_EQ(expected.frame_id, actual.frame_id);
+}
+
+//////////////////////////////////////////////////
+/// \brief A well-formed image of about the given size.
+void random_image(size_t size, sensor_msgs::Image & msg)
+{
+  random_header(msg.header);
+  const auto & encoding = kEncodings[random_size(kEncodings.size() - 1)];
+  msg.encoding = encoding.first;
+  const size_t pixels = size / encoding.second;
+  msg.width = static_cast<uint32_t>(
+    pixels > 0 ? 1 + random_size(std::min<size_t>(pixels, 4096) - 1) : 0);
+  msg.height = static_cast<uint32_t>(msg.width > 0 ? pixels / msg.width : 0);
+  msg.step = msg.width * encoding.second;
+  msg.is_bigendian = false;
+  msg.data.resize(static_cast<size_t>(msg.step) * msg.height);
+  for (auto & byte : msg.data)
+    byte = static_cast<uint8_t>(rng()());
+}
+
+//////////////////////////////////////////////////
+/// \brief Conversions per second and bytes per second of a conversion.
+template<typename Fn>
+void measure(const std::string & name, size_t bytes, Fn convert)
+{
+  using Clock = std::chrono::steady_clock;
+  // Enough repetitions for the small sizes to take a measurable time.
+  const size_t repetitions = std::max<size_t>(
+    10, std::min<size_t>(100000, (64u << 20) / std::max<size_t>(bytes, 1)));
+
+  const auto start = Clock::now();
+  for (size_t i = 0; i < repetitions; ++i)
+    convert();
+  const double seconds =
+    std::chrono::duration<double>(Clock::now() - start).count();
+
+  const double rate = repetitions / seconds;
+  std::cout << name << " " << bytes << " B: " << rate << " msg/s, "
+            << rate * bytes / (1 << 20) << " MiB/s" << std::endl;
+  ::testing::Test::RecordProperty(
+    name + "_" + std::to_string(bytes) + "_msgs_per_sec",
+    std::to_string(static_cast<uint64_t>(rate)));
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////
+TEST(ConverterFuzzTest, ImageRoundTrip)
+{
+  for (size_t i = 0; i < iterations(); ++i)
+  {
+    sensor_msgs::Image ros1_msg;
+    random_image(random_bucket(), ros1_msg);
+
+    ignition::msgs::Image ign_msg;
+    convert_1_to_ign(ros1_msg, ign_msg);
+    sensor_msgs::Image result;
+    convert_ign_to_1(ign_msg, result);
+
+    expect_header_eq(ros1_msg.header, result.header);
+    EXPECT_EQ(ros1_msg.encoding, result.encoding);
+    EXPECT_EQ(ros1_msg.width, result.width);
+    EXPECT_EQ(ros1_msg.height, result.height);
+    EXPECT_EQ(ros1_msg.step, result.step);
+    ASSERT_EQ(ros1_msg.data, result.data) << "iteration " << i;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ConverterFuzzTest, ImageMalformed)
+{
+  for (size_t i = 0; i < iterations(); ++i)
+  {
+    sensor_msgs::Image ros1_msg;
+    random_image(random_bucket(), ros1_msg);
+    ros1_msg.data.resize(random_size(ros1_msg.data.size() * 2));
+
+    // Truncated or oversized data towards Ignition.
+    ignition::msgs::Image ign_msg;
+    convert_1_to_ign(ros1_msg, ign_msg);
+    EXPECT_LE(ign_msg.data().size(), ros1_msg.data.size());
+
+    // Truncated data from Ignition.
+    ign_msg.mutable_data()->resize(random_size(ign_msg.data().size()));
+    sensor_msgs::Image result;
+    convert_ign_to_1(ign_msg, result);
+    EXPECT_EQ(static_cast<size_t>(result.step) * result.height,
+      result.data.size()) << "iteration " << i;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ConverterFuzzTest, LaserScanRoundTrip)
+{
+  for (size_t i = 0; i < iterations(); ++i)
+  {
+    sensor_msgs::LaserScan ros1_msg;
+    random_header(ros1_msg.header);
+    ros1_msg.angle_min = random_float();
+    ros1_msg.angle_max = random_float();
+    ros1_msg.angle_increment = random_float();
+    ros1_msg.range_min = random_float();
+    ros1_msg.range_max = random_float();
+    ros1_msg.ranges.resize(random_bucket() / sizeof(float));
+    for (auto & range : ros1_msg.ranges)
+      range = random_float();
+    // Intensities are optional.
+    if (random_size(1))
+    {
+      ros1_msg.intensities.resize(ros1_msg.ranges.size());
+      for (auto & intensity : ros1_msg.intensities)
+        intensity = random_float();
+    }
+
+    ignition::msgs::LaserScan ign_msg;
+    convert_1_to_ign(ros1_msg, ign_msg);
+    EXPECT_EQ(ros1_msg.ranges.size(), ign_msg.count());
+    sensor_msgs::LaserScan result;
+    convert_ign_to_1(ign_msg, result);
+
+    expect_header_eq(ros1_msg.header, result.header);
+    EXPECT_FLOAT_EQ(ros1_msg.angle_min, result.angle_min);
+    EXPECT_FLOAT_EQ(ros1_msg.angle_max, result.angle_max);
+    EXPECT_FLOAT_EQ(ros1_msg.angle_increment, result.angle_increment);
+    EXPECT_FLOAT_EQ(ros1_msg.range_min, result.range_min);
+    EXPECT_FLOAT_EQ(ros1_msg.range_max, result.range_max);
+    ASSERT_EQ(ros1_msg.ranges, result.ranges) << "iteration " << i;
+    ASSERT_EQ(ros1_msg.intensities, result.intensities) << "iteration " << i;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ConverterFuzzTest, LaserScanVerticalBeams)
+{
+  for (size_t i = 0; i < iterations(); ++i)
+  {
+    ignition::msgs::LaserScan ign_msg;
+    const size_t count = 1 + random_size(1023);
+    const size_t vertical_count = 1 + random_size(15);
+    ign_msg.set_count(static_cast<uint32_t>(count));
+    ign_msg.set_vertical_count(static_cast<uint32_t>(vertical_count));
+    for (size_t j = 0; j < count * vertical_count; ++j)
+    {
+      ign_msg.add_ranges(random_float());
+      ign_msg.add_intensities(random_float());
+    }
+
+    sensor_msgs::LaserScan result;
+    convert_ign_to_1(ign_msg, result);
+
+    // The beam in the middle is kept.
+    const size_t start = (vertical_count / 2) * count;
+    ASSERT_EQ(count, result.ranges.size());
+    ASSERT_EQ(count, result.intensities.size());
+    for (size_t j = 0; j < count; ++j)
+    {
+      EXPECT_FLOAT_EQ(ign_msg.ranges(start + j), result.ranges[j]);
+      EXPECT_FLOAT_EQ(ign_msg.intensities(start + j), result.intensities[j]);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ConverterFuzzTest, LaserScanMalformed)
+{
+  for (size_t i = 0; i < iterations(); ++i)
+  {
+    // Counts that disagree with the data from Ignition.
+    ignition::msgs::LaserScan ign_msg;
+    ign_msg.set_count(static_cast<uint32_t>(rng()()));
+    ign_msg.set_vertical_count(static_cast<uint32_t>(rng()()));
+    const size_t num_ranges = random_bucket() / sizeof(float);
+    for (size_t j = 0; j < num_ranges; ++j)
+      ign_msg.add_ranges(random_float());
+    const size_t num_intensities = random_size(num_ranges);
+    for (size_t j = 0; j < num_intensities; ++j)
+      ign_msg.add_intensities(random_float());
+
+    sensor_msgs::LaserScan result;
+    convert_ign_to_1(ign_msg, result);
+    EXPECT_LE(result.ranges.size(), num_ranges);
+    EXPECT_TRUE(result.intensities.empty() ||
+      result.intensities.size() == result.ranges.size());
+
+    // Angles that disagree with the data from ROS 1, and partial
+    // intensities.
+    sensor_msgs::LaserScan ros1_msg;
+    ros1_msg.angle_min = 0.0f;
+    ros1_msg.angle_max = random_float();
+    ros1_msg.angle_increment = random_size(1) ? 0.0f :
+      std::numeric_limits<float>::quiet_NaN();
+    ros1_msg.ranges.resize(random_size(1024));
+    ros1_msg.intensities.resize(random_size(1024));
+
+    ignition::msgs::LaserScan ign_result;
+    convert_1_to_ign(ros1_msg, ign_result);
+    EXPECT_EQ(ros1_msg.ranges.size(),
+      static_cast<size_t>(ign_result.ranges_size()));
+    EXPECT_TRUE(ign_result.intensities_size() == 0 ||
+      ign_result.intensities_size() == ign_result.ranges_size());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ConverterFuzzTest, JointStateRoundTrip)
+{
+  for (size_t i = 0; i < iterations(); ++i)
+  {
+    sensor_msgs::JointState ros1_msg;
+    random_header(ros1_msg.header);
+    const size_t count = random_bucket() / 32;
+    for (size_t j = 0; j < count; ++j)
+    {
+      ros1_msg.name.push_back(random_name(32));
+      ros1_msg.position.push_back(random_float());
+      ros1_msg.velocity.push_back(random_float());
+      ros1_msg.effort.push_back(random_float());
+    }
+
+    ignition::msgs::Model ign_msg;
+    convert_1_to_ign(ros1_msg, ign_msg);
+    sensor_msgs::JointState result;
+    convert_ign_to_1(ign_msg, result);
+
+    expect_header_eq(ros1_msg.header, result.header);
+    ASSERT_EQ(ros1_msg.name, result.name) << "iteration " << i;
+    ASSERT_EQ(ros1_msg.position, result.position) << "iteration " << i;
+    ASSERT_EQ(ros1_msg.velocity, result.velocity) << "iteration " << i;
+    ASSERT_EQ(ros1_msg.effort, result.effort) << "iteration " << i;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ConverterFuzzTest, JointStateUnequalArrays)
+{
+  for (size_t i = 0; i < iterations(); ++i)
+  {
+    sensor_msgs::JointState ros1_msg;
+    ros1_msg.name.resize(random_size(64), "joint");
+    ros1_msg.position.resize(random_size(64), 1.0);
+    ros1_msg.velocity.resize(random_size(64), 2.0);
+    ros1_msg.effort.resize(random_size(64), 3.0);
+    const size_t count = std::max(
+      std::max(ros1_msg.name.size(), ros1_msg.position.size()),
+      std::max(ros1_msg.velocity.size(), ros1_msg.effort.size()));
+
+    ignition::msgs::Model ign_msg;
+    convert_1_to_ign(ros1_msg, ign_msg);
+    ASSERT_EQ(count, static_cast<size_t>(ign_msg.joint_size()));
+
+    // The values present are kept, the missing ones are zero.
+    for (size_t j = 0; j < count; ++j)
+    {
+      const auto & axis = ign_msg.joint(j).axis1();
+      EXPECT_EQ(j < ros1_msg.name.size() ? "joint" : "",
+        ign_msg.joint(j).name());
+      EXPECT_EQ(j < ros1_msg.position.size() ? 1.0 : 0.0, axis.position());
+      EXPECT_EQ(j < ros1_msg.velocity.size() ? 2.0 : 0.0, axis.velocity());
+      EXPECT_EQ(j < ros1_msg.effort.size() ? 3.0 : 0.0, axis.force());
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ConverterFuzzTest, ThroughputPerSize)
+{
+  for (size_t bytes : kSizeBuckets)
+  {
+    sensor_msgs::Image image;
+    random_image(bytes, image);
+    image.encoding = "mono8";
+    image.width = static_cast<uint32_t>(bytes);
+    image.height = bytes > 0 ? 1 : 0;
+    image.step = image.width;
+    image.data.resize(bytes);
+    ignition::msgs::Image ign_image;
+    convert_1_to_ign(image, ign_image);
+
+    measure("image_1_to_ign", bytes, [&image]()
+      {
+        ignition::msgs::Image out;
+        convert_1_to_ign(image, out);
+      });
+    measure("image_ign_to_1", bytes, [&ign_image]()
+      {
+        sensor_msgs::Image out;
+        convert_ign_to_1(ign_image, out);
+      });
+
+    sensor_msgs::LaserScan scan;
+    scan.ranges.resize(bytes / sizeof(float), 1.0f);
+    scan.intensities.resize(bytes / sizeof(float), 1.0f);
+    ignition::msgs::LaserScan ign_scan;
+    convert_1_to_ign(scan, ign_scan);
+
+    measure("laserscan_1_to_ign", bytes, [&scan]()
+      {
+        ignition::msgs::LaserScan out;
+        convert_1_to_ign(scan, out);
+      });
+    measure("laserscan_ign_to_1", bytes, [&ign_scan]()
+      {
+        sensor_msgs::LaserScan out;
+        convert_ign_to_1(ign_scan, out);
+      });
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout << "Seed " << env_or("ROS1_IGN_BRIDGE_FUZZ_SEED", 42) << ", "
+            << iterations() << " iterations" << std::endl;
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Adds, lists and removes bridges of a running parameter_bridge named
+// "bridge" through its services.
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <std_msgs/String.h>
+#include <ignition/msgs.hh>
+#include <ignition/transport/Node.hh>
+
+#include <ros1_ign_bridge/AddBridge.h>
+#include <ros1_ign_bridge/ListBridges.h>
+#include <ros1_ign_bridge/RemoveBridge.h>
+
+namespace
+{
+
+const char kSpec[] = "/control_chatter@std_msgs/String[ignition.msgs.StringMsg";
+
+//////////////////////////////////////////////////
+template <typename SRV>
+bool call(const std::string & name, SRV & srv)
+{
+  return ros::service::waitForService(name, 5000) &&
+    ros::service::call(name, srv);
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////
+TEST(BridgeControlTest, AddListRemove)
+{
+  ros1_ign_bridge::AddBridge add;
+  add.request.spec = kSpec;
+  ASSERT_TRUE(call("/bridge/add_bridge", add));
+  EXPECT_TRUE(add.response.success) << add.response.message;
+
+  // The new bridge forwards right away.
+  bool received = false;
+  ros::NodeHandle n;
+  boost::function<void(const std_msgs::String::ConstPtr &)> cb =
+    [&received](const std_msgs::String::ConstPtr & msg)
+    {
+      EXPECT_EQ("hello", msg->data);
+      received = true;
+    };
+  ros::Subscriber sub = n.subscribe<std_msgs::String>(
+    "/control_chatter", 10, cb);
+
+  ignition::transport::Node ign_node;
+  auto pub = ign_node.Advertise<ignition::msgs::StringMsg>("/control_chatter");
+  ignition::msgs::StringMsg msg;
+  msg.set_data("hello");
+  for (int i = 0; i < 300 && !received; ++i)
+  {
+    pub.Publish(msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ros::spinOnce();
+  }
+  EXPECT_TRUE(received);
+
+  // Neither the same topic twice nor a malformed specification.
+  ASSERT_TRUE(call("/bridge/add_bridge", add));
+  EXPECT_FALSE(add.response.success);
+  add.request.spec = "/control_chatter";
+  ASSERT_TRUE(call("/bridge/add_bridge", add));
+  EXPECT_FALSE(add.response.success);
+
+  ros1_ign_bridge::ListBridges list;
+  ASSERT_TRUE(call("/bridge/list_bridges", list));
+  ASSERT_EQ(1u, list.response.bridges.size());
+  EXPECT_EQ(kSpec, list.response.bridges[0]);
+
+  // The same list through Ignition.
+  ignition::msgs::StringMsg_V ign_list;
+  bool result = false;
+  ASSERT_TRUE(ign_node.Request("/bridge/list_bridges", ignition::msgs::Empty(),
+    5000, ign_list, result));
+  EXPECT_TRUE(result);
+  ASSERT_EQ(1, ign_list.data_size());
+  EXPECT_EQ(kSpec, ign_list.data(0));
+
+  ros1_ign_bridge::RemoveBridge remove;
+  remove.request.topic = "/control_chatter";
+  ASSERT_TRUE(call("/bridge/remove_bridge", remove));
+  EXPECT_TRUE(remove.response.success) << remove.response.message;
+  ASSERT_TRUE(call("/bridge/remove_bridge", remove));
+  EXPECT_FALSE(remove.response.success);
+
+  list = ros1_ign_bridge::ListBridges();
+  ASSERT_TRUE(call("/bridge/list_bridges", list));
+  EXPECT_TRUE(list.response.bridges.empty());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "bridge_control_test");
+
+  return RUN_ALL_TESTS();
+}
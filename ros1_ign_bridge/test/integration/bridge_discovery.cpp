@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Bridges topics matching a pattern with ros1_ign_bridge::BridgeManager as
+// they appear after startup, in this process and in the ign_publisher of
+// bridge_discovery.test, which only starts a few seconds later.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <std_msgs/String.h>
+#include <ignition/msgs.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge_manager.hpp"
+
+using ros1_ign_bridge::BridgeConfig;
+using ros1_ign_bridge::BridgeManager;
+
+namespace
+{
+
+//////////////////////////////////////////////////
+void add_pattern(BridgeManager & manager, const std::string & spec)
+{
+  BridgeConfig config;
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_spec(spec, config)) << spec;
+  std::string error;
+  ASSERT_TRUE(manager.add_bridge(config, error)) << error;
+}
+
+//////////////////////////////////////////////////
+bool bridged(const BridgeManager & manager, const std::string & topic)
+{
+  const auto bridges = manager.list_bridges();
+  return std::any_of(bridges.begin(), bridges.end(),
+    [&topic](const BridgeConfig & config)
+    {
+      return config.ros1_topic_name == topic;
+    });
+}
+
+//////////////////////////////////////////////////
+bool ros1_listed(const std::string & topic)
+{
+  ros::master::V_TopicInfo infos;
+  ros::master::getTopics(infos);
+  return std::any_of(infos.begin(), infos.end(),
+    [&topic](const ros::master::TopicInfo & info)
+    {
+      return info.name == topic;
+    });
+}
+
+//////////////////////////////////////////////////
+/// \brief Spin until a condition holds.
+bool wait_for(const std::function<bool()> & condition, double seconds)
+{
+  const auto deadline = std::chrono::steady_clock::now() +
+    std::chrono::duration<double>(seconds);
+  while (!condition())
+  {
+    if (std::chrono::steady_clock::now() >= deadline)
+      return false;
+    ros::spinOnce();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Let a few discovery periods go by.
+void scans()
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////
+TEST(BridgeDiscoveryTest, LateTopics)
+{
+  ros::NodeHandle n;
+  BridgeManager manager(n);
+  manager.set_discovery_period(0.1);
+  add_pattern(manager, "/late/**@std_msgs/String]ignition.msgs.StringMsg");
+  add_pattern(manager, "/late_ign/*@std_msgs/String[ignition.msgs.StringMsg");
+  manager.start();
+
+  scans();
+  EXPECT_FALSE(bridged(manager, "/late/first"));
+  EXPECT_FALSE(bridged(manager, "/late_ign/pose"));
+
+  // A ROS 1 topic that appears is merged into the sorted list of the known
+  // ones, here at the end and then before a known name.
+  auto first = n.advertise<std_msgs::String>("/late/first", 1);
+  EXPECT_TRUE(wait_for([&] { return bridged(manager, "/late/first"); }, 5));
+  auto second = n.advertise<std_msgs::String>("/late/a/second", 1);
+  EXPECT_TRUE(wait_for([&] { return bridged(manager, "/late/a/second"); }, 5));
+  EXPECT_TRUE(bridged(manager, "/late/first"));
+
+  // A topic of another type is not bridged.
+  auto other = n.advertise<std_msgs::String>("/late_ign/ros_only", 1);
+  ignition::transport::Node ign_node;
+  auto ign_pub = ign_node.Advertise<ignition::msgs::StringMsg>(
+    "/late_ign/pose");
+  EXPECT_TRUE(wait_for([&] { return bridged(manager, "/late_ign/pose"); }, 5));
+  EXPECT_FALSE(bridged(manager, "/late_ign/ros_only"));
+}
+
+/////////////////////////////////////////////////
+TEST(BridgeDiscoveryTest, RemoteIgnitionTopic)
+{
+  ros::NodeHandle n;
+  BridgeManager manager(n);
+  manager.set_discovery_period(0.1);
+  add_pattern(manager, "/str*@std_msgs/String[ignition.msgs.StringMsg");
+  manager.start();
+
+  // Ignition discovery of the remote publisher may list the topic before
+  // its publisher, in which case the topic is retried at the next scans.
+  std::atomic<bool> received{false};
+  ros::Subscriber sub = n.subscribe<std_msgs::String>("/string", 1,
+    [&received](const std_msgs::String::ConstPtr &) { received = true; });
+  EXPECT_TRUE(wait_for([&] { return bridged(manager, "/string"); }, 20));
+  EXPECT_TRUE(wait_for([&] { return received.load(); }, 5));
+}
+
+/////////////////////////////////////////////////
+TEST(BridgeDiscoveryTest, RemovedBridgeComesBack)
+{
+  ros::NodeHandle n;
+  BridgeManager manager(n);
+  manager.set_discovery_period(0.1);
+  add_pattern(manager, "/again/*@std_msgs/String]ignition.msgs.StringMsg");
+  manager.start();
+
+  auto pub = n.advertise<std_msgs::String>("/again/topic", 1);
+  ASSERT_TRUE(wait_for([&] { return bridged(manager, "/again/topic"); }, 5));
+
+  // Not created again while the topic is still there.
+  EXPECT_EQ(1u, manager.remove_bridge("/again/topic"));
+  scans();
+  EXPECT_FALSE(bridged(manager, "/again/topic"));
+
+  // Once it disappeared, the topic is bridged again when it comes back.
+  pub.shutdown();
+  ASSERT_TRUE(wait_for([] { return !ros1_listed("/again/topic"); }, 5));
+  scans();
+  pub = n.advertise<std_msgs::String>("/again/topic", 1);
+  EXPECT_TRUE(wait_for([&] { return bridged(manager, "/again/topic"); }, 5));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "bridge_discovery_test");
+
+  return RUN_ALL_TESTS();
+}
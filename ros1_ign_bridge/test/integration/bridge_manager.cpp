@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Hosts bridges in-process with ros1_ign_bridge::BridgeManager and stops it
+// while other threads keep using it.
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <ignition/msgs.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge_manager.hpp"
+
+using ros1_ign_bridge::BridgeConfig;
+using ros1_ign_bridge::BridgeManager;
+using ros1_ign_bridge::ExecutorConfig;
+
+/////////////////////////////////////////////////
+TEST(BridgeManagerTest, ExecutorForwards)
+{
+  ros::NodeHandle n;
+  BridgeManager manager(n);
+
+  ExecutorConfig executor;
+  executor.name = "workers";
+  executor.threads = 2;
+  ASSERT_TRUE(manager.add_executor(executor));
+  EXPECT_FALSE(manager.add_executor(executor));
+
+  BridgeConfig bridge;
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_spec(
+    "/manager_chatter@std_msgs/String]ignition.msgs.StringMsg", bridge));
+  bridge.executor = "workers";
+  std::string error;
+  ASSERT_TRUE(manager.add_bridge(bridge, error)) << error;
+  manager.start();
+
+  // The ROS 1 callback of the bridge runs on the executor, while this
+  // thread never spins.
+  std::atomic<bool> received{false};
+  std::function<void(const ignition::msgs::StringMsg &)> cb =
+    [&received](const ignition::msgs::StringMsg & msg)
+    {
+      if (msg.data() == "hello")
+        received = true;
+    };
+  ignition::transport::Node ign_node;
+  ASSERT_TRUE(ign_node.Subscribe("/manager_chatter", cb));
+
+  // The bridge ignores the messages of its own node, the talker of
+  // bridge_manager.test publishes them.
+  for (int i = 0; i < 300 && !received; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_TRUE(received);
+}
+
+/////////////////////////////////////////////////
+TEST(BridgeManagerTest, StopWhileInUse)
+{
+  ros::NodeHandle n;
+  BridgeManager manager(n);
+  ExecutorConfig executor;
+  executor.name = "workers";
+  ASSERT_TRUE(manager.add_executor(executor));
+  manager.enable_control(ros::NodeHandle("~"), "/manager_test");
+  manager.start();
+
+  // Other threads keep adding and removing bridges while the manager stops.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> users;
+  for (int i = 0; i < 4; ++i)
+  {
+    users.emplace_back([&manager, &done, i]
+      {
+        const std::string topic = "/manager_topic_" + std::to_string(i);
+        BridgeConfig bridge;
+        ros1_ign_bridge::parse_bridge_spec(
+          topic + "@std_msgs/String@ignition.msgs.StringMsg", bridge);
+        bridge.executor = "workers";
+        while (!done)
+        {
+          std::string error;
+          manager.add_bridge(bridge, error);
+          manager.list_bridges();
+          manager.remove_bridge(topic);
+        }
+      });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  auto stopped = std::async(std::launch::async, [&manager]
+    {
+      manager.stop();
+    });
+  EXPECT_EQ(std::future_status::ready,
+            stopped.wait_for(std::chrono::seconds(10)));
+
+  done = true;
+  for (auto & user : users)
+    user.join();
+
+  // Stopping again does nothing and nothing can be added anymore.
+  manager.stop();
+  BridgeConfig bridge;
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_spec(
+    "/manager_late@std_msgs/String@ignition.msgs.StringMsg", bridge));
+  std::string error;
+  EXPECT_FALSE(manager.add_bridge(bridge, error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(manager.add_executor(executor));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "bridge_manager_test");
+
+  return RUN_ALL_TESTS();
+}
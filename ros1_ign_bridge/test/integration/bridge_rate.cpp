@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Throttles bridges with max_rate and ign_msgs_per_sec and checks that
+// every message is either forwarded or counted as dropped.
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <ignition/msgs.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge.hpp"
+
+using ros1_ign_bridge::BridgeConfig;
+using ros1_ign_bridge::BridgeHandles;
+
+namespace
+{
+
+/// \brief Let a ROS 1 to Ignition bridge run for a second, fed at 200 Hz by
+/// the talker of bridge_rate.test, and count the messages received on the
+/// Ignition side.
+void
+run_throttled(const BridgeConfig & config, uint64_t & received,
+  ros1_ign_bridge::BridgeStatsSnapshot & stats)
+{
+  ros::NodeHandle n;
+  auto ign_node = std::make_shared<ignition::transport::Node>();
+  BridgeHandles handles = ros1_ign_bridge::create_bridge(n, ign_node, config);
+  auto state = handles.bridge1toIgn.state;
+
+  std::atomic<uint64_t> count{0};
+  std::function<void(const ignition::msgs::StringMsg &)> cb =
+    [&count](const ignition::msgs::StringMsg &)
+    {
+      ++count;
+    };
+  ignition::transport::Node sub_node;
+  ASSERT_TRUE(sub_node.Subscribe(config.ign_topic_name, cb));
+
+  for (int i = 0; i < 500 && state->stats.messages_in.load() == 0; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_GT(state->stats.messages_in.load(), 0u);
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+
+  // No callback is running anymore once the subscriber is shut down.
+  handles.bridge1toIgn.ros1_subscriber.shutdown();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  received = count;
+  stats = state->stats.snapshot();
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////
+TEST(BridgeRateTest, IgnMsgsPerSec)
+{
+  BridgeConfig config;
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_spec(
+    "/rate_ign_msgs_per_sec@std_msgs/String]ignition.msgs.StringMsg", config));
+  config.ign_msgs_per_sec = 10;
+
+  // The excess is dropped by the bridge, not silently by Ignition after
+  // being counted as forwarded.
+  uint64_t received = 0;
+  ros1_ign_bridge::BridgeStatsSnapshot stats;
+  run_throttled(config, received, stats);
+  EXPECT_GT(stats.messages_in, 50u);
+  EXPECT_GT(stats.dropped, 0u);
+  EXPECT_EQ(stats.messages_in, stats.messages_out + stats.dropped);
+  EXPECT_EQ(stats.messages_out, received);
+  EXPECT_GT(stats.messages_out, 3u);
+  EXPECT_LE(stats.messages_out, 15u);
+}
+
+/////////////////////////////////////////////////
+TEST(BridgeRateTest, MaxRate)
+{
+  BridgeConfig config;
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_spec(
+    "/rate_max_rate@std_msgs/String]ignition.msgs.StringMsg", config));
+  config.max_rate = 20.0;
+  config.ign_msgs_per_sec = 1000;
+
+  uint64_t received = 0;
+  ros1_ign_bridge::BridgeStatsSnapshot stats;
+  run_throttled(config, received, stats);
+  EXPECT_GT(stats.messages_in, 50u);
+  EXPECT_EQ(stats.messages_in, stats.messages_out + stats.dropped);
+  EXPECT_EQ(stats.messages_out, received);
+  EXPECT_GT(stats.messages_out, 10u);
+  EXPECT_LE(stats.messages_out, 30u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "bridge_rate_test");
+  ros::AsyncSpinner spinner(1);
+  spinner.start();
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Adds and removes bridges of ros1_ign_bridge::BridgeRegistry directly,
+// including many bridges and concurrent adds of the same topic.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge_registry.hpp"
+
+using ros1_ign_bridge::BridgeConfig;
+using ros1_ign_bridge::BridgeRegistry;
+
+namespace
+{
+
+//////////////////////////////////////////////////
+BridgeConfig bridge(const std::string & spec)
+{
+  BridgeConfig config;
+  EXPECT_TRUE(ros1_ign_bridge::parse_bridge_spec(spec, config)) << spec;
+  return config;
+}
+
+//////////////////////////////////////////////////
+bool add(BridgeRegistry & registry, const std::string & spec)
+{
+  std::string error;
+  return registry.add(bridge(spec), error);
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////
+TEST(BridgeRegistryTest, TopicConflicts)
+{
+  BridgeRegistry registry(ros::NodeHandle(),
+    std::make_shared<ignition::transport::Node>());
+
+  ASSERT_TRUE(add(registry,
+    "/registry_a@std_msgs/String@ignition.msgs.StringMsg"));
+
+  // Each side of a topic has a single bridge publishing into it, and an
+  // Ignition topic a single bridge subscribing to it.
+  std::string error;
+  EXPECT_FALSE(registry.add(bridge(
+    "/registry_a@std_msgs/String]ignition.msgs.StringMsg"), error));
+  EXPECT_NE(std::string::npos, error.find("already bridged from ROS 1"))
+    << error;
+  EXPECT_FALSE(registry.add(bridge(
+    "/registry_a@std_msgs/String[ignition.msgs.StringMsg"), error));
+  EXPECT_NE(std::string::npos, error.find("already bridged from Ignition"))
+    << error;
+
+  BridgeConfig other = bridge(
+    "/registry_b@std_msgs/String[ignition.msgs.StringMsg");
+  other.ign_topic_name = "/registry_a";
+  EXPECT_FALSE(registry.add(other, error));
+  EXPECT_NE(std::string::npos, error.find("already bridged to ROS 1"))
+    << error;
+
+  // Opposite directions of different topics don't conflict.
+  EXPECT_TRUE(add(registry,
+    "/registry_b@std_msgs/String]ignition.msgs.StringMsg"));
+  EXPECT_TRUE(add(registry,
+    "/registry_c@std_msgs/String[ignition.msgs.StringMsg"));
+  EXPECT_EQ(3u, registry.list().size());
+
+  // Removing a bridge frees its topics, by either name.
+  EXPECT_EQ(1u, registry.remove("/registry_a"));
+  EXPECT_TRUE(add(registry,
+    "/registry_a@std_msgs/String]ignition.msgs.StringMsg"));
+  EXPECT_TRUE(add(registry,
+    "/registry_a@std_msgs/String[ignition.msgs.StringMsg"));
+  EXPECT_EQ(2u, registry.remove("/registry_a"));
+  EXPECT_EQ(2u, registry.list().size());
+}
+
+/////////////////////////////////////////////////
+TEST(BridgeRegistryTest, InvalidBridge)
+{
+  BridgeRegistry registry(ros::NodeHandle(),
+    std::make_shared<ignition::transport::Node>());
+
+  // Rejected bridges don't reserve their topics.
+  std::string error;
+  EXPECT_FALSE(registry.add(bridge(
+    "/registry_invalid@std_msgs/String@ignition.msgs.Twist"), error));
+  EXPECT_FALSE(error.empty());
+  BridgeConfig config = bridge(
+    "/registry_invalid@std_msgs/String@ignition.msgs.StringMsg");
+  config.executor = "missing";
+  EXPECT_FALSE(registry.add(config, error));
+  EXPECT_FALSE(registry.add(bridge(
+    "/registry_*@std_msgs/String@ignition.msgs.StringMsg"), error));
+
+  EXPECT_TRUE(add(registry,
+    "/registry_invalid@std_msgs/String@ignition.msgs.StringMsg"));
+  EXPECT_EQ(1u, registry.list().size());
+}
+
+/////////////////////////////////////////////////
+TEST(BridgeRegistryTest, ManyBridges)
+{
+  BridgeRegistry registry(ros::NodeHandle(),
+    std::make_shared<ignition::transport::Node>());
+
+  const size_t count = 500;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const std::string topic = "/registry_many_" + std::to_string(i);
+    BridgeConfig config = bridge(
+      topic + "@std_msgs/String[ignition.msgs.StringMsg");
+    config.lazy = true;
+    std::string error;
+    ASSERT_TRUE(registry.add(config, error)) << error;
+  }
+  EXPECT_EQ(count, registry.list().size());
+  EXPECT_FALSE(add(registry,
+    "/registry_many_250@std_msgs/String[ignition.msgs.StringMsg"));
+
+  registry.clear();
+  EXPECT_TRUE(registry.list().empty());
+  EXPECT_FALSE(add(registry,
+    "/registry_many_0@std_msgs/String[ignition.msgs.StringMsg"));
+}
+
+/////////////////////////////////////////////////
+TEST(BridgeRegistryTest, ConcurrentAdds)
+{
+  BridgeRegistry registry(ros::NodeHandle(),
+    std::make_shared<ignition::transport::Node>());
+
+  // The topics are checked and reserved under the same lock, so exactly one
+  // of the threads adding the same topic succeeds.
+  for (int round = 0; round < 10; ++round)
+  {
+    const std::string spec = "/registry_race_" + std::to_string(round) +
+      "@std_msgs/String@ignition.msgs.StringMsg";
+    std::atomic<int> added{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i)
+    {
+      threads.emplace_back([&registry, &spec, &added]
+        {
+          if (add(registry, spec))
+            ++added;
+        });
+    }
+    for (auto & thread : threads)
+      thread.join();
+    EXPECT_EQ(1, added.load()) << spec;
+  }
+  EXPECT_EQ(10u, registry.list().size());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "bridge_registry_test");
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Forwards an Ignition clock to ROS 1 with ros1_ign_bridge::ClockBridge,
+// in order and across a world reset.
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <rosgraph_msgs/Clock.h>
+#include <ignition/msgs.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/clock_bridge.hpp"
+
+using ros1_ign_bridge::ClockBridge;
+using ros1_ign_bridge::ClockBridgeConfig;
+
+namespace
+{
+
+/// \brief Seconds of the times received on a ROS 1 clock topic.
+class ClockRecorder
+{
+public:
+  explicit ClockRecorder(const std::string & topic)
+  {
+    ros::NodeHandle n;
+    sub_ = n.subscribe(topic, 100, &ClockRecorder::on_clock, this);
+  }
+
+  bool
+  connected() const
+  {
+    return sub_.getNumPublishers() > 0;
+  }
+
+  std::vector<uint32_t>
+  seconds()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return seconds_;
+  }
+
+  /// \brief Wait until the latest time received is sec.
+  bool
+  wait_for(uint32_t sec, double timeout = 5.0)
+  {
+    const auto end = std::chrono::steady_clock::now() +
+      std::chrono::duration<double>(timeout);
+    while (std::chrono::steady_clock::now() < end)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!seconds_.empty() && seconds_.back() == sec)
+          return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+  }
+
+private:
+  void
+  on_clock(const rosgraph_msgs::Clock::ConstPtr & msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    seconds_.push_back(msg->clock.sec);
+  }
+
+  ros::Subscriber sub_;
+  std::mutex mutex_;
+  std::vector<uint32_t> seconds_;
+};
+
+//////////////////////////////////////////////////
+void publish(ignition::transport::Node::Publisher & pub, int64_t sec)
+{
+  ignition::msgs::Clock msg;
+  msg.mutable_sim()->set_sec(sec);
+  pub.Publish(msg);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+}
+
+//////////////////////////////////////////////////
+/// \brief Connect both sides of the bridge and forward a time of 1 s. The
+/// repeats of that time are dropped by the bridge.
+bool connect(ignition::transport::Node::Publisher & pub,
+  const ClockBridge & bridge, ClockRecorder & recorder)
+{
+  for (int i = 0; i < 250 && !recorder.connected(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  for (int i = 0; i < 250 && bridge.received() == 0; ++i)
+    publish(pub, 1);
+  return recorder.wait_for(1);
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////
+TEST(ClockBridgeTest, ForwardsInOrder)
+{
+  ClockBridgeConfig config;
+  config.ign_topic_name = config.ros1_topic_name = "/clock_in_order";
+  auto ign_node = std::make_shared<ignition::transport::Node>();
+  ClockBridge bridge(ros::NodeHandle(), ign_node, config);
+
+  ClockRecorder recorder(config.ros1_topic_name);
+  auto pub = ign_node->Advertise<ignition::msgs::Clock>(config.ign_topic_name);
+  ASSERT_TRUE(connect(pub, bridge, recorder));
+
+  // Repeated times are dropped, new ones forwarded in order.
+  for (const int64_t sec : {2, 2, 3, 4, 4, 5})
+    publish(pub, sec);
+  ASSERT_TRUE(recorder.wait_for(5));
+
+  EXPECT_EQ(std::vector<uint32_t>({1, 2, 3, 4, 5}), recorder.seconds());
+  EXPECT_EQ(5u, bridge.published());
+  EXPECT_EQ(0u, bridge.backwards());
+}
+
+/////////////////////////////////////////////////
+TEST(ClockBridgeTest, WorldReset)
+{
+  // A long period, so that a reset waiting for it would be noticed.
+  ClockBridgeConfig config;
+  config.ign_topic_name = config.ros1_topic_name = "/clock_reset";
+  config.max_rate = 0.5;
+  auto ign_node = std::make_shared<ignition::transport::Node>();
+  ClockBridge bridge(ros::NodeHandle(), ign_node, config);
+
+  ClockRecorder recorder(config.ros1_topic_name);
+  auto pub = ign_node->Advertise<ignition::msgs::Clock>(config.ign_topic_name);
+  ASSERT_TRUE(connect(pub, bridge, recorder));
+  publish(pub, 50);
+  ASSERT_TRUE(recorder.wait_for(50));
+
+  // The clock goes back to the new time and carries on from there, instead
+  // of staying at 50 s until the simulation catches up.
+  const auto start = std::chrono::steady_clock::now();
+  publish(pub, 0);
+  ASSERT_TRUE(recorder.wait_for(0));
+  EXPECT_LT(std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count(), 1.0);
+  EXPECT_EQ(1u, bridge.backwards());
+
+  publish(pub, 1);
+  ASSERT_TRUE(recorder.wait_for(1));
+  EXPECT_EQ(std::vector<uint32_t>({1, 50, 0, 1}), recorder.seconds());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "clock_bridge_test");
+  ros::AsyncSpinner spinner(1);
+  spinner.start();
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Loads the converter of test/plugin/, whose package converter_plugins.test
+// puts on ROS_PACKAGE_PATH, through the factory lookup of the bridge.
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+#include <ros/master.h>
+#include <ros/ros.h>
+
+#include "ros1_ign_bridge/builtin_interfaces_factories.hpp"
+#include "ros1_ign_bridge/converter_plugins.hpp"
+
+/////////////////////////////////////////////////
+TEST(ConverterPluginsTest, DeclaredPairs)
+{
+  const auto pairs = ros1_ign_bridge::get_plugin_type_pairs();
+  EXPECT_NE(pairs.end(), std::find(pairs.begin(), pairs.end(),
+    std::make_pair(std::string("std_msgs/UInt32"),
+                   std::string("ignition.msgs.UInt32"))));
+
+  // The declaration without a type pair is skipped.
+  for (const auto & pair : pairs)
+  {
+    EXPECT_FALSE(pair.first.empty());
+    EXPECT_FALSE(pair.second.empty());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ConverterPluginsTest, Factory)
+{
+  auto factory = ros1_ign_bridge::get_factory_from_plugins(
+    "std_msgs/UInt32", "ignition.msgs.UInt32");
+  ASSERT_NE(nullptr, factory);
+
+  // The bridges get it when no builtin factory handles the pair, once.
+  auto bridge_factory = ros1_ign_bridge::get_factory(
+    "std_msgs/UInt32", "ignition.msgs.UInt32");
+  ASSERT_NE(nullptr, bridge_factory);
+  EXPECT_EQ(bridge_factory, ros1_ign_bridge::get_factory(
+    "std_msgs/UInt32", "ignition.msgs.UInt32"));
+
+  // Builtin pairs don't go through the plugins.
+  EXPECT_EQ(nullptr, ros1_ign_bridge::get_factory_from_plugins(
+    "std_msgs/String", "ignition.msgs.StringMsg"));
+  EXPECT_NE(nullptr, ros1_ign_bridge::get_factory(
+    "std_msgs/String", "ignition.msgs.StringMsg"));
+
+  // Neither builtin nor declared.
+  EXPECT_EQ(nullptr, ros1_ign_bridge::get_factory_from_plugins(
+    "std_msgs/UInt64", "ignition.msgs.UInt64"));
+  EXPECT_THROW(ros1_ign_bridge::get_factory(
+    "std_msgs/UInt64", "ignition.msgs.UInt64"), std::runtime_error);
+}
+
+/////////////////////////////////////////////////
+TEST(ConverterPluginsTest, Publisher)
+{
+  // The factory of the plugin advertises its ROS 1 type.
+  auto factory = ros1_ign_bridge::get_factory(
+    "std_msgs/UInt32", "ignition.msgs.UInt32");
+  ros::NodeHandle n;
+  ros::Publisher pub = factory->create_ros1_publisher(n, "/plugin_uint32", 1);
+  ASSERT_TRUE(pub);
+
+  ros::master::V_TopicInfo topics;
+  ASSERT_TRUE(ros::master::getTopics(topics));
+  const auto topic = std::find_if(topics.begin(), topics.end(),
+    [](const ros::master::TopicInfo & info)
+    {
+      return info.name == "/plugin_uint32";
+    });
+  ASSERT_NE(topics.end(), topic);
+  EXPECT_EQ("std_msgs/UInt32", topic->datatype);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "converter_plugins_test");
+
+  return RUN_ALL_TESTS();
+}
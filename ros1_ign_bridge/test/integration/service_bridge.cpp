@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Calls services through a parameter_bridge configured with
+// test_service_bridge.launch, in both directions and past their timeouts.
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <std_srvs/SetBool.h>
+#include <ignition/msgs.hh>
+#include <ignition/transport/Node.hh>
+
+namespace
+{
+
+//////////////////////////////////////////////////
+bool fast_set_bool(
+  std_srvs::SetBool::Request & req, std_srvs::SetBool::Response & res)
+{
+  res.success = req.data;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool medium_set_bool(
+  std_srvs::SetBool::Request & req, std_srvs::SetBool::Response & res)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  res.success = req.data;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool slow_set_bool(
+  std_srvs::SetBool::Request &, std_srvs::SetBool::Response & res)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  res.success = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Call an Ignition service, retrying while the bridge starts.
+bool ign_call(
+  ignition::transport::Node & node,
+  const std::string & service,
+  bool data,
+  bool & reply,
+  double & seconds)
+{
+  ignition::msgs::Boolean req;
+  req.set_data(data);
+  ignition::msgs::Boolean rep;
+  bool result = false;
+  for (int i = 0; i < 50; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    const bool executed = node.Request(service, req, 3000, rep, result);
+    seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+    if (executed)
+    {
+      reply = result && rep.data();
+      return result;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  return false;
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////
+TEST(ServiceBridgeTest, IgnToRos)
+{
+  ros::NodeHandle n;
+  ros::ServiceServer server = n.advertiseService("/fast_set_bool",
+    &fast_set_bool);
+
+  ignition::transport::Node ign_node;
+  bool reply = false;
+  double seconds = 0.0;
+  EXPECT_TRUE(ign_call(ign_node, "/fast_set_bool", true, reply, seconds));
+  EXPECT_TRUE(reply);
+  EXPECT_TRUE(ign_call(ign_node, "/fast_set_bool", false, reply, seconds));
+  EXPECT_FALSE(reply);
+}
+
+/////////////////////////////////////////////////
+TEST(ServiceBridgeTest, IgnToRosDefaultTimeout)
+{
+  ros::NodeHandle n;
+  ros::ServiceServer server = n.advertiseService("/medium_set_bool",
+    &medium_set_bool);
+
+  // Without ign_reply_timeout, a service shorter than timeout succeeds.
+  ignition::transport::Node ign_node;
+  bool reply = false;
+  double seconds = 0.0;
+  EXPECT_TRUE(ign_call(ign_node, "/medium_set_bool", true, reply, seconds));
+  EXPECT_TRUE(reply);
+  EXPECT_GT(seconds, 0.25);
+  EXPECT_TRUE(ign_call(ign_node, "/medium_set_bool", true, reply, seconds));
+  EXPECT_TRUE(reply);
+}
+
+/////////////////////////////////////////////////
+TEST(ServiceBridgeTest, IgnToRosReplyTimeout)
+{
+  ros::NodeHandle n;
+  ros::ServiceServer server = n.advertiseService("/slow_set_bool",
+    &slow_set_bool);
+
+  // The Ignition caller gets a failure after ign_reply_timeout, well before
+  // the ROS 1 service replies or the 5 s timeout expires.
+  ignition::transport::Node ign_node;
+  bool reply = false;
+  double seconds = 0.0;
+  EXPECT_FALSE(ign_call(ign_node, "/slow_set_bool", true, reply, seconds));
+  EXPECT_LT(seconds, 1.0);
+
+  // While that call runs, new requests fail without waiting.
+  EXPECT_FALSE(ign_call(ign_node, "/slow_set_bool", true, reply, seconds));
+  EXPECT_LT(seconds, 0.15);
+
+  // Once it is done the service can be called again.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1600));
+  EXPECT_FALSE(ign_call(ign_node, "/slow_set_bool", true, reply, seconds));
+  EXPECT_GT(seconds, 0.15);
+}
+
+/////////////////////////////////////////////////
+TEST(ServiceBridgeTest, RosToIgn)
+{
+  ignition::transport::Node ign_node;
+  std::function<bool(const ignition::msgs::Boolean &,
+                     ignition::msgs::Boolean &)> cb =
+    [](const ignition::msgs::Boolean & req, ignition::msgs::Boolean & rep)
+    {
+      rep.set_data(!req.data());
+      return true;
+    };
+  ASSERT_TRUE(ign_node.Advertise("/ign_set_bool", cb));
+
+  ASSERT_TRUE(ros::service::waitForService("/ign_set_bool", 5000));
+  std_srvs::SetBool srv;
+  srv.request.data = false;
+  ASSERT_TRUE(ros::service::call("/ign_set_bool", srv));
+  EXPECT_TRUE(srv.response.success);
+
+  // A service that doesn't answer fails after the timeout.
+  ASSERT_TRUE(ign_node.UnadvertiseSrv("/ign_set_bool"));
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(ros::service::call("/ign_set_bool", srv));
+  EXPECT_LT(std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count(), 2.0);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "service_bridge_test");
+  ros::AsyncSpinner spinner(2);
+  spinner.start();
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,468 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef ROS1_IGN_BRIDGE__LOAD_GENERATOR_H_
+#define ROS1_IGN_BRIDGE__LOAD_GENERATOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/msgs.hh>
+#include <ros/ros.h>
+#include <sensor_msgs/Image.h>
+#include <sensor_msgs/LaserScan.h>
+#include <std_msgs/String.h>
+
+#include "ros1_ign_bridge/bridge_stats.hpp"
+
+namespace ros1_ign_bridge
+{
+namespace testing
+{
+
+/// \brief Settings of the load generation mode of the test publishers,
+/// enabled with --load on their command line.
+struct LoadOptions
+{
+  /// \brief Number of topics, named <prefix>0 to <prefix>N-1.
+  size_t topics = 1;
+
+  /// \brief Messages per second and topic.
+  double rate = 100.0;
+
+  /// \brief Payload size in bytes: image data, 4 bytes per laser range or
+  /// string length.
+  size_t payload = 1024;
+
+  /// \brief "image", "laserscan" or "string".
+  std::string type = "image";
+
+  /// \brief Run time in seconds, 0 to run until interrupted.
+  double duration = 0.0;
+
+  std::string prefix = "load_";
+
+  /// \brief Print the report every second and the totals at the end.
+  bool verbose = true;
+};
+
+/// \brief Print the load generation options.
+inline void
+load_usage(const char * program)
+{
+  std::cerr << "Usage: " << program << " [--load [--topics N] [--rate HZ]\n"
+            << "  [--payload BYTES] [--type image|laserscan|string]\n"
+            << "  [--duration S] [--prefix NAME]]\n\n"
+            << "Without --load, publishes one test message per supported "
+            << "type.\nWith --load, publishes on N topics and receives them "
+            << "back on the\nother side of the bridge, reporting the "
+            << "delivered rate and the\nend-to-end latency of every topic "
+            << "each second." << std::endl;
+}
+
+/// \brief Parse the command line of a test publisher.
+/// \param[out] options Load settings, when --load is given.
+/// \param[out] load Whether --load was given.
+/// \return False if the command line is invalid.
+inline bool
+parse_load_options(int argc, char ** argv, LoadOptions & options, bool & load)
+{
+  load = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    // ROS remapping arguments.
+    if (arg.find(":=") != std::string::npos)
+      continue;
+    if (arg == "--load")
+    {
+      load = true;
+      continue;
+    }
+    if (i + 1 >= argc)
+      return false;
+    const std::string value = argv[++i];
+    if (arg == "--topics")
+      options.topics = std::strtoul(value.c_str(), nullptr, 10);
+    else if (arg == "--rate")
+      options.rate = std::atof(value.c_str());
+    else if (arg == "--payload")
+      options.payload = std::strtoul(value.c_str(), nullptr, 10);
+    else if (arg == "--type")
+      options.type = value;
+    else if (arg == "--duration")
+      options.duration = std::atof(value.c_str());
+    else if (arg == "--prefix")
+      options.prefix = value;
+    else
+      return false;
+  }
+  return options.topics > 0 && options.rate > 0.0 &&
+    (options.type == "image" || options.type == "laserscan" ||
+     options.type == "string");
+}
+
+/// \brief Wall clock time embedded in the messages. Both ends of a
+/// measurement run in the same process, so any clock shared by its threads
+/// would do; the wall clock also fits in a header stamp.
+inline int64_t
+load_now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/// \brief Write a send time at the start of a string payload.
+inline void
+encode_load_stamp(int64_t stamp_ns, std::string & data)
+{
+  char prefix[21];
+  std::snprintf(prefix, sizeof(prefix), "%020lld",
+    static_cast<long long>(stamp_ns));
+  if (data.size() < 20)
+    data.resize(20);
+  data.replace(0, 20, prefix);
+}
+
+/// \brief Read the send time written by encode_load_stamp(), 0 if missing.
+inline int64_t
+decode_load_stamp(const std::string & data)
+{
+  if (data.size() < 20)
+    return 0;
+  return std::strtoll(data.substr(0, 20).c_str(), nullptr, 10);
+}
+
+//////////////////////////////////////////////////
+/// \brief Load messages of the requested payload size. The stamp is set
+/// before each publication with set_load_stamp().
+inline void
+make_load_msg(size_t payload, ignition::msgs::Image & msg)
+{
+  msg.set_width(static_cast<uint32_t>(payload));
+  msg.set_height(1);
+  msg.set_step(static_cast<uint32_t>(payload));
+  msg.set_pixel_format_type(ignition::msgs::PixelFormatType::L_INT8);
+  msg.set_data(std::string(payload, '\x7f'));
+}
+
+inline void
+make_load_msg(size_t payload, ignition::msgs::LaserScan & msg)
+{
+  const size_t count = payload / 4 > 0 ? payload / 4 : 1;
+  msg.set_frame("load");
+  msg.set_angle_min(0.0);
+  msg.set_angle_max(static_cast<double>(count));
+  msg.set_angle_step(1.0);
+  msg.set_range_min(0.0);
+  msg.set_range_max(100.0);
+  msg.set_count(static_cast<uint32_t>(count));
+  msg.set_vertical_count(1);
+  for (size_t i = 0; i < count; ++i)
+  {
+    msg.add_ranges(1.0);
+    msg.add_intensities(1.0);
+  }
+}
+
+inline void
+make_load_msg(size_t payload, ignition::msgs::StringMsg & msg)
+{
+  msg.set_data(std::string(payload, 'x'));
+}
+
+inline void
+make_load_msg(size_t payload, sensor_msgs::Image & msg)
+{
+  msg.width = static_cast<uint32_t>(payload);
+  msg.height = 1;
+  msg.step = static_cast<uint32_t>(payload);
+  msg.encoding = "mono8";
+  msg.data.assign(payload, 0x7f);
+}
+
+inline void
+make_load_msg(size_t payload, sensor_msgs::LaserScan & msg)
+{
+  const size_t count = payload / 4 > 0 ? payload / 4 : 1;
+  msg.header.frame_id = "load";
+  msg.angle_min = 0.0f;
+  msg.angle_max = static_cast<float>(count);
+  msg.angle_increment = 1.0f;
+  msg.range_min = 0.0f;
+  msg.range_max = 100.0f;
+  msg.ranges.assign(count, 1.0f);
+  msg.intensities.assign(count, 1.0f);
+}
+
+inline void
+make_load_msg(size_t payload, std_msgs::String & msg)
+{
+  msg.data.assign(payload, 'x');
+}
+
+//////////////////////////////////////////////////
+/// \brief Embed the send time in a load message.
+template<typename IGN_T>
+void
+set_load_stamp(int64_t stamp_ns, IGN_T & msg)
+{
+  auto stamp = msg.mutable_header()->mutable_stamp();
+  stamp->set_sec(stamp_ns / 1000000000);
+  stamp->set_nsec(stamp_ns % 1000000000);
+}
+
+inline void
+set_load_stamp(int64_t stamp_ns, ignition::msgs::StringMsg & msg)
+{
+  encode_load_stamp(stamp_ns, *msg.mutable_data());
+}
+
+inline void
+set_load_stamp(int64_t stamp_ns, sensor_msgs::Image & msg)
+{
+  msg.header.stamp.fromNSec(stamp_ns);
+}
+
+inline void
+set_load_stamp(int64_t stamp_ns, sensor_msgs::LaserScan & msg)
+{
+  msg.header.stamp.fromNSec(stamp_ns);
+}
+
+inline void
+set_load_stamp(int64_t stamp_ns, std_msgs::String & msg)
+{
+  encode_load_stamp(stamp_ns, msg.data);
+}
+
+//////////////////////////////////////////////////
+/// \brief Send time embedded in a load message, 0 if missing.
+template<typename IGN_T>
+int64_t
+get_load_stamp(const IGN_T & msg)
+{
+  return msg.header().stamp().sec() * 1000000000LL +
+    msg.header().stamp().nsec();
+}
+
+inline int64_t
+get_load_stamp(const ignition::msgs::StringMsg & msg)
+{
+  return decode_load_stamp(msg.data());
+}
+
+inline int64_t
+get_load_stamp(const sensor_msgs::Image & msg)
+{
+  return static_cast<int64_t>(msg.header.stamp.toNSec());
+}
+
+inline int64_t
+get_load_stamp(const sensor_msgs::LaserScan & msg)
+{
+  return static_cast<int64_t>(msg.header.stamp.toNSec());
+}
+
+inline int64_t
+get_load_stamp(const std_msgs::String & msg)
+{
+  return decode_load_stamp(msg.data);
+}
+
+/// \brief Messages sent and received per topic, and the end-to-end
+/// latencies of the received ones.
+class LoadReport
+{
+public:
+  explicit LoadReport(const LoadOptions & options)
+  : options_(options),
+    topics_(options.topics)
+  {}
+
+  /// \brief Count a message published on a topic.
+  void
+  sent(size_t topic)
+  {
+    topics_[topic].sent.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// \brief Count a message received back, with the time it was sent.
+  void
+  received(size_t topic, int64_t stamp_ns)
+  {
+    auto & counters = topics_[topic];
+    counters.received.fetch_add(1, std::memory_order_relaxed);
+    if (stamp_ns > 0)
+    {
+      const int64_t latency_ns = load_now_ns() - stamp_ns;
+      counters.latency.record(latency_ns);
+      overall_latency_.record(latency_ns);
+    }
+  }
+
+  /// \brief Messages sent and received on all topics since the start, and
+  /// their latencies.
+  /// \param[out] counts Latency histogram of all the received messages.
+  void
+  totals(
+    uint64_t & sent,
+    uint64_t & received,
+    LatencyHistogram::Counts & counts)
+  {
+    sent = 0;
+    received = 0;
+    for (const auto & counters : topics_)
+    {
+      sent += counters.sent.load(std::memory_order_relaxed);
+      received += counters.received.load(std::memory_order_relaxed);
+    }
+    overall_latency_.take(counts);
+  }
+
+  /// \brief Print, for each topic, the rates and latencies since the
+  /// previous call.
+  /// \param[in] period Time since the previous call, in seconds.
+  void
+  print(double period)
+  {
+    for (size_t i = 0; i < topics_.size(); ++i)
+    {
+      auto & counters = topics_[i];
+      const uint64_t sent = counters.sent.load(std::memory_order_relaxed);
+      const uint64_t received =
+        counters.received.load(std::memory_order_relaxed);
+
+      LatencyHistogram::Counts counts;
+      const uint64_t max_ns = counters.latency.take(counts);
+
+      std::printf("%s%zu: sent %.1f Hz, delivered %.1f Hz, "
+                  "latency p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+        options_.prefix.c_str(), i,
+        (sent - counters.last_sent) / period,
+        (received - counters.last_received) / period,
+        LatencyHistogram::percentile(counts, 0.5) * 1e-6,
+        LatencyHistogram::percentile(counts, 0.99) * 1e-6,
+        max_ns * 1e-6);
+
+      counters.last_sent = sent;
+      counters.last_received = received;
+      counters.total_sent = sent;
+      counters.total_received = received;
+    }
+    std::fflush(stdout);
+  }
+
+  /// \brief Print the messages lost on each topic over the whole run.
+  void
+  print_totals()
+  {
+    for (size_t i = 0; i < topics_.size(); ++i)
+    {
+      const auto & counters = topics_[i];
+      std::printf("%s%zu: %llu sent, %llu delivered\n",
+        options_.prefix.c_str(), i,
+        static_cast<unsigned long long>(counters.total_sent),
+        static_cast<unsigned long long>(counters.total_received));
+    }
+    std::fflush(stdout);
+  }
+
+private:
+  struct Counters
+  {
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> received{0};
+    LatencyHistogram latency;
+    uint64_t last_sent = 0;
+    uint64_t last_received = 0;
+    uint64_t total_sent = 0;
+    uint64_t total_received = 0;
+  };
+
+  LoadOptions options_;
+  std::vector<Counters> topics_;
+  LatencyHistogram overall_latency_;
+};
+
+/// \brief Call publish(topic) for every topic at the configured rate and
+/// print the report every second, until stop() returns true or the duration
+/// elapses.
+template<typename StopFn, typename PublishFn>
+void
+run_load(
+  const LoadOptions & options,
+  LoadReport & report,
+  StopFn stop,
+  PublishFn publish)
+{
+  using Clock = std::chrono::steady_clock;
+  const auto period = std::chrono::duration_cast<Clock::duration>(
+    std::chrono::duration<double>(1.0 / options.rate));
+  const auto start = Clock::now();
+  auto next_publish = start;
+  auto next_report = start + std::chrono::seconds(1);
+  auto last_report = start;
+
+  while (!stop())
+  {
+    for (size_t topic = 0; topic < options.topics; ++topic)
+    {
+      publish(topic);
+      report.sent(topic);
+    }
+
+    // Late iterations are not made up for, so an overloaded machine shows
+    // up as a sent rate below the requested one.
+    next_publish += period;
+    const auto now = Clock::now();
+    if (next_publish < now)
+      next_publish = now;
+
+    if (options.verbose && now >= next_report)
+    {
+      report.print(std::chrono::duration<double>(now - last_report).count());
+      last_report = now;
+      next_report = now + std::chrono::seconds(1);
+    }
+
+    if (options.duration > 0.0 &&
+        std::chrono::duration<double>(now - start).count() >= options.duration)
+    {
+      break;
+    }
+    std::this_thread::sleep_until(next_publish);
+  }
+
+  // Let the last messages arrive before the totals.
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  if (options.verbose)
+    report.print_totals();
+}
+
+}  // namespace testing
+}  // namespace ros1_ign_bridge
+
+#endif  // ROS1_IGN_BRIDGE__LOAD_GENERATOR_H_
@@ -0,0 +1,453 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Runs a parameter_bridge started by test/bridge_perf.test under fixed
+// synthetic loads and writes the measurements to a CSV file. Every run checks
+// the share of messages delivered and the p99 latency against limits that
+// hold on any machine able to run the loads, and compares the rest with
+// test/perf/baseline.csv when it has the scenario.
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ignition/msgs.hh>
+#include <ignition/transport/Node.hh>
+#include <ros/master.h>
+#include <ros/network.h>
+#include <ros/ros.h>
+#include <sensor_msgs/Image.h>
+#include <std_msgs/String.h>
+#include <XmlRpcClient.h>
+
+#include "ros1_ign_bridge/AddBridge.h"
+#include "ros1_ign_bridge/RemoveBridge.h"
+#include "../load_generator.h"
+
+using ros1_ign_bridge::LatencyHistogram;
+using ros1_ign_bridge::testing::LoadOptions;
+using ros1_ign_bridge::testing::LoadReport;
+
+namespace
+{
+
+/// \brief A fixed load.
+struct Scenario
+{
+  std::string name;
+  LoadOptions load;
+  bool ros_to_ign;
+
+  /// \brief Smallest share of the sent messages that must be delivered.
+  double min_delivered_ratio;
+
+  /// \brief Largest acceptable p99 latency.
+  double max_p99_ms;
+};
+
+/// \brief Measurements of one scenario, as written to the CSV file.
+struct Result
+{
+  /// \brief Messages delivered per second, all topics together.
+  double throughput = 0.0;
+  double p50_ms = 0.0;
+  double p99_ms = 0.0;
+
+  /// \brief CPU time of the bridge process per delivered message.
+  double cpu_us_per_msg = 0.0;
+
+  uint64_t sent = 0;
+  uint64_t delivered = 0;
+};
+
+const char kCsvHeader[] =
+  "scenario,throughput,p50_ms,p99_ms,cpu_us_per_msg,sent,delivered";
+
+/// \brief Name of the bridge node, see test/launch/test_bridge_perf.launch.
+const char kBridgeNode[] = "/perf_bridge";
+
+//////////////////////////////////////////////////
+/// \brief Process id of a ROS 1 node, from its getPid XML-RPC call.
+int node_pid(const std::string & node_name)
+{
+  XmlRpc::XmlRpcValue args, result, payload;
+  args[0] = ros::this_node::getName();
+  args[1] = node_name;
+  if (!ros::master::execute("lookupNode", args, result, payload, true))
+    return -1;
+
+  std::string host;
+  uint32_t port = 0;
+  if (!ros::network::splitURI(static_cast<std::string>(payload), host, port))
+    return -1;
+
+  XmlRpc::XmlRpcClient client(host.c_str(), port, "/");
+  XmlRpc::XmlRpcValue pid_args, pid_result;
+  pid_args[0] = ros::this_node::getName();
+  if (!client.execute("getPid", pid_args, pid_result) ||
+      pid_result.getType() != XmlRpc::XmlRpcValue::TypeArray ||
+      pid_result.size() < 3)
+  {
+    return -1;
+  }
+  return static_cast<int>(pid_result[2]);
+}
+
+//////////////////////////////////////////////////
+/// \brief User and system CPU time used by a process so far, in seconds.
+double process_cpu_seconds(int pid)
+{
+  std::ifstream file("/proc/" + std::to_string(pid) + "/stat");
+  std::string line;
+  if (pid <= 0 || !std::getline(file, line))
+    return 0.0;
+
+  // The command name may contain spaces; the fields restart after its ")".
+  std::istringstream fields(line.substr(line.rfind(')') + 2));
+  std::string field;
+  unsigned long long utime = 0, stime = 0;
+  for (int i = 3; i <= 15 && fields >> field; ++i)
+  {
+    if (i == 14)
+      utime = std::stoull(field);
+    else if (i == 15)
+      stime = std::stoull(field);
+  }
+  return static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+}
+
+//////////////////////////////////////////////////
+/// \brief Add or remove the bridges of a scenario through the control
+/// services of the bridge.
+bool set_bridges(
+  const Scenario & scenario,
+  const std::string & ros1_type,
+  const std::string & ign_type,
+  bool add)
+{
+  ros::NodeHandle n;
+  for (size_t i = 0; i < scenario.load.topics; ++i)
+  {
+    const std::string topic = "/" + scenario.load.prefix + std::to_string(i);
+    if (add)
+    {
+      ros1_ign_bridge::AddBridge srv;
+      srv.request.spec = topic + "@" + ros1_type +
+        (scenario.ros_to_ign ? "]" : "[") + ign_type;
+      srv.request.queue_size = 100;
+      if (!ros::service::call(std::string(kBridgeNode) + "/add_bridge", srv) ||
+          !srv.response.success)
+      {
+        return false;
+      }
+    }
+    else
+    {
+      ros1_ign_bridge::RemoveBridge srv;
+      srv.request.topic = topic;
+      ros::service::call(std::string(kBridgeNode) + "/remove_bridge", srv);
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Publish the load of a scenario on one side of the bridge and
+/// measure what arrives on the other side.
+template<typename ROS1_T, typename IGN_T>
+Result run_scenario(const Scenario & scenario, int bridge_pid)
+{
+  ros::NodeHandle n;
+  ignition::transport::Node node;
+  const LoadOptions & options = scenario.load;
+  LoadReport warmup_report(options);
+  LoadReport report(options);
+  // The callbacks count into the warm-up report until the measurement.
+  std::atomic<LoadReport *> current{&warmup_report};
+
+  std::vector<ros::Publisher> ros1_pubs;
+  std::vector<ros::Subscriber> ros1_subs;
+  std::vector<ignition::transport::Node::Publisher> ign_pubs;
+  for (size_t i = 0; i < options.topics; ++i)
+  {
+    const std::string topic = "/" + options.prefix + std::to_string(i);
+    if (scenario.ros_to_ign)
+    {
+      ros1_pubs.push_back(n.advertise<ROS1_T>(topic, 1000));
+      std::function<void(const IGN_T &)> cb =
+        [&current, i](const IGN_T & msg)
+        {
+          current.load()->received(i,
+            ros1_ign_bridge::testing::get_load_stamp(msg));
+        };
+      node.Subscribe(topic, cb);
+    }
+    else
+    {
+      ign_pubs.push_back(node.Advertise<IGN_T>(topic));
+      boost::function<void(const boost::shared_ptr<ROS1_T const> &)> cb =
+        [&current, i](const boost::shared_ptr<ROS1_T const> & msg)
+        {
+          current.load()->received(i,
+            ros1_ign_bridge::testing::get_load_stamp(*msg));
+        };
+      ros1_subs.push_back(n.subscribe<ROS1_T>(topic, 1000, cb));
+    }
+  }
+
+  ros::AsyncSpinner spinner(1);
+  spinner.start();
+
+  // Wait for the ROS 1 connections; Ignition discovery has no equivalent
+  // and is covered by the warm-up.
+  for (int i = 0; i < 100; ++i)
+  {
+    bool connected = true;
+    for (const auto & pub : ros1_pubs)
+      connected = connected && pub.getNumSubscribers() > 0;
+    for (const auto & sub : ros1_subs)
+      connected = connected && sub.getNumPublishers() > 0;
+    if (connected)
+      break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  ROS1_T ros1_msg;
+  IGN_T ign_msg;
+  ros1_ign_bridge::testing::make_load_msg(options.payload, ros1_msg);
+  ros1_ign_bridge::testing::make_load_msg(options.payload, ign_msg);
+  auto publish = [&](size_t topic)
+    {
+      const int64_t now = ros1_ign_bridge::testing::load_now_ns();
+      if (scenario.ros_to_ign)
+      {
+        ros1_ign_bridge::testing::set_load_stamp(now, ros1_msg);
+        ros1_pubs[topic].publish(ros1_msg);
+      }
+      else
+      {
+        ros1_ign_bridge::testing::set_load_stamp(now, ign_msg);
+        ign_pubs[topic].Publish(ign_msg);
+      }
+    };
+  auto stop = [] { return !ros::ok(); };
+
+  LoadOptions warmup = options;
+  warmup.duration = 1.0;
+  ros1_ign_bridge::testing::run_load(warmup, warmup_report, stop, publish);
+
+  current.store(&report);
+  const double cpu_start = process_cpu_seconds(bridge_pid);
+  const auto start = std::chrono::steady_clock::now();
+  ros1_ign_bridge::testing::run_load(options, report, stop, publish);
+  const double elapsed = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+  const double cpu = process_cpu_seconds(bridge_pid) - cpu_start;
+
+  spinner.stop();
+
+  Result result;
+  LatencyHistogram::Counts counts;
+  report.totals(result.sent, result.delivered, counts);
+  result.throughput = result.delivered / elapsed;
+  result.p50_ms = LatencyHistogram::percentile(counts, 0.5) * 1e-6;
+  result.p99_ms = LatencyHistogram::percentile(counts, 0.99) * 1e-6;
+  if (result.delivered > 0)
+    result.cpu_us_per_msg = cpu * 1e6 / result.delivered;
+  return result;
+}
+
+//////////////////////////////////////////////////
+/// \brief Baseline results by scenario name.
+std::map<std::string, Result> load_baseline(const std::string & path)
+{
+  std::map<std::string, Result> baseline;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() || line[0] == '#' || line == kCsvHeader)
+      continue;
+    std::istringstream fields(line);
+    std::string name, value;
+    std::vector<double> values;
+    std::getline(fields, name, ',');
+    while (std::getline(fields, value, ','))
+      values.push_back(std::atof(value.c_str()));
+    if (values.size() < 4)
+      continue;
+    Result & result = baseline[name];
+    result.throughput = values[0];
+    result.p50_ms = values[1];
+    result.p99_ms = values[2];
+    result.cpu_us_per_msg = values[3];
+  }
+  return baseline;
+}
+
+/// \brief Settings of the test, from its private parameters.
+struct Settings
+{
+  std::string results = "bridge_perf.csv";
+  std::string baseline;
+  double throughput_tolerance = 0.1;
+  double latency_tolerance = 0.5;
+  double latency_floor_ms = 0.5;
+  double cpu_tolerance = 0.25;
+};
+
+Settings g_settings;
+int g_bridge_pid = -1;
+
+//////////////////////////////////////////////////
+/// \brief Run a scenario, append its results to the CSV file and check them
+/// against the baseline.
+template<typename ROS1_T, typename IGN_T>
+void check_scenario(
+  const Scenario & scenario,
+  const std::string & ros1_type,
+  const std::string & ign_type)
+{
+  ASSERT_TRUE(set_bridges(scenario, ros1_type, ign_type, true))
+    << "Failed to add the bridges of [" << scenario.name << "]";
+  const Result result = run_scenario<ROS1_T, IGN_T>(scenario, g_bridge_pid);
+  set_bridges(scenario, ros1_type, ign_type, false);
+
+  std::ofstream csv(g_settings.results, std::ios::app);
+  csv << scenario.name << "," << result.throughput << "," << result.p50_ms
+      << "," << result.p99_ms << "," << result.cpu_us_per_msg << ","
+      << result.sent << "," << result.delivered << std::endl;
+
+  // Relative to what was actually sent, so that a slow load generator
+  // doesn't count against the bridge.
+  ASSERT_GT(result.sent, 0u) << "Nothing was sent";
+  EXPECT_GE(static_cast<double>(result.delivered) / result.sent,
+    scenario.min_delivered_ratio)
+    << result.delivered << " of " << result.sent << " messages delivered";
+  EXPECT_LE(result.p99_ms, scenario.max_p99_ms) << "p99 latency too high";
+
+  const auto baseline = load_baseline(g_settings.baseline);
+  auto it = baseline.find(scenario.name);
+  if (it == baseline.end())
+  {
+    std::cout << "No baseline for [" << scenario.name << "], not checked"
+              << std::endl;
+    return;
+  }
+  const Result & base = it->second;
+
+  EXPECT_GE(result.throughput,
+    base.throughput * (1.0 - g_settings.throughput_tolerance))
+    << "Throughput regression";
+
+  // Sub-millisecond latencies are mostly scheduling noise.
+  const double floor = g_settings.latency_floor_ms;
+  const double latency_factor = 1.0 + g_settings.latency_tolerance;
+  EXPECT_LE(std::max(result.p50_ms, floor),
+    std::max(base.p50_ms, floor) * latency_factor) << "p50 regression";
+  EXPECT_LE(std::max(result.p99_ms, floor),
+    std::max(base.p99_ms, floor) * latency_factor) << "p99 regression";
+
+  if (g_bridge_pid > 0 && base.cpu_us_per_msg > 0.0)
+  {
+    EXPECT_LE(result.cpu_us_per_msg,
+      base.cpu_us_per_msg * (1.0 + g_settings.cpu_tolerance))
+      << "CPU per message regression";
+  }
+}
+
+//////////////////////////////////////////////////
+LoadOptions make_load(
+  const std::string & prefix, size_t topics, double rate, size_t payload)
+{
+  LoadOptions load;
+  load.prefix = prefix;
+  load.topics = topics;
+  load.rate = rate;
+  load.payload = payload;
+  load.duration = 5.0;
+  load.verbose = false;
+  return load;
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////
+TEST(BridgePerfTest, SmallHighRate)
+{
+  Scenario scenario{"small_high_rate",
+    make_load("perf_small_", 1, 2000.0, 64), true, 0.99, 50.0};
+  check_scenario<std_msgs::String, ignition::msgs::StringMsg>(
+    scenario, "std_msgs/String", "ignition.msgs.StringMsg");
+}
+
+/////////////////////////////////////////////////
+TEST(BridgePerfTest, LargeImages)
+{
+  // 1080p RGB frames.
+  Scenario scenario{"large_images",
+    make_load("perf_image_", 1, 30.0, 1920 * 1080 * 3), false, 0.99, 250.0};
+  check_scenario<sensor_msgs::Image, ignition::msgs::Image>(
+    scenario, "sensor_msgs/Image", "ignition.msgs.Image");
+}
+
+/////////////////////////////////////////////////
+TEST(BridgePerfTest, ManyTopics)
+{
+  Scenario scenario{"many_topics",
+    make_load("perf_many_", 100, 50.0, 256), true, 0.99, 100.0};
+  check_scenario<std_msgs::String, ignition::msgs::StringMsg>(
+    scenario, "std_msgs/String", "ignition.msgs.StringMsg");
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "bridge_perf");
+
+  ros::NodeHandle private_node("~");
+  private_node.param("results", g_settings.results, g_settings.results);
+  private_node.param("baseline", g_settings.baseline, g_settings.baseline);
+  private_node.param("throughput_tolerance",
+    g_settings.throughput_tolerance, g_settings.throughput_tolerance);
+  private_node.param("latency_tolerance",
+    g_settings.latency_tolerance, g_settings.latency_tolerance);
+  private_node.param("latency_floor_ms",
+    g_settings.latency_floor_ms, g_settings.latency_floor_ms);
+  private_node.param("cpu_tolerance",
+    g_settings.cpu_tolerance, g_settings.cpu_tolerance);
+
+  ros::service::waitForService(std::string(kBridgeNode) + "/add_bridge",
+    ros::Duration(10.0));
+  g_bridge_pid = node_pid(kBridgeNode);
+  if (g_bridge_pid <= 0)
+    std::cerr << "Bridge process not found, CPU is not measured" << std::endl;
+
+  std::ofstream(g_settings.results) << kCsvHeader << std::endl;
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Creates growing numbers of bidirectional bridges in this process and
+// reports what each one costs: creation time, ROS master RPCs, threads,
+// file descriptors and resident memory. The master calls are counted by an
+// XML-RPC proxy that this process puts between itself and the master.
+//
+//   rosrun ros1_ign_bridge bridge_scale _counts:=1,10,100,1000,10000
+
+#include <dirent.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/transport/Node.hh>
+#include <ros/network.h>
+#include <ros/ros.h>
+#include <XmlRpcClient.h>
+#include <XmlRpcServer.h>
+#include <XmlRpcServerMethod.h>
+
+#include "ros1_ign_bridge/bridge.hpp"
+
+namespace
+{
+
+/// \brief Master API methods, forwarded as they are by the proxy.
+const char * const kMasterMethods[] =
+{
+  "registerService", "unregisterService", "registerSubscriber",
+  "unregisterSubscriber", "registerPublisher", "unregisterPublisher",
+  "lookupNode", "getPublishedTopics", "getTopicTypes", "getSystemState",
+  "getUri", "lookupService", "deleteParam", "setParam", "getParam",
+  "searchParam", "subscribeParam", "unsubscribeParam", "hasParam",
+  "getParamNames"
+};
+
+/// \brief XML-RPC server that forwards the master API to the real master
+/// and counts the calls.
+class MasterProxy
+{
+public:
+  MasterProxy(const std::string & host, int port)
+  : client_(host.c_str(), port, "/")
+  {
+    for (const char * name : kMasterMethods)
+      methods_.emplace_back(new Method(name, this));
+  }
+
+  ~MasterProxy()
+  {
+    running_ = false;
+    if (thread_.joinable())
+      thread_.join();
+    server_.shutdown();
+  }
+
+  /// \return The URI to use as ROS master, empty on failure.
+  std::string
+  start()
+  {
+    if (!server_.bindAndListen(0))
+      return "";
+    thread_ = std::thread([this]
+      {
+        while (running_)
+          server_.work(0.1);
+      });
+    return "http://localhost:" + std::to_string(server_.get_port()) + "/";
+  }
+
+  uint64_t
+  calls() const
+  {
+    return calls_.load();
+  }
+
+private:
+  class Method : public XmlRpc::XmlRpcServerMethod
+  {
+  public:
+    Method(const std::string & name, MasterProxy * proxy)
+    : XmlRpc::XmlRpcServerMethod(name, &proxy->server_),
+      proxy_(proxy)
+    {}
+
+    void
+    execute(XmlRpc::XmlRpcValue & params, XmlRpc::XmlRpcValue & result)
+      override
+    {
+      // Only the server thread gets here, the client needs no lock.
+      ++proxy_->calls_;
+      proxy_->client_.execute(_name.c_str(), params, result);
+    }
+
+  private:
+    MasterProxy * proxy_;
+  };
+
+  XmlRpc::XmlRpcServer server_;
+  XmlRpc::XmlRpcClient client_;
+  std::vector<std::unique_ptr<Method>> methods_;
+  std::atomic<uint64_t> calls_{0};
+  std::atomic<bool> running_{true};
+  std::thread thread_;
+};
+
+/// \brief Resources used by this process.
+struct Usage
+{
+  long threads = 0;
+  long fds = 0;
+  long rss_kib = 0;
+};
+
+//////////////////////////////////////////////////
+Usage current_usage()
+{
+  Usage usage;
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line))
+  {
+    std::istringstream fields(line);
+    std::string key;
+    fields >> key;
+    if (key == "Threads:")
+      fields >> usage.threads;
+    else if (key == "VmRSS:")
+      fields >> usage.rss_kib;
+  }
+
+  if (DIR * dir = opendir("/proc/self/fd"))
+  {
+    while (dirent * entry = readdir(dir))
+    {
+      if (entry->d_name[0] != '.')
+        ++usage.fds;
+    }
+    closedir(dir);
+  }
+  return usage;
+}
+
+//////////////////////////////////////////////////
+std::vector<size_t> parse_counts(const std::string & text)
+{
+  std::vector<size_t> counts;
+  std::istringstream items(text);
+  std::string item;
+  while (std::getline(items, item, ','))
+  {
+    if (!item.empty())
+      counts.push_back(std::stoul(item));
+  }
+  return counts;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+int main(int argc, char ** argv)
+{
+  // The master proxy must be known before ros::init(), which contacts the
+  // master given by __master:= or ROS_MASTER_URI.
+  std::string master_uri =
+    std::getenv("ROS_MASTER_URI") ? std::getenv("ROS_MASTER_URI") : "";
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg.compare(0, 10, "__master:=") == 0)
+      master_uri = arg.substr(10);
+  }
+  std::string master_host;
+  uint32_t master_port = 0;
+  if (!ros::network::splitURI(master_uri, master_host, master_port))
+  {
+    std::cerr << "Invalid ROS master URI [" << master_uri << "]" << std::endl;
+    return 1;
+  }
+
+  MasterProxy proxy(master_host, static_cast<int>(master_port));
+  const std::string proxy_uri = proxy.start();
+  if (proxy_uri.empty())
+  {
+    std::cerr << "Failed to start the master proxy" << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> args(argv, argv + argc);
+  args.push_back("__master:=" + proxy_uri);
+  std::vector<char *> new_argv;
+  for (auto & arg : args)
+    new_argv.push_back(&arg[0]);
+  int new_argc = static_cast<int>(new_argv.size());
+  ros::init(new_argc, new_argv.data(), "bridge_scale");
+
+  ros::NodeHandle private_node("~");
+  std::string counts_text, ros1_type, ign_type, prefix;
+  double settle = 1.0;
+  private_node.param<std::string>(
+    "counts", counts_text, "1,10,100,1000,10000");
+  private_node.param<std::string>("ros1_type", ros1_type, "std_msgs/String");
+  private_node.param<std::string>(
+    "ign_type", ign_type, "ignition.msgs.StringMsg");
+  private_node.param<std::string>("prefix", prefix, "/bridge_scale/topic_");
+  private_node.param("settle", settle, settle);
+
+  ros::NodeHandle ros1_node;
+  auto ign_node = std::make_shared<ignition::transport::Node>();
+
+  // The bridges subscribe to their own publishers, and these callbacks
+  // need to run like in a bridge node.
+  ros::AsyncSpinner spinner(1);
+  spinner.start();
+
+  std::printf("%8s %10s %10s %8s %8s %8s %8s %8s %10s %10s %10s\n",
+    "bridges", "create_s", "ms/bridge", "rpcs", "rpc/brg", "threads",
+    "fds", "fd/brg", "rss_mib", "kib/brg", "destroy_s");
+
+  using Clock = std::chrono::steady_clock;
+  for (size_t count : parse_counts(counts_text))
+  {
+    if (!ros::ok())
+      break;
+
+    const Usage before = current_usage();
+    const uint64_t calls_before = proxy.calls();
+
+    std::vector<ros1_ign_bridge::BridgeHandles> handles;
+    handles.reserve(count);
+    const auto create_start = Clock::now();
+    for (size_t i = 0; i < count; ++i)
+    {
+      handles.push_back(ros1_ign_bridge::create_bidirectional_bridge(
+        ros1_node, ign_node, ros1_type, ign_type,
+        prefix + std::to_string(i), 10));
+    }
+    const double create_s =
+      std::chrono::duration<double>(Clock::now() - create_start).count();
+    const uint64_t calls = proxy.calls() - calls_before;
+
+    // Threads and connections are partly created in the background.
+    std::this_thread::sleep_for(std::chrono::duration<double>(settle));
+    const Usage after = current_usage();
+
+    const auto destroy_start = Clock::now();
+    for (auto & bridge : handles)
+      ros1_ign_bridge::shutdown_bridge(bridge);
+    handles.clear();
+    const double destroy_s =
+      std::chrono::duration<double>(Clock::now() - destroy_start).count();
+
+    const double n = static_cast<double>(count > 0 ? count : 1);
+    std::printf(
+      "%8zu %10.3f %10.3f %8llu %8.2f %8ld %8ld %8.2f %10.1f %10.2f %10.3f\n",
+      count, create_s, create_s * 1e3 / n,
+      static_cast<unsigned long long>(calls), calls / n,
+      after.threads - before.threads, after.fds - before.fds,
+      (after.fds - before.fds) / n, after.rss_kib / 1024.0,
+      (after.rss_kib - before.rss_kib) / n, destroy_s);
+    std::fflush(stdout);
+
+    // Let the unregistrations and disconnections finish before the next
+    // size.
+    std::this_thread::sleep_for(std::chrono::duration<double>(settle));
+  }
+
+  spinner.stop();
+  ros::shutdown();
+  return 0;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Converter of a pair that has no builtin factory, loaded through pluginlib
+// by test/integration/converter_plugins.cpp.
+
+#include <pluginlib/class_list_macros.h>
+#include <std_msgs/UInt32.h>
+#include <ignition/msgs/uint32.pb.h>
+
+#include "ros1_ign_bridge/converter_plugin.hpp"
+
+namespace ros1_ign_bridge
+{
+
+template<>
+void
+Factory<std_msgs::UInt32, ignition::msgs::UInt32>::convert_1_to_ign(
+  const std_msgs::UInt32 & ros1_msg,
+  ignition::msgs::UInt32 & ign_msg)
+{
+  ign_msg.set_data(ros1_msg.data);
+}
+
+template<>
+void
+Factory<std_msgs::UInt32, ignition::msgs::UInt32>::convert_ign_to_1(
+  const ignition::msgs::UInt32 & ign_msg,
+  std_msgs::UInt32 & ros1_msg)
+{
+  ros1_msg.data = ign_msg.data();
+}
+
+}  // namespace ros1_ign_bridge
+
+namespace ros1_ign_bridge_test_plugins
+{
+
+using UInt32Converter = ros1_ign_bridge::FactoryPlugin<
+  std_msgs::UInt32, ignition::msgs::UInt32>;
+
+}  // namespace ros1_ign_bridge_test_plugins
+
+PLUGINLIB_EXPORT_CLASS(ros1_ign_bridge_test_plugins::UInt32Converter,
+                       ros1_ign_bridge::ConverterPlugin)
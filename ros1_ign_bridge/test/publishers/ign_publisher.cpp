@@ -21,8 +21,10 @@
 #include <iostream>
 #include <string>
 #include <thread>
+#include <vector>
 #include <ignition/msgs.hh>
 #include <ignition/transport.hh>
+#include "../load_generator.h"
 #include "../test_utils.h"
 
 /// \brief Flag used to break the publisher loop and terminate the program.
@@ -39,12 +41,77 @@ void signal_handler(int _signal)
 }
 
 //////////////////////////////////////////////////
-int main(int /*argc*/, char **/*argv*/)
+/// \brief Publish load on Ignition topics and measure what the bridge
+/// delivers on the ROS 1 topics of the same names.
+template<typename IGN_T, typename ROS1_T>
+int run_ign_load(
+  int argc, char ** argv, const ros1_ign_bridge::testing::LoadOptions & options)
+{
+  using ros1_ign_bridge::testing::LoadReport;
+
+  ros::init(argc, argv, "ign_load_generator",
+    ros::init_options::NoSigintHandler);
+  ros::NodeHandle n;
+  ignition::transport::Node node;
+  LoadReport report(options);
+
+  std::vector<ignition::transport::Node::Publisher> pubs;
+  std::vector<ros::Subscriber> subs;
+  for (size_t i = 0; i < options.topics; ++i)
+  {
+    const std::string topic = options.prefix + std::to_string(i);
+    pubs.push_back(node.Advertise<IGN_T>(topic));
+    boost::function<void(const boost::shared_ptr<ROS1_T const> &)> cb =
+      [&report, i](const boost::shared_ptr<ROS1_T const> & msg)
+      {
+        report.received(i, ros1_ign_bridge::testing::get_load_stamp(*msg));
+      };
+    subs.push_back(n.subscribe<ROS1_T>(topic, 1000, cb));
+  }
+
+  ros::AsyncSpinner spinner(1);
+  spinner.start();
+
+  IGN_T msg;
+  ros1_ign_bridge::testing::make_load_msg(options.payload, msg);
+  ros1_ign_bridge::testing::run_load(options, report,
+    [] { return g_terminatePub.load() || !ros::ok(); },
+    [&pubs, &msg](size_t topic)
+    {
+      ros1_ign_bridge::testing::set_load_stamp(
+        ros1_ign_bridge::testing::load_now_ns(), msg);
+      pubs[topic].Publish(msg);
+    });
+
+  spinner.stop();
+  ros::shutdown();
+  return 0;
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char ** argv)
 {
   // Install a signal handler for SIGINT and SIGTERM.
   std::signal(SIGINT,  signal_handler);
   std::signal(SIGTERM, signal_handler);
 
+  ros1_ign_bridge::testing::LoadOptions options;
+  bool load = false;
+  if (!ros1_ign_bridge::testing::parse_load_options(argc, argv, options, load))
+  {
+    ros1_ign_bridge::testing::load_usage(argv[0]);
+    return 1;
+  }
+  if (load && options.type == "image")
+    return run_ign_load<ignition::msgs::Image, sensor_msgs::Image>(
+      argc, argv, options);
+  if (load && options.type == "laserscan")
+    return run_ign_load<ignition::msgs::LaserScan, sensor_msgs::LaserScan>(
+      argc, argv, options);
+  if (load)
+    return run_ign_load<ignition::msgs::StringMsg, std_msgs::String>(
+      argc, argv, options);
+
   // Create a transport node and advertise a topic.
   ignition::transport::Node node;
 
@@ -146,6 +213,11 @@ int main(int /*argc*/, char **/*argv*/)
   ignition::msgs::Twist twist_msg;
   ros1_ign_bridge::testing::createTestMsg(twist_msg);
 
+  // ignition::msgs::Pose_V.
+  auto tf_pub = node.Advertise<ignition::msgs::Pose_V>("tf");
+  ignition::msgs::Pose_V tf_msg;
+  ros1_ign_bridge::testing::createTestMsg(tf_msg);
+
   // Publish messages at 1Hz.
   while (!g_terminatePub)
   {
@@ -168,6 +240,7 @@ int main(int /*argc*/, char **/*argv*/)
     actuators_pub.Publish(actuators_msg);
     joint_states_pub.Publish(joint_states_msg);
     twist_pub.Publish(twist_msg);
+    tf_pub.Publish(tf_msg);
 
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
   }
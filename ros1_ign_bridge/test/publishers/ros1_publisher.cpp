@@ -12,8 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <functional>
+#include <string>
 #include <thread>
+#include <vector>
 
+#include <ignition/transport/Node.hh>
 #include <ros/ros.h>
 #include <std_msgs/Float32.h>
 #include <std_msgs/Header.h>
@@ -33,12 +37,67 @@
 #include <sensor_msgs/JointState.h>
 #include <sensor_msgs/LaserScan.h>
 #include <sensor_msgs/MagneticField.h>
+#include <tf2_msgs/TFMessage.h>
+#include "../load_generator.h"
 #include "../test_utils.h"
 
+//////////////////////////////////////////////////
+/// \brief Publish load on ROS 1 topics and measure what the bridge delivers
+/// on the Ignition topics of the same names.
+template<typename ROS1_T, typename IGN_T>
+int run_ros1_load(const ros1_ign_bridge::testing::LoadOptions & options)
+{
+  using ros1_ign_bridge::testing::LoadReport;
+
+  ros::NodeHandle n;
+  ignition::transport::Node node;
+  LoadReport report(options);
+
+  std::vector<ros::Publisher> pubs;
+  for (size_t i = 0; i < options.topics; ++i)
+  {
+    const std::string topic = options.prefix + std::to_string(i);
+    pubs.push_back(n.advertise<ROS1_T>(topic, 1000));
+    std::function<void(const IGN_T &)> cb = [&report, i](const IGN_T & msg)
+      {
+        report.received(i, ros1_ign_bridge::testing::get_load_stamp(msg));
+      };
+    node.Subscribe(topic, cb);
+  }
+
+  ROS1_T msg;
+  ros1_ign_bridge::testing::make_load_msg(options.payload, msg);
+  ros1_ign_bridge::testing::run_load(options, report,
+    [] { return !ros::ok(); },
+    [&pubs, &msg](size_t topic)
+    {
+      ros1_ign_bridge::testing::set_load_stamp(
+        ros1_ign_bridge::testing::load_now_ns(), msg);
+      pubs[topic].publish(msg);
+    });
+  return 0;
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char ** argv)
 {
   ros::init(argc, argv, "ros1_string_publisher");
+
+  ros1_ign_bridge::testing::LoadOptions options;
+  bool load = false;
+  if (!ros1_ign_bridge::testing::parse_load_options(argc, argv, options, load))
+  {
+    ros1_ign_bridge::testing::load_usage(argv[0]);
+    return 1;
+  }
+  if (load && options.type == "image")
+    return run_ros1_load<sensor_msgs::Image, ignition::msgs::Image>(options);
+  if (load && options.type == "laserscan")
+    return run_ros1_load<sensor_msgs::LaserScan, ignition::msgs::LaserScan>(
+      options);
+  if (load)
+    return run_ros1_load<std_msgs::String, ignition::msgs::StringMsg>(options);
+
   ros::NodeHandle n;
   ros::Rate loop_rate(1);
 
@@ -153,6 +212,12 @@ int main(int argc, char ** argv)
   sensor_msgs::MagneticField magnetic_msg;
   ros1_ign_bridge::testing::createTestMsg(magnetic_msg);
 
+  // tf2_msgs::TFMessage.
+  ros::Publisher tf_pub =
+    n.advertise<tf2_msgs::TFMessage>("tf", 1000);
+  tf2_msgs::TFMessage tf_msg;
+  ros1_ign_bridge::testing::createTestMsg(tf_msg);
+
   while (ros::ok())
   {
     // Publish all messages.
@@ -175,6 +240,7 @@ int main(int argc, char ** argv)
     laserscan_pub.publish(laserscan_msg);
     magnetic_pub.publish(magnetic_msg);
     joint_states_pub.publish(joint_states_msg);
+    tf_pub.publish(tf_msg);
 
     ros::spinOnce();
     loop_rate.sleep();
@@ -275,6 +275,18 @@ TEST(IgnSubscriberTest, JointStates)
   EXPECT_TRUE(client.callbackExecuted);
 }
 
+/////////////////////////////////////////////////
+TEST(IgnSubscriberTest, PoseV)
+{
+  MyTestClass<ignition::msgs::Pose_V> client("tf");
+
+  using namespace std::chrono_literals;
+  ros1_ign_bridge::testing::waitUntilBoolVar(
+    client.callbackExecuted, 10ms, 200);
+
+  EXPECT_TRUE(client.callbackExecuted);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -36,6 +36,7 @@
 #include <sensor_msgs/JointState.h>
 #include <sensor_msgs/LaserScan.h>
 #include <sensor_msgs/MagneticField.h>
+#include <tf2_msgs/TFMessage.h>
 #include <chrono>
 #include "../test_utils.h"
 
@@ -295,6 +296,18 @@ TEST(ROS1SubscriberTest, Actuators)
   EXPECT_TRUE(client.callbackExecuted);
 }
 
+/////////////////////////////////////////////////
+TEST(ROS1SubscriberTest, TFMessage)
+{
+  MyTestClass<tf2_msgs::TFMessage> client("tf");
+
+  using namespace std::chrono_literals;
+  ros1_ign_bridge::testing::waitUntilBoolVarAndSpin(
+    client.callbackExecuted, 10ms, 200);
+
+  EXPECT_TRUE(client.callbackExecuted);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
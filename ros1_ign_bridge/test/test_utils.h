@@ -39,6 +39,7 @@
 #include <sensor_msgs/JointState.h>
 #include <sensor_msgs/LaserScan.h>
 #include <sensor_msgs/MagneticField.h>
+#include <tf2_msgs/TFMessage.h>
 #include <chrono>
 #include <string>
 #include <thread>
@@ -629,6 +630,24 @@ namespace testing
       EXPECT_FLOAT_EQ(0, _msg.magnetic_field_covariance[i]);
   }
 
+  /// \brief Create a message used for testing.
+  /// \param[out] _msg The message populated.
+  void createTestMsg(tf2_msgs::TFMessage &_msg)
+  {
+    _msg.transforms.resize(2);
+    for (auto &transform : _msg.transforms)
+      createTestMsg(transform);
+  }
+
+  /// \brief Compare a message with the populated for testing.
+  /// \param[in] _msg The message to compare.
+  void compareTestMsg(const tf2_msgs::TFMessage &_msg)
+  {
+    ASSERT_EQ(2u, _msg.transforms.size());
+    for (const auto &transform : _msg.transforms)
+      compareTestMsg(transform);
+  }
+
   //////////////////////////////////////////////////
   /// Ignition::msgs test utils
   //////////////////////////////////////////////////
@@ -1174,6 +1193,24 @@ namespace testing
     compareTestMsg(_msg.linear());
     compareTestMsg(_msg.angular());
   }
+
+  /// \brief Create a message used for testing.
+  /// \param[out] _msg The message populated.
+  void createTestMsg(ignition::msgs::Pose_V &_msg)
+  {
+    createTestMsg(*_msg.mutable_header());
+    for (auto i = 0; i < 2; ++i)
+      createTestMsg(*_msg.add_pose());
+  }
+
+  /// \brief Compare a message with the populated for testing.
+  /// \param[in] _msg The message to compare.
+  void compareTestMsg(const ignition::msgs::Pose_V &_msg)
+  {
+    ASSERT_EQ(2, _msg.pose_size());
+    for (const auto &pose : _msg.pose())
+      compareTestMsg(pose);
+  }
 }
 }
 
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ros1_ign_bridge/bridge_config.hpp"
+
+using ros1_ign_bridge::BridgeConfig;
+using ros1_ign_bridge::BridgeDirection;
+using ros1_ign_bridge::BridgeSetConfig;
+
+namespace
+{
+
+//////////////////////////////////////////////////
+XmlRpc::XmlRpcValue bridge_entry(
+  const std::string & topic,
+  const std::string & ros_type = "std_msgs/String",
+  const std::string & ign_type = "ignition.msgs.StringMsg")
+{
+  XmlRpc::XmlRpcValue entry;
+  entry["topic"] = topic;
+  entry["ros_type"] = ros_type;
+  entry["ign_type"] = ign_type;
+  return entry;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+TEST(BridgeConfigTest, Spec)
+{
+  BridgeConfig config;
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_spec(
+    "/chatter@std_msgs/String@ignition.msgs.StringMsg", config));
+  EXPECT_EQ("/chatter", config.ros1_topic_name);
+  EXPECT_EQ("/chatter", config.ign_topic_name);
+  EXPECT_EQ("std_msgs/String", config.ros1_type_name);
+  EXPECT_EQ("ignition.msgs.StringMsg", config.ign_type_name);
+  EXPECT_EQ(BridgeDirection::BIDIRECTIONAL, config.direction);
+
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_spec(
+    "/scan@sensor_msgs/LaserScan[ignition.msgs.LaserScan", config));
+  EXPECT_EQ(BridgeDirection::IGN_TO_ROS, config.direction);
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_spec(
+    "/cmd_vel@geometry_msgs/Twist]ignition.msgs.Twist", config));
+  EXPECT_EQ(BridgeDirection::ROS_TO_IGN, config.direction);
+  EXPECT_EQ("/cmd_vel@geometry_msgs/Twist]ignition.msgs.Twist",
+            ros1_ign_bridge::to_bridge_spec(config));
+
+  EXPECT_FALSE(ros1_ign_bridge::parse_bridge_spec("/chatter", config));
+  EXPECT_FALSE(ros1_ign_bridge::parse_bridge_spec(
+    "@std_msgs/String@ignition.msgs.StringMsg", config));
+  EXPECT_FALSE(ros1_ign_bridge::parse_bridge_spec(
+    "/chatter@std_msgs/String@", config));
+  EXPECT_FALSE(ros1_ign_bridge::parse_bridge_spec(
+    "/chatter@std_msgs/String@ignition.msgs.StringMsg@x", config));
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeConfigTest, Parse)
+{
+  XmlRpc::XmlRpcValue value;
+  value["executors"][0]["name"] = "control";
+  value["executors"][0]["threads"] = 2;
+  value["bridges"][0] = bridge_entry("/cmd_vel", "geometry_msgs/Twist",
+    "ignition.msgs.Twist");
+  value["bridges"][0]["direction"] = "ros_to_ign";
+  value["bridges"][0]["queue_size"] = 1;
+  value["bridges"][0]["executor"] = "control";
+  value["bridges"][1] = bridge_entry("");
+  value["bridges"][1]["ros_topic"] = "/ros_chatter";
+  value["bridges"][1]["ign_topic"] = "/ign_chatter";
+  value["bridges"][1]["publisher_queue_size"] = 100;
+  value["bridges"][1]["max_rate"] = 2.5;
+  value["bridges"][1]["lazy"] = true;
+
+  BridgeSetConfig config;
+  std::vector<std::string> errors;
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_config(value, config, errors));
+  EXPECT_TRUE(errors.empty());
+
+  ASSERT_EQ(1u, config.executors.size());
+  EXPECT_EQ("control", config.executors[0].name);
+  EXPECT_EQ(2u, config.executors[0].threads);
+
+  ASSERT_EQ(2u, config.bridges.size());
+  EXPECT_EQ(BridgeDirection::ROS_TO_IGN, config.bridges[0].direction);
+  EXPECT_EQ(1u, config.bridges[0].subscriber_queue_size);
+  EXPECT_EQ(1u, config.bridges[0].publisher_queue_size);
+  EXPECT_EQ("control", config.bridges[0].executor);
+
+  EXPECT_EQ("/ros_chatter", config.bridges[1].ros1_topic_name);
+  EXPECT_EQ("/ign_chatter", config.bridges[1].ign_topic_name);
+  EXPECT_EQ(10u, config.bridges[1].subscriber_queue_size);
+  EXPECT_EQ(100u, config.bridges[1].publisher_queue_size);
+  EXPECT_DOUBLE_EQ(2.5, config.bridges[1].max_rate);
+  EXPECT_TRUE(config.bridges[1].lazy);
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeConfigTest, ParseErrors)
+{
+  // Every invalid entry is reported, the valid ones are kept.
+  XmlRpc::XmlRpcValue value;
+  value["bridges"][0] = bridge_entry("/ok");
+  value["bridges"][1] = bridge_entry("/bad_direction");
+  value["bridges"][1]["direction"] = "sideways";
+  value["bridges"][2] = bridge_entry("/bad_queue");
+  value["bridges"][2]["queue_size"] = -1;
+  value["bridges"][3] = bridge_entry("");
+  value["bridges"][4]["topic"] = "/no_ros_type";
+  value["bridges"][4]["ign_type"] = "ignition.msgs.StringMsg";
+  value["bridges"][5] = bridge_entry("/no_ign_type", "std_msgs/String", "");
+  value["executors"][0]["threads"] = 1;
+
+  BridgeSetConfig config;
+  std::vector<std::string> errors;
+  EXPECT_FALSE(ros1_ign_bridge::parse_bridge_config(value, config, errors));
+  EXPECT_EQ(6u, errors.size());
+  ASSERT_EQ(1u, config.bridges.size());
+  EXPECT_EQ("/ok", config.bridges[0].ros1_topic_name);
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeConfigTest, Validate)
+{
+  BridgeSetConfig config;
+  BridgeConfig bridge;
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_spec(
+    "/chatter@std_msgs/String@ignition.msgs.StringMsg", bridge));
+  config.bridges.push_back(bridge);
+
+  std::vector<std::string> errors;
+  EXPECT_TRUE(ros1_ign_bridge::validate_bridge_config(config, errors));
+  EXPECT_TRUE(errors.empty());
+
+  // Same topic in the same direction, unknown executor and no conversion.
+  config.bridges.push_back(bridge);
+  bridge.ros1_topic_name = bridge.ign_topic_name = "/other";
+  bridge.executor = "missing";
+  config.bridges.push_back(bridge);
+  bridge.executor.clear();
+  bridge.ros1_topic_name = bridge.ign_topic_name = "/third";
+  bridge.ign_type_name = "ignition.msgs.Twist";
+  config.bridges.push_back(bridge);
+
+  EXPECT_FALSE(ros1_ign_bridge::validate_bridge_config(config, errors));
+  EXPECT_EQ(5u, errors.size());
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeConfigTest, Scheduling)
+{
+  XmlRpc::XmlRpcValue value;
+  value["executors"][0]["name"] = "control";
+  value["executors"][0]["priority"] = 50;
+  value["executors"][0]["cpus"][0] = 2;
+  value["executors"][0]["cpus"][1] = 3;
+  value["executors"][1]["name"] = "default";
+  value["clock"]["ign_topic"] = "/world/default/clock";
+  value["clock"]["ros_topic"] = "/clock";
+  value["clock"]["priority"] = 60;
+  value["clock"]["cpus"][0] = 1;
+
+  BridgeSetConfig config;
+  std::vector<std::string> errors;
+  ASSERT_TRUE(ros1_ign_bridge::parse_bridge_config(value, config, errors));
+  ASSERT_EQ(2u, config.executors.size());
+  EXPECT_EQ(50, config.executors[0].priority);
+  EXPECT_EQ(std::vector<int>({2, 3}), config.executors[0].cpus);
+  EXPECT_EQ(0, config.executors[1].priority);
+  EXPECT_TRUE(config.executors[1].cpus.empty());
+  EXPECT_TRUE(config.clock.enabled);
+  EXPECT_EQ(60, config.clock.priority);
+  EXPECT_EQ(std::vector<int>({1}), config.clock.cpus);
+
+  // Out of range priorities and empty or invalid CPU lists.
+  XmlRpc::XmlRpcValue invalid;
+  invalid["executors"][0]["name"] = "high";
+  invalid["executors"][0]["priority"] = 100;
+  invalid["executors"][1]["name"] = "negative";
+  invalid["executors"][1]["priority"] = -1;
+  invalid["executors"][2]["name"] = "empty";
+  invalid["executors"][2]["cpus"].setSize(0);
+  invalid["executors"][3]["name"] = "named";
+  invalid["executors"][3]["cpus"][0] = "first";
+  invalid["executors"][4]["name"] = "negative_cpu";
+  invalid["executors"][4]["cpus"][0] = -2;
+
+  config = BridgeSetConfig();
+  errors.clear();
+  EXPECT_FALSE(ros1_ign_bridge::parse_bridge_config(invalid, config, errors));
+  EXPECT_EQ(5u, errors.size());
+  EXPECT_TRUE(config.executors.empty());
+}
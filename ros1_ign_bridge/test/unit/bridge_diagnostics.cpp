@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <diagnostic_msgs/DiagnosticStatus.h>
+
+#include "ros1_ign_bridge/bridge_diagnostics.hpp"
+
+using diagnostic_msgs::DiagnosticStatus;
+using ros1_ign_bridge::BridgeConfig;
+using ros1_ign_bridge::BridgeDirection;
+using ros1_ign_bridge::TopicStatistics;
+
+namespace
+{
+
+//////////////////////////////////////////////////
+unsigned char level(
+  const BridgeConfig & config,
+  const TopicStatistics & stats,
+  double rate)
+{
+  diagnostic_updater::DiagnosticStatusWrapper status;
+  ros1_ign_bridge::check_bridge_health(config, stats, rate, status);
+  return status.level;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+TEST(BridgeDiagnosticsTest, Rate)
+{
+  BridgeConfig config;
+  config.ros1_topic_name = config.ign_topic_name = "/scan";
+  config.direction = BridgeDirection::IGN_TO_ROS;
+  config.expected_rate = 10.0;
+  config.rate_tolerance = 0.1;
+
+  TopicStatistics stats;
+  stats.direction = "ign_to_ros";
+  EXPECT_EQ(DiagnosticStatus::OK, level(config, stats, 10.5));
+  EXPECT_EQ(DiagnosticStatus::WARN, level(config, stats, 8.0));
+  EXPECT_EQ(DiagnosticStatus::WARN, level(config, stats, 12.0));
+  EXPECT_EQ(DiagnosticStatus::ERROR, level(config, stats, 0.0));
+
+  config.lazy = true;
+  EXPECT_EQ(DiagnosticStatus::OK, level(config, stats, 0.0));
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeDiagnosticsTest, BidirectionalIdleDirection)
+{
+  // Traffic flows from Ignition only: the ROS 1 to Ignition direction
+  // forwards nothing, but the bridge as a whole is at the expected rate.
+  BridgeConfig config;
+  config.ros1_topic_name = config.ign_topic_name = "/chatter";
+  config.direction = BridgeDirection::BIDIRECTIONAL;
+  config.expected_rate = 10.0;
+
+  TopicStatistics idle;
+  idle.direction = "ros_to_ign";
+  idle.rate_out = 0.0;
+  TopicStatistics busy;
+  busy.direction = "ign_to_ros";
+  busy.rate_out = 10.0;
+  const double rate = idle.rate_out + busy.rate_out;
+
+  EXPECT_EQ(DiagnosticStatus::OK, level(config, idle, rate));
+  EXPECT_EQ(DiagnosticStatus::OK, level(config, busy, rate));
+
+  // Nothing in either direction is still an error.
+  busy.rate_out = 0.0;
+  EXPECT_EQ(DiagnosticStatus::ERROR, level(config, idle, 0.0));
+  EXPECT_EQ(DiagnosticStatus::ERROR, level(config, busy, 0.0));
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeDiagnosticsTest, Latency)
+{
+  BridgeConfig config;
+  config.max_age = 0.1;
+
+  TopicStatistics stats;
+  stats.latency_p99 = 0.05;
+  stats.latency_max = 0.08;
+  EXPECT_EQ(DiagnosticStatus::OK, level(config, stats, 0.0));
+  stats.latency_max = 0.2;
+  EXPECT_EQ(DiagnosticStatus::WARN, level(config, stats, 0.0));
+  stats.latency_p99 = 0.15;
+  EXPECT_EQ(DiagnosticStatus::ERROR, level(config, stats, 0.0));
+}
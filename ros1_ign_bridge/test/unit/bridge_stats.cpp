@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ros1_ign_bridge/bridge_stats.hpp"
+
+using ros1_ign_bridge::BridgeStats;
+using ros1_ign_bridge::BridgeStatsSnapshot;
+using ros1_ign_bridge::LatencyHistogram;
+
+//////////////////////////////////////////////////
+TEST(LatencyHistogramTest, Percentiles)
+{
+  LatencyHistogram histogram;
+  for (int64_t i = 1; i <= 1000; ++i)
+    histogram.record(i * 1000);
+
+  LatencyHistogram::Counts counts;
+  EXPECT_EQ(1000000u, histogram.take(counts));
+
+  // Within the precision of the buckets, 1 / kSubBuckets.
+  const double precision = 1.0 / LatencyHistogram::kSubBuckets;
+  EXPECT_NEAR(500000.0, LatencyHistogram::percentile(counts, 0.5),
+    500000.0 * precision);
+  EXPECT_NEAR(990000.0, LatencyHistogram::percentile(counts, 0.99),
+    990000.0 * precision);
+  EXPECT_GE(LatencyHistogram::percentile(counts, 1.0), 1000000u);
+
+  // Taking the samples starts over.
+  EXPECT_EQ(0u, histogram.take(counts));
+  EXPECT_EQ(0u, LatencyHistogram::percentile(counts, 0.5));
+}
+
+//////////////////////////////////////////////////
+TEST(LatencyHistogramTest, Range)
+{
+  LatencyHistogram histogram;
+  histogram.record(-5);
+  histogram.record(0);
+  histogram.record(3);
+  LatencyHistogram::Counts counts;
+  histogram.take(counts);
+  EXPECT_EQ(2u, counts[0]);
+  EXPECT_EQ(1u, counts[3]);
+
+  // Values past the range land in the last bucket.
+  histogram.record(INT64_MAX);
+  EXPECT_EQ(static_cast<uint64_t>(INT64_MAX), histogram.take(counts));
+  EXPECT_EQ(1u, counts[LatencyHistogram::kNumBuckets - 1]);
+
+  // Every bucket starts past the previous one.
+  for (int i = 1; i < LatencyHistogram::kNumBuckets; ++i)
+  {
+    EXPECT_LT(LatencyHistogram::bucket_lower_bound(i - 1),
+              LatencyHistogram::bucket_lower_bound(i));
+  }
+}
+
+//////////////////////////////////////////////////
+TEST(LatencyHistogramTest, LazyAllocation)
+{
+  LatencyHistogram histogram;
+  EXPECT_FALSE(histogram.allocated());
+  EXPECT_LE(sizeof(histogram), 2 * sizeof(uint64_t));
+
+  LatencyHistogram::Counts counts;
+  counts.fill(7);
+  EXPECT_EQ(0u, histogram.take(counts));
+  EXPECT_FALSE(histogram.allocated());
+  for (const auto count : counts)
+    EXPECT_EQ(0u, count);
+
+  // Concurrent first samples share the same buckets.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&histogram]
+      {
+        for (int j = 0; j < 1000; ++j)
+          histogram.record(100);
+      });
+  }
+  for (auto & thread : threads)
+    thread.join();
+  EXPECT_TRUE(histogram.allocated());
+  histogram.take(counts);
+  uint64_t total = 0;
+  for (const auto count : counts)
+    total += count;
+  EXPECT_EQ(4000u, total);
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeStatsTest, SampledSizes)
+{
+  BridgeStats stats;
+  const uint64_t interval = BridgeStats::kSizeSampleInterval;
+  for (uint64_t i = 0; i < 10 * interval; ++i)
+  {
+    stats.record_forwarded(ros1_ign_bridge::steady_now_ns());
+    if (stats.sample_sizes())
+      stats.record_sizes(100, 50);
+  }
+
+  // Every message is counted, the sizes of one in kSizeSampleInterval are
+  // measured and extrapolated.
+  const BridgeStatsSnapshot snapshot = stats.snapshot();
+  EXPECT_EQ(10 * interval, snapshot.messages_out);
+  EXPECT_EQ(10 * interval * 100, snapshot.bytes_in);
+  EXPECT_EQ(10 * interval * 50, snapshot.bytes_out);
+
+  // The first message of a bridge is always measured.
+  BridgeStats other;
+  EXPECT_TRUE(other.sample_sizes());
+  EXPECT_FALSE(other.sample_sizes());
+  EXPECT_FALSE(other.latency.allocated());
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <signal.h>
+
+#include <cerrno>
+#include <chrono>
+#include <functional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ros1_ign_bridge/bridge_config.hpp"
+#include "ros1_ign_bridge/bridge_supervisor.hpp"
+
+using ros1_ign_bridge::BridgeConfig;
+using ros1_ign_bridge::BridgeDirection;
+using ros1_ign_bridge::BridgeSupervisor;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+//////////////////////////////////////////////////
+BridgeConfig bridge(
+  const std::string & ros1_type, BridgeDirection direction)
+{
+  BridgeConfig config;
+  config.ros1_type_name = ros1_type;
+  config.direction = direction;
+  return config;
+}
+
+//////////////////////////////////////////////////
+/// \brief Condition of BridgeSupervisor::run() that holds for a while.
+std::function<bool()> run_for(std::chrono::milliseconds duration)
+{
+  const auto deadline = Clock::now() + duration;
+  return [deadline] { return Clock::now() < deadline; };
+}
+
+//////////////////////////////////////////////////
+bool exists(pid_t pid)
+{
+  return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+TEST(BridgeSupervisorTest, ProcessClass)
+{
+  EXPECT_EQ("sensors", ros1_ign_bridge::process_class(
+    bridge("sensor_msgs/Image", BridgeDirection::IGN_TO_ROS)));
+  EXPECT_EQ("sensors", ros1_ign_bridge::process_class(
+    bridge("sensor_msgs/CompressedImage", BridgeDirection::BIDIRECTIONAL)));
+  EXPECT_EQ("sensors", ros1_ign_bridge::process_class(
+    bridge("sensor_msgs/PointCloud2", BridgeDirection::IGN_TO_ROS)));
+  EXPECT_EQ("sensors", ros1_ign_bridge::process_class(
+    bridge("sensor_msgs/LaserScan", BridgeDirection::ROS_TO_IGN)));
+
+  EXPECT_EQ("control", ros1_ign_bridge::process_class(
+    bridge("geometry_msgs/Twist", BridgeDirection::ROS_TO_IGN)));
+  EXPECT_EQ("state", ros1_ign_bridge::process_class(
+    bridge("geometry_msgs/Twist", BridgeDirection::BIDIRECTIONAL)));
+  EXPECT_EQ("state", ros1_ign_bridge::process_class(
+    bridge("nav_msgs/Odometry", BridgeDirection::IGN_TO_ROS)));
+
+  // The process key wins over the type and the direction.
+  BridgeConfig config =
+    bridge("sensor_msgs/Image", BridgeDirection::IGN_TO_ROS);
+  config.process = "cameras";
+  EXPECT_EQ("cameras", ros1_ign_bridge::process_class(config));
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeSupervisorTest, RestartWithBackoff)
+{
+  BridgeSupervisor supervisor("/bin/false");
+  supervisor.add_worker("failing", {});
+
+  // It fails right away, then after 1 s, then is due 2 s later: the delay
+  // doubles rather than restarting it every iteration.
+  supervisor.run(run_for(std::chrono::milliseconds(2500)));
+  EXPECT_GE(supervisor.restarts("failing"), 2u);
+  EXPECT_LE(supervisor.restarts("failing"), 3u);
+  EXPECT_EQ(-1, supervisor.pid("failing"));
+
+  EXPECT_EQ(0u, supervisor.restarts("unknown"));
+  EXPECT_EQ(-1, supervisor.pid("unknown"));
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeSupervisorTest, MissingExecutable)
+{
+  // The child fails to execute the program and is restarted like a worker
+  // that exits.
+  BridgeSupervisor supervisor("/nonexistent/bridge");
+  supervisor.add_worker("missing", {});
+  supervisor.run(run_for(std::chrono::milliseconds(500)));
+  EXPECT_EQ(1u, supervisor.restarts("missing"));
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeSupervisorTest, Stop)
+{
+  BridgeSupervisor supervisor("/bin/sleep");
+  supervisor.add_worker("sleeper", {"60"});
+
+  pid_t pid = -1;
+  const auto deadline = Clock::now() + std::chrono::milliseconds(500);
+  supervisor.run([&supervisor, &pid, deadline]
+    {
+      if (pid <= 0)
+        pid = supervisor.pid("sleeper");
+      return Clock::now() < deadline;
+    });
+
+  // SIGINT ends the worker as soon as run() returns.
+  ASSERT_GT(pid, 0);
+  EXPECT_FALSE(exists(pid));
+  EXPECT_EQ(-1, supervisor.pid("sleeper"));
+  EXPECT_EQ(0u, supervisor.restarts("sleeper"));
+  EXPECT_LT(Clock::now() - deadline, std::chrono::seconds(2));
+}
+
+//////////////////////////////////////////////////
+TEST(BridgeSupervisorTest, KillIgnoringWorker)
+{
+  // A worker that ignores SIGINT is killed after the stop timeout.
+  BridgeSupervisor supervisor("/bin/sh");
+  supervisor.add_worker("stubborn", {"-c", "trap '' INT; exec sleep 60"});
+
+  pid_t pid = -1;
+  const auto deadline = Clock::now() + std::chrono::milliseconds(500);
+  supervisor.run([&supervisor, &pid, deadline]
+    {
+      if (pid <= 0)
+        pid = supervisor.pid("stubborn");
+      return Clock::now() < deadline;
+    });
+
+  ASSERT_GT(pid, 0);
+  EXPECT_FALSE(exists(pid));
+  EXPECT_GE(Clock::now() - deadline, std::chrono::seconds(4));
+}
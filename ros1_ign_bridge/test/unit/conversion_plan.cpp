@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <geometry_msgs/PoseStamped.h>
+#include <ros/serialization.h>
+#include <sensor_msgs/CameraInfo.h>
+#include <sensor_msgs/PointCloud2.h>
+#include <std_msgs/Header.h>
+#include <ignition/msgs.hh>
+
+#include "ros1_ign_bridge/conversion_plan.hpp"
+
+using ros1_ign_bridge::ConversionPlan;
+using ros1_ign_bridge::RosMessageSpecs;
+
+namespace
+{
+
+//////////////////////////////////////////////////
+template<typename T>
+std::vector<uint8_t> serialize(const T & msg)
+{
+  std::vector<uint8_t> data(ros::serialization::serializationLength(msg));
+  ros::serialization::OStream stream(data.data(), data.size());
+  ros::serialization::serialize(stream, msg);
+  return data;
+}
+
+//////////////////////////////////////////////////
+template<typename T>
+T deserialize(std::vector<uint8_t> & data)
+{
+  T msg;
+  ros::serialization::IStream stream(data.data(), data.size());
+  ros::serialization::deserialize(stream, msg);
+  return msg;
+}
+
+//////////////////////////////////////////////////
+std::unique_ptr<ConversionPlan> make_plan(
+  const std::string & ros1_type,
+  const google::protobuf::Descriptor * descriptor,
+  const std::map<std::string, std::string> & mappings = {})
+{
+  RosMessageSpecs specs;
+  std::string definition;
+  ros1_ign_bridge::load_ros_message_specs(ros1_type, specs, definition);
+  return std::unique_ptr<ConversionPlan>(
+    new ConversionPlan(ros1_type, specs, descriptor, mappings));
+}
+
+//////////////////////////////////////////////////
+/// \brief First value of an entry of the map of an Ignition header.
+std::string header_value(
+  const ignition::msgs::Header & header, const std::string & key)
+{
+  for (const auto & entry : header.data())
+  {
+    if (entry.key() == key && entry.value_size() > 0)
+      return entry.value(0);
+  }
+  return "<missing>";
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+TEST(ConversionPlanTest, Header)
+{
+  auto plan = make_plan("std_msgs/Header",
+    ignition::msgs::Header::descriptor());
+
+  std_msgs::Header ros1_msg;
+  ros1_msg.seq = 7;
+  ros1_msg.stamp.sec = 3;
+  ros1_msg.stamp.nsec = 4;
+  ros1_msg.frame_id = "base_link";
+  auto data = serialize(ros1_msg);
+
+  // The fields without a counterpart go into the map, like the builtin
+  // converter does.
+  ignition::msgs::Header ign_msg;
+  plan->ros1_to_ign(data.data(), data.size(), ign_msg);
+  EXPECT_EQ(3, ign_msg.stamp().sec());
+  EXPECT_EQ(4, ign_msg.stamp().nsec());
+  EXPECT_EQ("7", header_value(ign_msg, "seq"));
+  EXPECT_EQ("base_link", header_value(ign_msg, "frame_id"));
+
+  plan->ign_to_ros1(ign_msg, data);
+  const auto back = deserialize<std_msgs::Header>(data);
+  EXPECT_EQ(7u, back.seq);
+  EXPECT_EQ(ros1_msg.stamp, back.stamp);
+  EXPECT_EQ("base_link", back.frame_id);
+
+  // Missing entries are zero or empty, whatever the order of the others.
+  ignition::msgs::Header partial;
+  auto * entry = partial.add_data();
+  entry->set_key("other");
+  entry->add_value("x");
+  entry = partial.add_data();
+  entry->set_key("frame_id");
+  entry->add_value("map");
+  plan->ign_to_ros1(partial, data);
+  const auto converted = deserialize<std_msgs::Header>(data);
+  EXPECT_EQ(0u, converted.seq);
+  EXPECT_EQ("map", converted.frame_id);
+}
+
+//////////////////////////////////////////////////
+TEST(ConversionPlanTest, NestedMessages)
+{
+  // geometry_msgs/PoseStamped nests its pose one level deeper than
+  // ignition.msgs.Pose.
+  auto plan = make_plan("geometry_msgs/PoseStamped",
+    ignition::msgs::Pose::descriptor(),
+    {{"pose.position", "position"}, {"pose.orientation", "orientation"}});
+
+  geometry_msgs::PoseStamped ros1_msg;
+  ros1_msg.header.frame_id = "odom";
+  ros1_msg.header.stamp.sec = 10;
+  ros1_msg.pose.position.x = 1.0;
+  ros1_msg.pose.position.y = 2.0;
+  ros1_msg.pose.position.z = 3.0;
+  ros1_msg.pose.orientation.x = 0.5;
+  ros1_msg.pose.orientation.y = -0.5;
+  ros1_msg.pose.orientation.z = 0.5;
+  ros1_msg.pose.orientation.w = -0.5;
+  auto data = serialize(ros1_msg);
+
+  ignition::msgs::Pose ign_msg;
+  plan->ros1_to_ign(data.data(), data.size(), ign_msg);
+  EXPECT_EQ("odom", header_value(ign_msg.header(), "frame_id"));
+  EXPECT_EQ(10, ign_msg.header().stamp().sec());
+  EXPECT_DOUBLE_EQ(1.0, ign_msg.position().x());
+  EXPECT_DOUBLE_EQ(2.0, ign_msg.position().y());
+  EXPECT_DOUBLE_EQ(3.0, ign_msg.position().z());
+  EXPECT_DOUBLE_EQ(0.5, ign_msg.orientation().x());
+  EXPECT_DOUBLE_EQ(-0.5, ign_msg.orientation().w());
+
+  plan->ign_to_ros1(ign_msg, data);
+  const auto back = deserialize<geometry_msgs::PoseStamped>(data);
+  EXPECT_EQ(ros1_msg, back);
+
+  // A truncated message is refused.
+  data.resize(data.size() - 1);
+  EXPECT_THROW(plan->ros1_to_ign(data.data(), data.size(), ign_msg),
+               std::runtime_error);
+}
+
+//////////////////////////////////////////////////
+TEST(ConversionPlanTest, Arrays)
+{
+  // Variable and fixed size number arrays into nested repeated fields.
+  auto plan = make_plan("sensor_msgs/CameraInfo",
+    ignition::msgs::CameraInfo::descriptor(),
+    {{"D", "distortion.k"}, {"K", "intrinsics.k"}, {"P", "projection.p"},
+     {"R", "rectification_matrix"}});
+
+  sensor_msgs::CameraInfo ros1_msg;
+  ros1_msg.width = 640;
+  ros1_msg.height = 480;
+  ros1_msg.D = {0.1, 0.2, 0.3, 0.4, 0.5};
+  for (size_t i = 0; i < ros1_msg.K.size(); ++i)
+    ros1_msg.K[i] = i + 1.0;
+  for (size_t i = 0; i < ros1_msg.P.size(); ++i)
+    ros1_msg.P[i] = i * 2.0;
+  ros1_msg.R[0] = ros1_msg.R[4] = ros1_msg.R[8] = 1.0;
+  auto data = serialize(ros1_msg);
+
+  ignition::msgs::CameraInfo ign_msg;
+  plan->ros1_to_ign(data.data(), data.size(), ign_msg);
+  EXPECT_EQ(640u, ign_msg.width());
+  ASSERT_EQ(5, ign_msg.distortion().k_size());
+  EXPECT_DOUBLE_EQ(0.3, ign_msg.distortion().k(2));
+  ASSERT_EQ(9, ign_msg.intrinsics().k_size());
+  EXPECT_DOUBLE_EQ(9.0, ign_msg.intrinsics().k(8));
+  ASSERT_EQ(12, ign_msg.projection().p_size());
+  EXPECT_DOUBLE_EQ(22.0, ign_msg.projection().p(11));
+  ASSERT_EQ(9, ign_msg.rectification_matrix_size());
+
+  plan->ign_to_ros1(ign_msg, data);
+  EXPECT_EQ(ros1_msg, deserialize<sensor_msgs::CameraInfo>(data));
+
+  // Fixed size arrays are padded with zeros and truncated.
+  ign_msg.mutable_intrinsics()->mutable_k()->Resize(3, 0.0);
+  for (int i = 0; i < 5; ++i)
+    ign_msg.mutable_projection()->add_p(100.0);
+  plan->ign_to_ros1(ign_msg, data);
+  const auto resized = deserialize<sensor_msgs::CameraInfo>(data);
+  EXPECT_DOUBLE_EQ(3.0, resized.K[2]);
+  EXPECT_DOUBLE_EQ(0.0, resized.K[3]);
+  EXPECT_DOUBLE_EQ(22.0, resized.P[11]);
+}
+
+//////////////////////////////////////////////////
+TEST(ConversionPlanTest, MessageArrays)
+{
+  // Arrays of messages, a byte array and numbers into an enum.
+  auto plan = make_plan("sensor_msgs/PointCloud2",
+    ignition::msgs::PointCloudPacked::descriptor(), {{"fields", "field"}});
+
+  sensor_msgs::PointCloud2 ros1_msg;
+  ros1_msg.header.frame_id = "lidar";
+  ros1_msg.height = 1;
+  ros1_msg.width = 2;
+  ros1_msg.fields.resize(2);
+  ros1_msg.fields[0].name = "x";
+  ros1_msg.fields[0].offset = 0;
+  ros1_msg.fields[0].datatype = sensor_msgs::PointField::FLOAT32;
+  ros1_msg.fields[0].count = 1;
+  ros1_msg.fields[1].name = "intensity";
+  ros1_msg.fields[1].offset = 4;
+  ros1_msg.fields[1].datatype = sensor_msgs::PointField::UINT16;
+  ros1_msg.fields[1].count = 1;
+  ros1_msg.point_step = 6;
+  ros1_msg.row_step = 12;
+  ros1_msg.data = {0, 1, 2, 3, 4, 5, 250, 251, 252, 253, 254, 255};
+  ros1_msg.is_dense = true;
+  auto data = serialize(ros1_msg);
+
+  ignition::msgs::PointCloudPacked ign_msg;
+  plan->ros1_to_ign(data.data(), data.size(), ign_msg);
+  EXPECT_EQ("lidar", header_value(ign_msg.header(), "frame_id"));
+  ASSERT_EQ(2, ign_msg.field_size());
+  EXPECT_EQ("intensity", ign_msg.field(1).name());
+  EXPECT_EQ(4u, ign_msg.field(1).offset());
+  EXPECT_EQ(static_cast<int>(sensor_msgs::PointField::UINT16),
+            static_cast<int>(ign_msg.field(1).datatype()));
+  EXPECT_EQ(12u, ign_msg.data().size());
+  EXPECT_EQ(static_cast<char>(255), ign_msg.data()[11]);
+  EXPECT_TRUE(ign_msg.is_dense());
+
+  plan->ign_to_ros1(ign_msg, data);
+  EXPECT_EQ(ros1_msg, deserialize<sensor_msgs::PointCloud2>(data));
+}
+
+//////////////////////////////////////////////////
+template<typename T>
+std::string md5_of_definition()
+{
+  const std::string type = ros::message_traits::datatype<T>();
+  RosMessageSpecs specs;
+  std::string definition;
+  ros1_ign_bridge::load_ros_message_specs(type, specs, definition);
+  return ros1_ign_bridge::ros_message_md5(type, specs);
+}
+
+//////////////////////////////////////////////////
+TEST(ConversionPlanTest, Md5Sum)
+{
+  // Same as the generated code: builtin fields, nested messages, time,
+  // fixed and variable arrays, message arrays and constants.
+  EXPECT_EQ(std::string(ros::message_traits::md5sum<std_msgs::Header>()),
+            md5_of_definition<std_msgs::Header>());
+  EXPECT_EQ(
+    std::string(ros::message_traits::md5sum<geometry_msgs::PoseStamped>()),
+    md5_of_definition<geometry_msgs::PoseStamped>());
+  EXPECT_EQ(std::string(ros::message_traits::md5sum<sensor_msgs::CameraInfo>()),
+            md5_of_definition<sensor_msgs::CameraInfo>());
+  EXPECT_EQ(
+    std::string(ros::message_traits::md5sum<sensor_msgs::PointCloud2>()),
+    md5_of_definition<sensor_msgs::PointCloud2>());
+
+  // The plan advertises it.
+  auto plan = make_plan("geometry_msgs/PoseStamped",
+    ignition::msgs::Pose::descriptor());
+  EXPECT_EQ(
+    std::string(ros::message_traits::md5sum<geometry_msgs::PoseStamped>()),
+    plan->md5sum());
+}
+
+//////////////////////////////////////////////////
+TEST(ConversionPlanTest, Errors)
+{
+  // A mapping to a field that doesn't exist, and a string into a number.
+  EXPECT_THROW(make_plan("geometry_msgs/PoseStamped",
+    ignition::msgs::Pose::descriptor(), {{"pose.position", "nowhere"}}),
+    std::runtime_error);
+  EXPECT_THROW(make_plan("std_msgs/Header",
+    ignition::msgs::Pose::descriptor(), {{"frame_id", "id"}}),
+    std::runtime_error);
+  EXPECT_THROW(make_plan("no_such_package/Type",
+    ignition::msgs::Pose::descriptor()), std::runtime_error);
+}
+
+//////////////////////////////////////////////////
+TEST(ConversionPlanTest, InvalidArrayLength)
+{
+  // A package of its own, found through ROS_PACKAGE_PATH.
+  const std::string root =
+    "/tmp/ros1_ign_bridge_plan_test_" + std::to_string(getpid());
+  const std::string package = root + "/plan_test_msgs";
+  ASSERT_EQ(0, system(("mkdir -p " + package + "/msg").c_str()));
+  std::ofstream(package + "/package.xml") <<
+    "<package format=\"2\"><name>plan_test_msgs</name>"
+    "<version>0.0.0</version><description>Test</description>"
+    "<maintainer email=\"test@test.org\">Test</maintainer>"
+    "<license>Apache 2.0</license></package>\n";
+  const char * package_path = getenv("ROS_PACKAGE_PATH");
+  setenv("ROS_PACKAGE_PATH", (root + ":" +
+    (package_path ? package_path : "")).c_str(), 1);
+
+  for (const std::string length : {"x", "-1", "3.5", "99999999999"})
+  {
+    std::ofstream(package + "/msg/Bad.msg") <<
+      "float64[" << length << "] values\n";
+    RosMessageSpecs specs;
+    std::string definition;
+    EXPECT_THROW(ros1_ign_bridge::load_ros_message_specs(
+      "plan_test_msgs/Bad", specs, definition), std::runtime_error)
+      << length;
+  }
+
+  std::ofstream(package + "/msg/Bad.msg") << "float64[4] values\n";
+  RosMessageSpecs specs;
+  std::string definition;
+  ros1_ign_bridge::load_ros_message_specs(
+    "plan_test_msgs/Bad", specs, definition);
+  ASSERT_EQ(1u, specs["plan_test_msgs/Bad"].fields.size());
+  EXPECT_EQ(4, specs["plan_test_msgs/Bad"].fields[0].array_length);
+
+  EXPECT_EQ(0, system(("rm -rf " + root).c_str()));
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include <ignition/msgs.hh>
+#include <tf2_msgs/TFMessage.h>
+
+#include "ros1_ign_bridge/convert_builtin_interfaces.hpp"
+
+namespace
+{
+
+//////////////////////////////////////////////////
+void set_frame_id(ignition::msgs::Header & header, const std::string & key,
+  const std::string & value)
+{
+  auto entry = header.add_data();
+  entry->set_key(key);
+  entry->add_value(value);
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+TEST(ConvertBuiltinInterfacesTest, PoseVToTF)
+{
+  ignition::msgs::Pose_V ign_msg;
+  ign_msg.mutable_header()->mutable_stamp()->set_sec(4);
+  set_frame_id(*ign_msg.mutable_header(), "frame_id", "world::origin");
+
+  auto pose = ign_msg.add_pose();
+  pose->set_name("robot::base");
+  pose->mutable_position()->set_x(1.0);
+  pose->mutable_orientation()->set_w(1.0);
+
+  pose = ign_msg.add_pose();
+  pose->set_name("robot::camera");
+  pose->mutable_header()->mutable_stamp()->set_sec(5);
+  set_frame_id(*pose->mutable_header(), "frame_id", "robot::base");
+  pose->mutable_orientation()->set_w(1.0);
+
+  tf2_msgs::TFMessage ros1_msg;
+  ros1_ign_bridge::convert_ign_to_1(ign_msg, ros1_msg);
+  ASSERT_EQ(2u, ros1_msg.transforms.size());
+
+  EXPECT_EQ(4u, ros1_msg.transforms[0].header.stamp.sec);
+  EXPECT_EQ("world/origin", ros1_msg.transforms[0].header.frame_id);
+  EXPECT_EQ("robot/base", ros1_msg.transforms[0].child_frame_id);
+  EXPECT_DOUBLE_EQ(1.0, ros1_msg.transforms[0].transform.translation.x);
+
+  EXPECT_EQ(5u, ros1_msg.transforms[1].header.stamp.sec);
+  EXPECT_EQ("robot/base", ros1_msg.transforms[1].header.frame_id);
+  EXPECT_EQ("robot/camera", ros1_msg.transforms[1].child_frame_id);
+}
+
+//////////////////////////////////////////////////
+TEST(ConvertBuiltinInterfacesTest, PoseVToTFManyFrames)
+{
+  // More distinct names than the frame id cache holds: it is emptied in the
+  // middle of the conversion, which must not affect the parent frame id
+  // read before the loop.
+  ignition::msgs::Pose_V ign_msg;
+  set_frame_id(*ign_msg.mutable_header(), "frame_id", "world::origin");
+  const int count = 10000;
+  for (int i = 0; i < count; ++i)
+  {
+    auto pose = ign_msg.add_pose();
+    pose->set_name("model_" + std::to_string(i) + "::link");
+    pose->mutable_orientation()->set_w(1.0);
+  }
+
+  for (int round = 0; round < 2; ++round)
+  {
+    tf2_msgs::TFMessage ros1_msg;
+    ros1_ign_bridge::convert_ign_to_1(ign_msg, ros1_msg);
+    ASSERT_EQ(static_cast<size_t>(count), ros1_msg.transforms.size());
+    for (int i = 0; i < count; ++i)
+    {
+      const auto & transform = ros1_msg.transforms[i];
+      ASSERT_EQ("world/origin", transform.header.frame_id) << i;
+      ASSERT_EQ("model_" + std::to_string(i) + "/link",
+        transform.child_frame_id) << i;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+TEST(ConvertBuiltinInterfacesTest, TFRoundTrip)
+{
+  tf2_msgs::TFMessage ros1_msg;
+  ros1_msg.transforms.resize(2);
+  ros1_msg.transforms[0].header.stamp = ros::Time(7, 8);
+  ros1_msg.transforms[0].header.frame_id = "world";
+  ros1_msg.transforms[0].child_frame_id = "base";
+  ros1_msg.transforms[0].transform.rotation.w = 1.0;
+  ros1_msg.transforms[1].header.stamp = ros::Time(7, 8);
+  ros1_msg.transforms[1].header.frame_id = "base";
+  ros1_msg.transforms[1].child_frame_id = "camera";
+  ros1_msg.transforms[1].transform.translation.z = 0.5;
+  ros1_msg.transforms[1].transform.rotation.w = 1.0;
+
+  ignition::msgs::Pose_V ign_msg;
+  ros1_ign_bridge::convert_1_to_ign(ros1_msg, ign_msg);
+  ASSERT_EQ(2, ign_msg.pose_size());
+  EXPECT_EQ("camera", ign_msg.pose(1).name());
+
+  tf2_msgs::TFMessage result;
+  ros1_ign_bridge::convert_ign_to_1(ign_msg, result);
+  ASSERT_EQ(2u, result.transforms.size());
+  for (size_t i = 0; i < 2; ++i)
+  {
+    EXPECT_EQ(ros1_msg.transforms[i].header.stamp,
+      result.transforms[i].header.stamp);
+    EXPECT_EQ(ros1_msg.transforms[i].header.frame_id,
+      result.transforms[i].header.frame_id);
+    EXPECT_EQ(ros1_msg.transforms[i].child_frame_id,
+      result.transforms[i].child_frame_id);
+  }
+  EXPECT_DOUBLE_EQ(0.5, result.transforms[1].transform.translation.z);
+}
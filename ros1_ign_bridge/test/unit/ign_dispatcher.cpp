@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ignition/msgs.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge_state.hpp"
+#include "ros1_ign_bridge/factory_interface.hpp"
+#include "ros1_ign_bridge/ign_dispatcher.hpp"
+
+using ros1_ign_bridge::BridgeState;
+using ros1_ign_bridge::FactoryInterface;
+using ros1_ign_bridge::IgnDispatcher;
+
+namespace
+{
+
+/// \brief Records the messages forwarded by the dispatcher instead of
+/// publishing them to ROS 1. While held, the worker blocks in the first
+/// message it forwards, so that the following ones pile up in the queues.
+class RecordingFactory : public FactoryInterface
+{
+public:
+  ros::Publisher
+  create_ros1_publisher(
+    ros::NodeHandle, const std::string &, size_t,
+    const ros::SubscriberStatusCallback &,
+    const ros::SubscriberStatusCallback &) override
+  {
+    return ros::Publisher();
+  }
+
+  ignition::transport::Node::Publisher
+  create_ign_publisher(
+    std::shared_ptr<ignition::transport::Node>, const std::string &, size_t,
+    size_t) override
+  {
+    return ignition::transport::Node::Publisher();
+  }
+
+  ros::Subscriber
+  create_ros1_subscriber(
+    ros::NodeHandle, const std::string &, size_t,
+    ignition::transport::Node::Publisher &,
+    std::shared_ptr<BridgeState>) override
+  {
+    return ros::Subscriber();
+  }
+
+  void
+  create_ign_subscriber(
+    std::shared_ptr<ignition::transport::Node>, const std::string &, size_t,
+    ros::Publisher, std::shared_ptr<BridgeState>, size_t) override
+  {
+  }
+
+  bool
+  forward_ign_serialized(
+    const char * data, size_t size, ros::Publisher,
+    std::shared_ptr<BridgeState>) override
+  {
+    ignition::msgs::StringMsg msg;
+    if (!msg.ParseFromArray(data, static_cast<int>(size)))
+      return false;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (held_)
+    {
+      blocked_ = true;
+      condition_.notify_all();
+      condition_.wait(lock, [this] { return !held_; });
+    }
+    received_.push_back(msg.data());
+    condition_.notify_all();
+    return true;
+  }
+
+  void
+  hold()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_ = true;
+    blocked_ = false;
+  }
+
+  /// \brief Wait until the worker is blocked in a message.
+  bool
+  wait_blocked()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return condition_.wait_for(lock, std::chrono::seconds(5),
+      [this] { return blocked_; });
+  }
+
+  void
+  release()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      held_ = false;
+    }
+    condition_.notify_all();
+  }
+
+  /// \brief Wait until count messages were forwarded and return them all.
+  std::vector<std::string>
+  wait_received(size_t count)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait_for(lock, std::chrono::seconds(5),
+      [this, count] { return received_.size() >= count; });
+    return received_;
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool held_ = false;
+  bool blocked_ = false;
+  std::vector<std::string> received_;
+};
+
+/// \brief Publish one string message from the test to an Ignition topic.
+class Talker
+{
+public:
+  explicit Talker(const std::string & topic)
+  : pub_(node_.Advertise<ignition::msgs::StringMsg>(topic))
+  {
+  }
+
+  void
+  say(const std::string & data)
+  {
+    ignition::msgs::StringMsg msg;
+    msg.set_data(data);
+    pub_.Publish(msg);
+  }
+
+private:
+  ignition::transport::Node node_;
+  ignition::transport::Node::Publisher pub_;
+};
+
+/// \brief Let messages still in flight reach the recorder.
+void
+settle()
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////
+TEST(IgnDispatcherTest, KeepsOrder)
+{
+  IgnDispatcher dispatcher(1, 2);
+  auto factory = std::make_shared<RecordingFactory>();
+  auto state = std::make_shared<BridgeState>();
+  ASSERT_TRUE(dispatcher.subscribe("/dispatch_order", "ignition.msgs.StringMsg",
+    factory, ros::Publisher(), state, 1000));
+
+  Talker talker("/dispatch_order");
+  std::vector<std::string> sent;
+  for (int i = 0; i < 500; ++i)
+  {
+    sent.push_back(std::to_string(i));
+    talker.say(sent.back());
+  }
+
+  EXPECT_EQ(sent, factory->wait_received(sent.size()));
+  EXPECT_EQ(0u, state->stats.queue_dropped.load());
+}
+
+/////////////////////////////////////////////////
+TEST(IgnDispatcherTest, DropsOldestPerTopic)
+{
+  // A single worker serves both topics.
+  IgnDispatcher dispatcher(1, 1);
+  auto factory = std::make_shared<RecordingFactory>();
+  auto busy_state = std::make_shared<BridgeState>();
+  auto quiet_state = std::make_shared<BridgeState>();
+  ASSERT_TRUE(dispatcher.subscribe("/dispatch_busy", "ignition.msgs.StringMsg",
+    factory, ros::Publisher(), busy_state, 3));
+  ASSERT_TRUE(dispatcher.subscribe("/dispatch_quiet",
+    "ignition.msgs.StringMsg", factory, ros::Publisher(), quiet_state, 3));
+
+  Talker busy("/dispatch_busy");
+  Talker quiet("/dispatch_quiet");
+  factory->hold();
+  busy.say("busy0");
+  ASSERT_TRUE(factory->wait_blocked());
+
+  // The busy topic overflows its own queue, which keeps its newest
+  // messages, while the quiet one loses nothing.
+  for (int i = 1; i < 10; ++i)
+    busy.say("busy" + std::to_string(i));
+  quiet.say("quiet0");
+  quiet.say("quiet1");
+  factory->release();
+
+  // The topics take turns.
+  const std::vector<std::string> expected{
+    "busy0", "busy7", "quiet0", "busy8", "quiet1", "busy9"};
+  EXPECT_EQ(expected, factory->wait_received(expected.size()));
+  settle();
+  EXPECT_EQ(expected, factory->wait_received(expected.size()));
+  EXPECT_EQ(6u, busy_state->stats.queue_dropped.load());
+  EXPECT_EQ(0u, busy_state->stats.dropped.load());
+  EXPECT_EQ(0u, quiet_state->stats.queue_dropped.load());
+}
+
+/////////////////////////////////////////////////
+TEST(IgnDispatcherTest, Unsubscribe)
+{
+  IgnDispatcher dispatcher(1, 1);
+  auto factory = std::make_shared<RecordingFactory>();
+  auto gate_state = std::make_shared<BridgeState>();
+  auto state = std::make_shared<BridgeState>();
+  ASSERT_TRUE(dispatcher.subscribe("/dispatch_gate", "ignition.msgs.StringMsg",
+    factory, ros::Publisher(), gate_state, 10));
+  ASSERT_TRUE(dispatcher.subscribe("/dispatch_unsub",
+    "ignition.msgs.StringMsg", factory, ros::Publisher(), state, 10));
+
+  Talker gate("/dispatch_gate");
+  Talker talker("/dispatch_unsub");
+  factory->hold();
+  gate.say("gate");
+  ASSERT_TRUE(factory->wait_blocked());
+
+  // The queued messages are discarded with the subscription.
+  talker.say("queued0");
+  talker.say("queued1");
+  dispatcher.unsubscribe("/dispatch_unsub");
+  factory->release();
+  talker.say("late");
+  settle();
+  EXPECT_EQ(std::vector<std::string>{"gate"}, factory->wait_received(1));
+
+  // Subscribing again forwards the new messages only.
+  ASSERT_TRUE(dispatcher.subscribe("/dispatch_unsub",
+    "ignition.msgs.StringMsg", factory, ros::Publisher(), state, 10));
+  talker.say("again");
+  const std::vector<std::string> expected{"gate", "again"};
+  EXPECT_EQ(expected, factory->wait_received(expected.size()));
+}
+
+/////////////////////////////////////////////////
+TEST(IgnDispatcherTest, ResubscribeReplacesRoute)
+{
+  IgnDispatcher dispatcher(1, 1);
+  auto old_factory = std::make_shared<RecordingFactory>();
+  auto new_factory = std::make_shared<RecordingFactory>();
+  auto state = std::make_shared<BridgeState>();
+  ASSERT_TRUE(dispatcher.subscribe("/dispatch_replaced",
+    "ignition.msgs.StringMsg", old_factory, ros::Publisher(), state, 10));
+
+  Talker talker("/dispatch_replaced");
+  old_factory->hold();
+  talker.say("first");
+  ASSERT_TRUE(old_factory->wait_blocked());
+  talker.say("queued");
+
+  // The messages queued for the replaced route never reach it.
+  ASSERT_TRUE(dispatcher.subscribe("/dispatch_replaced",
+    "ignition.msgs.StringMsg", new_factory, ros::Publisher(), state, 10));
+  old_factory->release();
+  talker.say("second");
+
+  EXPECT_EQ(std::vector<std::string>{"second"},
+            new_factory->wait_received(1));
+  settle();
+  EXPECT_EQ(std::vector<std::string>{"first"}, old_factory->wait_received(1));
+}
+
+/////////////////////////////////////////////////
+TEST(IgnDispatcherTest, ChurnWhileReceiving)
+{
+  IgnDispatcher dispatcher(2, 2);
+  auto factory = std::make_shared<RecordingFactory>();
+  auto state = std::make_shared<BridgeState>();
+  ASSERT_TRUE(dispatcher.subscribe("/dispatch_steady",
+    "ignition.msgs.StringMsg", factory, ros::Publisher(), state, 1000));
+
+  // Other topics come and go, replacing the route table, while the steady
+  // topic receives.
+  std::atomic<bool> done{false};
+  std::thread churn([&dispatcher, &done]
+    {
+      auto other = std::make_shared<RecordingFactory>();
+      auto other_state = std::make_shared<BridgeState>();
+      for (int i = 0; !done; i = (i + 1) % 20)
+      {
+        const std::string topic = "/dispatch_churn_" + std::to_string(i);
+        dispatcher.subscribe(topic, "ignition.msgs.StringMsg", other,
+          ros::Publisher(), other_state, 10);
+        if (i % 2 == 0)
+          dispatcher.unsubscribe(topic);
+      }
+    });
+
+  Talker talker("/dispatch_steady");
+  std::vector<std::string> sent;
+  for (int i = 0; i < 1000; ++i)
+  {
+    sent.push_back(std::to_string(i));
+    talker.say(sent.back());
+  }
+  EXPECT_EQ(sent, factory->wait_received(sent.size()));
+
+  done = true;
+  churn.join();
+}
+
+/////////////////////////////////////////////////
+TEST(IgnDispatcherTest, Stop)
+{
+  IgnDispatcher dispatcher(2, 2);
+  auto factory = std::make_shared<RecordingFactory>();
+  auto state = std::make_shared<BridgeState>();
+  dispatcher.stop();
+  EXPECT_FALSE(dispatcher.subscribe("/dispatch_stopped",
+    "ignition.msgs.StringMsg", factory, ros::Publisher(), state, 10));
+  dispatcher.stop();
+}
+
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ignition/msgs.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ros1_ign_bridge/bridge_stats.hpp"
+#include "ros1_ign_bridge/ign_publish_queue.hpp"
+
+using ros1_ign_bridge::BridgeStats;
+using ros1_ign_bridge::IgnPublishQueue;
+using ros1_ign_bridge::QueuePolicy;
+
+namespace
+{
+
+/// \brief In-process subscriber, called from the sender thread of the
+/// queue. It holds the first message until released, so that the following
+/// ones pile up in the queue.
+class BlockingSubscriber
+{
+public:
+  explicit BlockingSubscriber(const std::string & topic)
+  {
+    node_.Subscribe(topic, &BlockingSubscriber::on_message, this);
+  }
+
+  /// \brief Wait until the first message is being published.
+  bool
+  wait_blocked()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return condition_.wait_for(lock, std::chrono::seconds(5),
+      [this] { return !received_.empty(); });
+  }
+
+  void
+  release()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      released_ = true;
+    }
+    condition_.notify_all();
+  }
+
+  /// \brief Wait until count messages were received and return them.
+  std::vector<int>
+  wait_received(size_t count)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait_for(lock, std::chrono::seconds(5),
+      [this, count] { return received_.size() >= count; });
+    return received_;
+  }
+
+private:
+  void
+  on_message(const ignition::msgs::Int32 & msg)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    received_.push_back(msg.data());
+    condition_.notify_all();
+    condition_.wait(lock, [this] { return released_; });
+  }
+
+  ignition::transport::Node node_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<int> received_;
+  bool released_ = false;
+};
+
+//////////////////////////////////////////////////
+bool push(IgnPublishQueue & queue, int data)
+{
+  std::unique_ptr<ignition::msgs::Int32> msg(new ignition::msgs::Int32());
+  msg->set_data(data);
+  return queue.push(std::move(msg), ros1_ign_bridge::steady_now_ns(), false,
+    0);
+}
+
+//////////////////////////////////////////////////
+/// \brief Publish 0, which blocks the sender thread, then push 1 to 3 in a
+/// queue of 2 messages.
+std::vector<int> overflow(const std::string & topic, QueuePolicy policy,
+  BridgeStats & stats)
+{
+  BlockingSubscriber subscriber(topic);
+  ignition::transport::Node node;
+  auto publisher = node.Advertise<ignition::msgs::Int32>(topic);
+  IgnPublishQueue queue(publisher, 2, policy, stats, 0);
+
+  EXPECT_TRUE(push(queue, 0));
+  EXPECT_TRUE(subscriber.wait_blocked());
+  EXPECT_TRUE(push(queue, 1));
+  EXPECT_TRUE(push(queue, 2));
+  EXPECT_FALSE(push(queue, 3));
+  subscriber.release();
+  return subscriber.wait_received(3);
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+TEST(IgnPublishQueueTest, DropOldest)
+{
+  BridgeStats stats;
+  EXPECT_EQ(std::vector<int>({0, 2, 3}),
+    overflow("/queue_drop_oldest", QueuePolicy::DROP_OLDEST, stats));
+  EXPECT_EQ(1u, stats.queue_dropped.load());
+  EXPECT_EQ(0u, stats.dropped.load());
+  EXPECT_EQ(3u, stats.messages_out.load());
+}
+
+//////////////////////////////////////////////////
+TEST(IgnPublishQueueTest, DropNewest)
+{
+  BridgeStats stats;
+  EXPECT_EQ(std::vector<int>({0, 1, 2}),
+    overflow("/queue_drop_newest", QueuePolicy::DROP_NEWEST, stats));
+  EXPECT_EQ(1u, stats.queue_dropped.load());
+  EXPECT_EQ(0u, stats.dropped.load());
+  EXPECT_EQ(3u, stats.messages_out.load());
+}
+
+//////////////////////////////////////////////////
+TEST(IgnPublishQueueTest, Stop)
+{
+  BridgeStats stats;
+  BlockingSubscriber subscriber("/queue_stop");
+  ignition::transport::Node node;
+  auto publisher = node.Advertise<ignition::msgs::Int32>("/queue_stop");
+  IgnPublishQueue queue(publisher, 4, QueuePolicy::DROP_OLDEST, stats, 0);
+
+  // The queued messages are discarded and later pushes ignored.
+  EXPECT_TRUE(push(queue, 0));
+  EXPECT_TRUE(subscriber.wait_blocked());
+  EXPECT_TRUE(push(queue, 1));
+  subscriber.release();
+  queue.stop();
+  EXPECT_FALSE(push(queue, 2));
+  queue.stop();
+  EXPECT_LE(stats.messages_out.load(), 2u);
+  EXPECT_EQ(0u, stats.queue_dropped.load());
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <ignition/msgs.hh>
+#include <std_msgs/String.h>
+#include <tf2_msgs/TFMessage.h>
+
+#include "ros1_ign_bridge/convert_builtin_interfaces.hpp"
+#include "ros1_ign_bridge/message_recycling.hpp"
+
+using ros1_ign_bridge::ConversionTarget;
+using ros1_ign_bridge::IgnConversionTarget;
+using ros1_ign_bridge::MessageRecycling;
+
+static_assert(MessageRecycling<sensor_msgs::Image>::enabled,
+  "images are recycled");
+static_assert(MessageRecycling<sensor_msgs::LaserScan>::enabled,
+  "laser scans are recycled");
+static_assert(MessageRecycling<sensor_msgs::PointCloud2>::enabled,
+  "point clouds are recycled");
+static_assert(!MessageRecycling<std_msgs::String>::enabled,
+  "small messages are not recycled");
+
+namespace
+{
+
+/// \brief Heap allocations made by this process so far.
+std::atomic<size_t> g_allocations{0};
+
+}  // namespace
+
+void *
+operator new(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  void * ptr = std::malloc(size > 0 ? size : 1);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void
+operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void * ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace
+{
+
+//////////////////////////////////////////////////
+tf2_msgs::TFMessage tf_message(size_t transforms)
+{
+  tf2_msgs::TFMessage msg;
+  msg.transforms.resize(transforms);
+  for (size_t i = 0; i < transforms; ++i)
+  {
+    msg.transforms[i].header.stamp = ros::Time(10, 20);
+    msg.transforms[i].header.frame_id = "world";
+    msg.transforms[i].child_frame_id = "link_" + std::to_string(i);
+    msg.transforms[i].transform.rotation.w = 1.0;
+  }
+  return msg;
+}
+
+//////////////////////////////////////////////////
+ignition::msgs::Image ign_image(unsigned int width, unsigned int height,
+  char value)
+{
+  ignition::msgs::Image msg;
+  msg.set_width(width);
+  msg.set_height(height);
+  msg.set_pixel_format_type(ignition::msgs::PixelFormatType::RGB_INT8);
+  msg.set_data(std::string(width * height * 3, value));
+  return msg;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+TEST(MessageRecyclingTest, ResetKeepsCapacity)
+{
+  sensor_msgs::Image image;
+  image.header.frame_id = "camera";
+  image.height = 480;
+  image.encoding = "rgb8";
+  image.data.assign(1000, 7);
+  const auto * image_data = image.data.data();
+  MessageRecycling<sensor_msgs::Image>::reset(image);
+  EXPECT_TRUE(image.header.frame_id.empty());
+  EXPECT_EQ(0u, image.height);
+  EXPECT_TRUE(image.encoding.empty());
+  EXPECT_TRUE(image.data.empty());
+  EXPECT_GE(image.data.capacity(), 1000u);
+  EXPECT_EQ(image_data, image.data.data());
+
+  sensor_msgs::LaserScan scan;
+  scan.angle_max = 1.0f;
+  scan.ranges.assign(360, 1.0f);
+  scan.intensities.assign(360, 2.0f);
+  MessageRecycling<sensor_msgs::LaserScan>::reset(scan);
+  EXPECT_EQ(0.0f, scan.angle_max);
+  EXPECT_TRUE(scan.ranges.empty());
+  EXPECT_TRUE(scan.intensities.empty());
+  EXPECT_GE(scan.ranges.capacity(), 360u);
+  EXPECT_GE(scan.intensities.capacity(), 360u);
+
+  sensor_msgs::PointCloud2 cloud;
+  cloud.fields.resize(3);
+  cloud.width = 10;
+  cloud.data.assign(120, 1);
+  MessageRecycling<sensor_msgs::PointCloud2>::reset(cloud);
+  EXPECT_TRUE(cloud.fields.empty());
+  EXPECT_EQ(0u, cloud.width);
+  EXPECT_TRUE(cloud.data.empty());
+  EXPECT_GE(cloud.data.capacity(), 120u);
+}
+
+//////////////////////////////////////////////////
+TEST(MessageRecyclingTest, OneMessagePerThread)
+{
+  sensor_msgs::Image * first = nullptr;
+  {
+    ConversionTarget<sensor_msgs::Image> target;
+    first = &target.get();
+    first->data.assign(100, 1);
+  }
+  {
+    // Another target on the same thread hands out the same message, reset.
+    ConversionTarget<sensor_msgs::Image> target;
+    sensor_msgs::Image & msg = target.get();
+    EXPECT_EQ(first, &msg);
+    EXPECT_TRUE(msg.data.empty());
+    EXPECT_GE(msg.data.capacity(), 100u);
+  }
+
+  sensor_msgs::Image * other = nullptr;
+  std::thread thread([&other]
+    {
+      ConversionTarget<sensor_msgs::Image> target;
+      other = &target.get();
+    });
+  thread.join();
+  EXPECT_NE(first, other);
+
+  // Other types get a message of their own target.
+  ConversionTarget<std_msgs::String> a;
+  ConversionTarget<std_msgs::String> b;
+  EXPECT_NE(&a.get(), &b.get());
+}
+
+//////////////////////////////////////////////////
+TEST(MessageRecyclingTest, NoStaleData)
+{
+  // A smaller image converted into a recycled message holds none of the
+  // bytes of the previous, larger one.
+  {
+    ConversionTarget<sensor_msgs::Image> target;
+    ros1_ign_bridge::convert_ign_to_1(ign_image(8, 6, 'a'), target.get());
+    EXPECT_EQ(8u * 6u * 3u, target.get().data.size());
+  }
+  {
+    ConversionTarget<sensor_msgs::Image> target;
+    sensor_msgs::Image & msg = target.get();
+    ros1_ign_bridge::convert_ign_to_1(ign_image(2, 2, 'b'), msg);
+
+    sensor_msgs::Image fresh;
+    ros1_ign_bridge::convert_ign_to_1(ign_image(2, 2, 'b'), fresh);
+    EXPECT_EQ(fresh.width, msg.width);
+    EXPECT_EQ(fresh.height, msg.height);
+    EXPECT_EQ(fresh.step, msg.step);
+    EXPECT_EQ(fresh.encoding, msg.encoding);
+    EXPECT_EQ(fresh.data, msg.data);
+  }
+
+  // Same for a scan with intensities followed by one without.
+  ignition::msgs::LaserScan scan;
+  scan.set_count(4);
+  for (int i = 0; i < 4; ++i)
+  {
+    scan.add_ranges(1.0);
+    scan.add_intensities(5.0);
+  }
+  {
+    ConversionTarget<sensor_msgs::LaserScan> target;
+    ros1_ign_bridge::convert_ign_to_1(scan, target.get());
+    EXPECT_EQ(4u, target.get().intensities.size());
+  }
+  scan.set_count(2);
+  scan.clear_ranges();
+  scan.clear_intensities();
+  scan.add_ranges(2.0);
+  scan.add_ranges(3.0);
+  {
+    ConversionTarget<sensor_msgs::LaserScan> target;
+    sensor_msgs::LaserScan & msg = target.get();
+    ros1_ign_bridge::convert_ign_to_1(scan, msg);
+    ASSERT_EQ(2u, msg.ranges.size());
+    EXPECT_FLOAT_EQ(2.0f, msg.ranges[0]);
+    EXPECT_FLOAT_EQ(3.0f, msg.ranges[1]);
+    EXPECT_TRUE(msg.intensities.empty());
+  }
+}
+
+//////////////////////////////////////////////////
+TEST(MessageRecyclingTest, IgnTargetIsEmpty)
+{
+  {
+    IgnConversionTarget<ignition::msgs::Pose_V> target;
+    ros1_ign_bridge::convert_1_to_ign(tf_message(5), target.get());
+    EXPECT_EQ(5, target.get().pose_size());
+  }
+  IgnConversionTarget<ignition::msgs::Pose_V> target;
+  ignition::msgs::Pose_V & msg = target.get();
+  EXPECT_EQ(0, msg.pose_size());
+  EXPECT_FALSE(msg.has_header());
+
+  ros1_ign_bridge::convert_1_to_ign(tf_message(1), msg);
+  ASSERT_EQ(1, msg.pose_size());
+  EXPECT_EQ("link_0", msg.pose(0).name());
+}
+
+//////////////////////////////////////////////////
+TEST(MessageRecyclingTest, IgnTargetAllocations)
+{
+  // The reused or arena allocated message must allocate less than a new
+  // message for every conversion. How much less depends on the protobuf
+  // version, see IgnConversionTarget.
+  const tf2_msgs::TFMessage ros1_msg = tf_message(50);
+
+  size_t fresh = 0;
+  {
+    const size_t before = g_allocations.load();
+    ignition::msgs::Pose_V ign_msg;
+    ros1_ign_bridge::convert_1_to_ign(ros1_msg, ign_msg);
+    fresh = g_allocations.load() - before;
+  }
+
+  size_t reused = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    const size_t before = g_allocations.load();
+    IgnConversionTarget<ignition::msgs::Pose_V> target;
+    ros1_ign_bridge::convert_1_to_ign(ros1_msg, target.get());
+    reused = g_allocations.load() - before;
+  }
+  EXPECT_LT(reused, fresh);
+}
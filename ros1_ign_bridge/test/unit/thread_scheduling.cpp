@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ros1_ign_bridge/thread_scheduling.hpp"
+
+namespace
+{
+
+//////////////////////////////////////////////////
+/// \brief First CPU this process may run on.
+int allowed_cpu()
+{
+  cpu_set_t set;
+  if (sched_getaffinity(0, sizeof(set), &set) != 0)
+    return 0;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+  {
+    if (CPU_ISSET(cpu, &set))
+      return cpu;
+  }
+  return 0;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+TEST(ThreadSchedulingTest, Affinity)
+{
+  // A thread of its own, so that the test process keeps its affinity.
+  const int cpu = allowed_cpu();
+  std::thread thread([cpu]
+    {
+      std::string error;
+      EXPECT_TRUE(ros1_ign_bridge::set_thread_scheduling(
+        pthread_self(), 0, {cpu}, error)) << error;
+      EXPECT_TRUE(error.empty());
+      EXPECT_EQ("SCHED_OTHER, CPUs " + std::to_string(cpu),
+        ros1_ign_bridge::describe_thread_scheduling(pthread_self()));
+    });
+  thread.join();
+}
+
+//////////////////////////////////////////////////
+TEST(ThreadSchedulingTest, Priority)
+{
+  const int cpu = allowed_cpu();
+  std::thread thread([cpu]
+    {
+      // Whether SCHED_FIFO is allowed depends on the rtprio limit of the
+      // user; the affinity is applied either way.
+      std::string error;
+      const bool ok = ros1_ign_bridge::set_thread_scheduling(
+        pthread_self(), 1, {cpu}, error);
+      const std::string description =
+        ros1_ign_bridge::describe_thread_scheduling(pthread_self());
+      if (ok)
+      {
+        EXPECT_TRUE(error.empty());
+        EXPECT_EQ("SCHED_FIFO priority 1, CPUs " + std::to_string(cpu),
+          description);
+      }
+      else
+      {
+        EXPECT_NE(std::string::npos, error.find("SCHED_FIFO priority [1]"))
+          << error;
+        EXPECT_EQ(std::string::npos, error.find("CPU affinity")) << error;
+        EXPECT_EQ("SCHED_OTHER, CPUs " + std::to_string(cpu), description);
+      }
+    });
+  thread.join();
+}
+
+//////////////////////////////////////////////////
+TEST(ThreadSchedulingTest, NothingToChange)
+{
+  std::thread thread([]
+    {
+      const std::string before =
+        ros1_ign_bridge::describe_thread_scheduling(pthread_self());
+      std::string error;
+      EXPECT_TRUE(ros1_ign_bridge::set_thread_scheduling(
+        pthread_self(), 0, {}, error));
+      EXPECT_EQ(before,
+        ros1_ign_bridge::describe_thread_scheduling(pthread_self()));
+    });
+  thread.join();
+}
+
+//////////////////////////////////////////////////
+TEST(ThreadSchedulingTest, NoUsableCpu)
+{
+  std::thread thread([]
+    {
+      // Out of range CPUs are skipped, which leaves an empty set.
+      std::string error;
+      EXPECT_FALSE(ros1_ign_bridge::set_thread_scheduling(
+        pthread_self(), 0, {-1, CPU_SETSIZE}, error));
+      EXPECT_NE(std::string::npos, error.find("CPU affinity")) << error;
+    });
+  thread.join();
+}
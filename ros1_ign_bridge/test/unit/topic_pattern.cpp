@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ros1_ign_bridge/topic_pattern.hpp"
+
+using ros1_ign_bridge::TopicPattern;
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, IsPattern)
+{
+  EXPECT_FALSE(TopicPattern::is_pattern("/model/robot/pose"));
+  EXPECT_TRUE(TopicPattern::is_pattern("/model/*/pose"));
+  EXPECT_TRUE(TopicPattern::is_pattern("/model/robot?"));
+  EXPECT_TRUE(TopicPattern::is_pattern("/model/[ab]"));
+  EXPECT_TRUE(TopicPattern::is_pattern("/model\\/pose"));
+  EXPECT_TRUE(TopicPattern::is_pattern("re:/model"));
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, Literal)
+{
+  TopicPattern pattern("/model/pose");
+  EXPECT_TRUE(pattern.matches("/model/pose"));
+  EXPECT_FALSE(pattern.matches("/model/pose2"));
+  EXPECT_FALSE(pattern.matches("/model/pos"));
+  EXPECT_EQ("/model/pose", pattern.pattern());
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, StarWithinLevel)
+{
+  TopicPattern pattern("/model/*/pose");
+  EXPECT_TRUE(pattern.matches("/model/robot/pose"));
+  EXPECT_TRUE(pattern.matches("/model//pose"));
+  EXPECT_FALSE(pattern.matches("/model/robot/arm/pose"));
+  EXPECT_FALSE(pattern.matches("/model/robot/pose/x"));
+
+  // A trailing star doesn't cross levels either.
+  TopicPattern trailing("/model/*");
+  EXPECT_TRUE(trailing.matches("/model/robot"));
+  EXPECT_TRUE(trailing.matches("/model/"));
+  EXPECT_FALSE(trailing.matches("/model/robot/pose"));
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, StarStarAcrossLevels)
+{
+  TopicPattern pattern("/model/**/pose");
+  EXPECT_TRUE(pattern.matches("/model/robot/pose"));
+  EXPECT_TRUE(pattern.matches("/model/robot/arm/pose"));
+  EXPECT_FALSE(pattern.matches("/model/robot/arm/twist"));
+
+  TopicPattern trailing("/model/**");
+  EXPECT_TRUE(trailing.matches("/model/robot/arm/pose"));
+  EXPECT_FALSE(trailing.matches("/world/robot"));
+
+  // Runs of stars are one star, or one double star if any is.
+  TopicPattern run("/model/***");
+  EXPECT_TRUE(run.matches("/model/robot/pose"));
+  TopicPattern leading("**/pose");
+  EXPECT_TRUE(leading.matches("/model/robot/pose"));
+  TopicPattern single("*/pose");
+  EXPECT_TRUE(single.matches("/pose"));
+  EXPECT_FALSE(single.matches("/model/pose"));
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, QuestionMark)
+{
+  TopicPattern pattern("/robot_?/pose");
+  EXPECT_TRUE(pattern.matches("/robot_1/pose"));
+  EXPECT_FALSE(pattern.matches("/robot_/pose"));
+  EXPECT_FALSE(pattern.matches("/robot_12/pose"));
+  EXPECT_FALSE(TopicPattern("/a?b").matches("/a/b"));
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, Sets)
+{
+  TopicPattern range("/robot_[0-9a-c]");
+  EXPECT_TRUE(range.matches("/robot_0"));
+  EXPECT_TRUE(range.matches("/robot_9"));
+  EXPECT_TRUE(range.matches("/robot_b"));
+  EXPECT_FALSE(range.matches("/robot_d"));
+  EXPECT_FALSE(range.matches("/robot_"));
+
+  TopicPattern negated("/robot_[!0-9]");
+  EXPECT_TRUE(negated.matches("/robot_x"));
+  EXPECT_FALSE(negated.matches("/robot_5"));
+
+  // A set never matches the level separator, even negated.
+  EXPECT_FALSE(TopicPattern("/a[/b]c").matches("/a/c"));
+  EXPECT_FALSE(negated.matches("/robot_/"));
+
+  // A "-" that doesn't make a range is itself.
+  TopicPattern dash("/robot[a-]");
+  EXPECT_TRUE(dash.matches("/robota"));
+  EXPECT_TRUE(dash.matches("/robot-"));
+  EXPECT_FALSE(dash.matches("/robotb"));
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, BracketFirstInSet)
+{
+  TopicPattern pattern("/robot[]a]");
+  EXPECT_TRUE(pattern.matches("/robot]"));
+  EXPECT_TRUE(pattern.matches("/robota"));
+  EXPECT_FALSE(pattern.matches("/robotb"));
+
+  TopicPattern negated("/robot[!]a]");
+  EXPECT_TRUE(negated.matches("/robotb"));
+  EXPECT_FALSE(negated.matches("/robot]"));
+  EXPECT_FALSE(negated.matches("/robota"));
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, Escapes)
+{
+  TopicPattern pattern("/robot\\*\\?\\[x\\]\\\\");
+  EXPECT_TRUE(pattern.matches("/robot*?[x]\\"));
+  EXPECT_FALSE(pattern.matches("/robotab[x]\\"));
+  EXPECT_FALSE(pattern.matches("/robot*?x\\"));
+
+  // An escaped letter is the letter.
+  EXPECT_TRUE(TopicPattern("/\\robot").matches("/robot"));
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, PrefixShortcut)
+{
+  TopicPattern pattern("/model/robot_*");
+  EXPECT_TRUE(pattern.matches("/model/robot_1"));
+  EXPECT_FALSE(pattern.matches("/model/robo"));
+  EXPECT_FALSE(pattern.matches("/world/robot_1"));
+  EXPECT_FALSE(pattern.matches(""));
+
+  // Without a literal start every name is matched in full.
+  TopicPattern wildcard("*");
+  EXPECT_TRUE(wildcard.matches(""));
+  EXPECT_TRUE(wildcard.matches("robot"));
+  EXPECT_FALSE(wildcard.matches("/robot"));
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, Backtracking)
+{
+  // The first expansions that look right turn out too short.
+  EXPECT_TRUE(TopicPattern("/a*b").matches("/abab"));
+  EXPECT_TRUE(TopicPattern("/a*b*c").matches("/abxbyc"));
+  EXPECT_FALSE(TopicPattern("/a*b*c").matches("/abxbyd"));
+  EXPECT_TRUE(TopicPattern("/**/x/**/y").matches("/a/x/b/x/c/y"));
+  EXPECT_FALSE(TopicPattern("/**/x/*/y").matches("/a/x/b/c/y"));
+  EXPECT_TRUE(TopicPattern("/*/[0-9]?/pose").matches("/r/1a/pose"));
+
+  // Failing with many stars stays fast.
+  const std::string name = "/" + std::string(40, 'a');
+  EXPECT_FALSE(TopicPattern("/*a*a*a*a*b").matches(name));
+  EXPECT_TRUE(TopicPattern("/*a*a*a*a*").matches(name));
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, Regex)
+{
+  TopicPattern pattern("re:/model/robot_[0-9]+/(pose|odometry)");
+  EXPECT_TRUE(pattern.matches("/model/robot_12/pose"));
+  EXPECT_TRUE(pattern.matches("/model/robot_1/odometry"));
+  EXPECT_FALSE(pattern.matches("/model/robot_/pose"));
+
+  // The whole name must match.
+  EXPECT_FALSE(pattern.matches("/model/robot_1/pose/x"));
+  EXPECT_FALSE(TopicPattern("re:/model").matches("/model/robot"));
+}
+
+//////////////////////////////////////////////////
+TEST(TopicPatternTest, Malformed)
+{
+  EXPECT_THROW(TopicPattern("/robot[ab"), std::runtime_error);
+  EXPECT_THROW(TopicPattern("/robot[]"), std::runtime_error);
+  EXPECT_THROW(TopicPattern("/robot[z-a]"), std::runtime_error);
+  EXPECT_THROW(TopicPattern("/robot\\"), std::runtime_error);
+  EXPECT_THROW(TopicPattern("re:/robot_(["), std::runtime_error);
+}
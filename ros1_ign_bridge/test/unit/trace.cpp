@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ros1_ign_bridge/trace.hpp"
+
+using ros1_ign_bridge::TraceEvent;
+using ros1_ign_bridge::TraceScope;
+using ros1_ign_bridge::Tracer;
+
+namespace
+{
+
+//////////////////////////////////////////////////
+std::string read_file(const std::string & path)
+{
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+//////////////////////////////////////////////////
+size_t count(const std::string & text, const std::string & pattern)
+{
+  size_t result = 0;
+  for (auto pos = text.find(pattern); pos != std::string::npos;
+       pos = text.find(pattern, pos + pattern.size()))
+  {
+    ++result;
+  }
+  return result;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+TEST(TraceTest, WritesChromeTrace)
+{
+  const std::string path =
+    "/tmp/ros1_ign_bridge_trace_test_" + std::to_string(getpid()) + ".json";
+  Tracer & tracer = Tracer::instance();
+  const uint32_t label = tracer.intern("/chatter \"quoted\"");
+  EXPECT_EQ(label, tracer.intern("/chatter \"quoted\""));
+  EXPECT_NE(label, tracer.intern("/other"));
+
+  // Nothing is recorded while stopped.
+  EXPECT_FALSE(Tracer::enabled());
+  {
+    TraceScope scope("before_start", label);
+  }
+
+  ASSERT_TRUE(tracer.start(path));
+  EXPECT_TRUE(Tracer::enabled());
+  EXPECT_FALSE(tracer.start(path));
+
+  // One buffer per thread, including threads gone before the stop.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([label]
+      {
+        for (int j = 0; j < 100; ++j)
+          TraceScope scope("convert", label);
+      });
+  }
+  for (auto & thread : threads)
+    thread.join();
+  tracer.record(TraceEvent{"publish", label, 2000, 1500});
+  tracer.stop();
+  EXPECT_FALSE(Tracer::enabled());
+
+  const std::string trace = read_file(path);
+  std::remove(path.c_str());
+  ASSERT_FALSE(trace.empty());
+  EXPECT_EQ('[', trace.front());
+  EXPECT_EQ("]\n", trace.substr(trace.size() - 2));
+  EXPECT_EQ(0u, count(trace, "before_start"));
+  EXPECT_EQ(400u, count(trace, "\"name\":\"convert\""));
+  EXPECT_EQ(401u, count(trace, "\"cat\":\"/chatter \\\"quoted\\\"\""));
+  EXPECT_EQ(1u, count(trace,
+    "\"name\":\"publish\",\"cat\":\"/chatter \\\"quoted\\\"\",\"ph\":\"X\","
+    "\"ts\":2.000,\"dur\":1.500"));
+}
+
+//////////////////////////////////////////////////
+TEST(TraceTest, BadPath)
+{
+  EXPECT_FALSE(Tracer::instance().start("/nonexistent/dir/trace.json"));
+  EXPECT_FALSE(Tracer::enabled());
+}